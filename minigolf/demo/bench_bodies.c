@@ -0,0 +1,126 @@
+// Times how long it takes to integrate many bodies: one at a time, each
+// keeping its state inline in its own allocation (body_tick() on bodies
+// outside a scene), all at once from a store's arrays (body_store_tick()),
+// and through a whole scene_tick() with no collisions.
+// Build and run it with "make bench", which compiles with optimizations
+// and without the address sanitizer so the timings mean something.
+
+#include "body.h"
+#include "scene.h"
+#include "shape.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+const double DT = 0.001;
+const double WORLD_SIZE = 1000;
+const double BODY_SIZE = 1;
+// each size is ticked enough times to integrate about this many bodies
+const size_t BODY_TICKS = 20000000;
+const size_t SIZES[] = {1000, 10000, 100000};
+
+double random_range(double max) {
+    return (double) rand() / RAND_MAX * max;
+}
+
+body_t *make_random_body(shape_t *shape) {
+    vector_t centroid = {random_range(WORLD_SIZE), random_range(WORLD_SIZE)};
+    body_t *body = body_init_with_shape(shape_retain(shape), centroid, 1,
+        (rgb_color_t) {0, 0, 0}, NULL, NULL);
+    body_set_velocity(body,
+        (vector_t) {random_range(2) - 1, random_range(2) - 1});
+    return body;
+}
+
+/**
+ * Gets the number of microseconds each call to tick took on average.
+ */
+double microseconds_per_tick(clock_t start, size_t ticks) {
+    return (double) (clock() - start) / CLOCKS_PER_SEC * 1e6 / ticks;
+}
+
+/**
+ * Times body_tick() on each of count individually allocated bodies,
+ * which follows a pointer to every body, as a baseline for body_store_tick().
+ */
+double bench_loose_bodies(shape_t *shape, size_t count, size_t ticks) {
+    body_t **bodies = malloc(count * sizeof(body_t *));
+    for (size_t i = 0; i < count; i++) {
+        bodies[i] = make_random_body(shape);
+    }
+
+    clock_t start = clock();
+    for (size_t t = 0; t < ticks; t++) {
+        for (size_t i = 0; i < count; i++) {
+            body_tick(bodies[i], DT);
+        }
+    }
+    double result = microseconds_per_tick(start, ticks);
+
+    for (size_t i = 0; i < count; i++) {
+        body_free(bodies[i]);
+    }
+    free(bodies);
+    return result;
+}
+
+/**
+ * Times body_store_tick() on a store of count bodies.
+ */
+double bench_body_store(shape_t *shape, size_t count, size_t ticks) {
+    body_store_t *store = body_store_init(count);
+    body_t **bodies = malloc(count * sizeof(body_t *));
+    for (size_t i = 0; i < count; i++) {
+        bodies[i] = make_random_body(shape);
+        body_store_add(store, bodies[i]);
+    }
+
+    clock_t start = clock();
+    for (size_t t = 0; t < ticks; t++) {
+        body_store_tick(store, DT);
+    }
+    double result = microseconds_per_tick(start, ticks);
+
+    for (size_t i = 0; i < count; i++) {
+        body_free(bodies[i]);
+    }
+    free(bodies);
+    body_store_free(store);
+    return result;
+}
+
+/**
+ * Times scene_tick() on a scene of count bodies with no collisions.
+ */
+double bench_scene(shape_t *shape, size_t count, size_t ticks) {
+    scene_t *scene = scene_init();
+    for (size_t i = 0; i < count; i++) {
+        scene_add_body(scene, make_random_body(shape));
+    }
+
+    clock_t start = clock();
+    for (size_t t = 0; t < ticks; t++) {
+        scene_tick(scene, DT);
+    }
+    double result = microseconds_per_tick(start, ticks);
+
+    scene_free(scene);
+    return result;
+}
+
+int main() {
+    shape_t *shape = shape_rectangle(BODY_SIZE, BODY_SIZE);
+    printf("%10s %20s %20s %20s\n", "bodies", "body_tick (us)",
+        "body_store_tick (us)", "scene_tick (us)");
+    for (size_t i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); i++) {
+        size_t count = SIZES[i];
+        size_t ticks = BODY_TICKS / count;
+        double loose_time = bench_loose_bodies(shape, count, ticks);
+        double store_time = bench_body_store(shape, count, ticks);
+        double scene_time = bench_scene(shape, count, ticks);
+        printf("%10zu %20.2f %20.2f %20.2f\n", count, loose_time, store_time,
+            scene_time);
+    }
+    shape_release(shape);
+}
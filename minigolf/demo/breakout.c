@@ -4,7 +4,6 @@
 #include "body.h"
 #include "scene.h"
 #include "forces.h"
-#include "force_aux.h"
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
@@ -50,47 +49,25 @@ body_type_t get_type(body_t *body) {
 }
 
 
-list_t *make_rectangle(double width, double height) {
-    list_t *shape = list_init(4, free);
-
-    vector_t *v = malloc(sizeof(vector_t));
-    *v = (vector_t) {width, height};
-    list_add(shape, v);
-    v = malloc(sizeof(vector_t));
-    *v = (vector_t) {-width, height};
-    list_add(shape, v);
-    v = malloc(sizeof(vector_t));
-    *v = (vector_t) {-width, -height};
-    list_add(shape, v);
-    v = malloc(sizeof(vector_t));
-    *v = (vector_t) {width, -height};
-    list_add(shape, v);
-
-    return shape;
-}
-
 /**
  * Takes a scene and inits and adds a player on the screen. Returns
  * the body of the player.
  */
 body_t *make_player(scene_t *scene) {
-    list_t *shape = make_rectangle(PLAYER_WIDTH, PLAYER_HEIGHT);
-
     vector_t centroid = (vector_t) {0, -HEIGHT + PADDING + PLAYER_HEIGHT};
 
     // create players body and add it to the scene
-    body_t *player = body_init_with_info(shape, INFINITY,
+    body_t *player = body_init_with_shape(
+      shape_rectangle(2 * PLAYER_WIDTH, 2 * PLAYER_HEIGHT), centroid, INFINITY,
       (rgb_color_t) {1, 0, 0}, make_type_info(PLAYER), free);
-    body_set_centroid(player, centroid);
+    body_set_collision_type(player, PLAYER);
     scene_add_body(scene, player);
 
     return player;
 }
 
-// problematic !!!!
+// the bounce itself comes from the physics contact registered with the block
 void block_handler(body_t *ball, body_t *block, vector_t axis, void *aux) {
-    physics_collision_handler(ball, block, axis, aux);
-
     if (get_type(block) == POWERUP) {
         body_set_velocity(ball, vec_multiply(3.0, body_get_velocity(ball)));
     }
@@ -120,42 +97,37 @@ body_t *make_ball(scene_t *scene) {
     // create ball body and add it to the scene
     body_t *ball = body_init_with_info(shape, MASS,
         (rgb_color_t) {1, 0, 0}, make_type_info(BALL), free);
+    body_set_circle(ball, BALL_WIDTH);
+    body_set_collision_type(ball, BALL);
     body_set_centroid(ball, centroid);
     body_set_velocity(ball, (vector_t) {VX / 3.0, VY / 3.0});
     scene_add_body(scene, ball);
-
-    size_t body_count = scene_bodies(scene);
-    // Add force creators with other bodies
-    for (size_t i = 0; i < body_count; i++) {
-        body_t *body = scene_get_body(scene, i);
-        switch (get_type(body)) {
-            case BALL:
-            case PLAYER:
-            case WALL:
-                // Bounce off walls/player and other balls lmao.
-                create_physics_collision(scene, ELASTICITY, ball, body);
-                break;
-            case BLOCK:
-            case POWERUP:
-                // make the ball faster lmao
-                create_collision(scene, ball, body, block_handler,
-                    force_init(NULL, ELASTICITY), (free_func_t) force_free);
-                break;
-        }
-    }
     return ball;
 }
 
 
+// registers the collisions of balls with everything, once per game
+void add_collisions(scene_t *scene) {
+    // Bounce off walls/player and other balls lmao.
+    register_physics_collision(scene, ELASTICITY, BALL, BALL);
+    register_physics_collision(scene, ELASTICITY, BALL, PLAYER);
+    register_physics_collision(scene, ELASTICITY, BALL, WALL);
+    register_physics_collision(scene, ELASTICITY, BALL, BLOCK);
+    register_physics_collision(scene, ELASTICITY, BALL, POWERUP);
+    // make the ball faster lmao
+    register_collision(scene, BALL, BLOCK, block_handler, NULL, NULL);
+    register_collision(scene, BALL, POWERUP, block_handler, NULL, NULL);
+}
+
+
 // make a bouncy wall. yes. jk make it bouncy elsewhere
 void make_wall(scene_t *scene, vector_t centroid, double wall_width,
     double wall_height) {
 
-    list_t *wall_shape = make_rectangle(wall_width, wall_height);
-
-    body_t *wall = body_init_with_info(wall_shape, INFINITY,
+    body_t *wall = body_init_with_shape(
+      shape_rectangle(2 * wall_width, 2 * wall_height), centroid, INFINITY,
       (rgb_color_t) {1, 1, 1}, make_type_info(WALL), free);
-    body_set_centroid(wall, centroid);
+    body_set_collision_type(wall, WALL);
     scene_add_body(scene, wall);
 }
 
@@ -171,15 +143,16 @@ rgb_color_t get_rainbow(int num) {
 void make_block(scene_t *scene, vector_t centroid, double block_width,
     double block_height, rgb_color_t color, bool powerup) {
 
-    list_t *shape = make_rectangle(block_width, block_height);
-
     body_type_t *type_block = make_type_info(BLOCK);
     if (powerup) {
         type_block = make_type_info(POWERUP);
     }
 
-    body_t *block = body_init_with_info(shape, INFINITY, color, type_block, free);
-    body_set_centroid(block, centroid);
+    // blocks of the same size share one rectangle
+    body_t *block = body_init_with_shape(
+        shape_rectangle(2 * block_width, 2 * block_height), centroid, INFINITY,
+        color, type_block, free);
+    body_set_collision_type(block, *type_block);
     scene_add_body(scene, block);
 }
 
@@ -211,19 +184,18 @@ void make_all_blocks(scene_t *scene) {
 
 
 bool check_game_reset(body_t *ball, vector_t bottom_left, vector_t top_right) {
-    list_t *points = body_get_shape(ball);
-    size_t length = list_size(points);
+    const vec_array_t *points = body_peek_shape(ball);
+    size_t length = vec_array_size(points);
+    const vector_t *vertices = vec_array_data(points);
 
     for (size_t i = 0; i < length; i++) {
-        vector_t *point = (vector_t *) list_get(points, i);
+        const vector_t *point = &vertices[i];
         // check if ball is touching the bottom of the screen
         if (bottom_left.y - point->y >= 0) {
-            list_free(points);
             return true;
         }
     }
     // if ball isn't touching the bottom, then return false
-    list_free(points);
     return false;
 }
 
@@ -284,6 +256,7 @@ int main() {
     make_wall(scene, (vector_t) {2 * WIDTH, 0}, WIDTH, HEIGHT); // right
     make_wall(scene, (vector_t) {0, 2 * HEIGHT}, WIDTH, HEIGHT); // top
     make_all_blocks(scene);
+    add_collisions(scene);
 
     body_t *player = make_player(scene);
     body_t *ball = make_ball(scene);
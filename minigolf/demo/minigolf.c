@@ -31,7 +31,7 @@ void shoot_ball(void *aux) {
   vector_t ball_velocity = body_get_velocity(ball);
   if (ball_velocity.x == 0 && ball_velocity.y == 0) {
     body_set_velocity(ball, velocity);
-    body_set_shape(minigolf_course->velocity_line,
+    body_set_shape_array(minigolf_course->velocity_line,
       make_rectangle_with_width(VEC_ZERO, (vector_t) {0, 0.1}, 1, 0));
     body_set_color(minigolf_course->velocity_line, HIDDEN_LINE_COLOR);
     increment_stroke_count(minigolf_course);
@@ -44,14 +44,11 @@ void aim_ball(vector_t mouse_loc, void *aux) {
 
   vector_t ball_velocity = body_get_velocity(ball);
   if (ball_velocity.x == 0 && ball_velocity.y == 0) {
-    list_t *ball_shape = body_get_shape(ball);
-    vector_t centroid = polygon_centroid(ball_shape);
-    list_free(ball_shape);
+    vector_t centroid = body_get_centroid(ball);
 
-
-    list_t *shape = make_rectangle_with_width(mouse_loc, centroid, LINE_WIDTH, LINE_OFFSET);
+    vec_array_t *shape = make_rectangle_with_width(mouse_loc, centroid, LINE_WIDTH, LINE_OFFSET);
     body_t *velocity_line = minigolf_course->velocity_line;
-    body_set_shape(velocity_line, shape);
+    body_set_shape_array(velocity_line, shape);
     body_set_color(minigolf_course->velocity_line, LINE_COLOR);
     vector_t dist = vec_subtract(centroid, mouse_loc);
     minigolf_course->velocity_vec = vec_multiply(VELOCITY_FACTOR, dist);
@@ -70,17 +67,22 @@ void run_sim() {
     for (int i = 1; i <= NUM_LEVELS; i++) {
         // make minigolf course
         scene_t *scene = scene_init();
+        // courses are static walls and obstacles around a single moving ball
+        scene_set_broad_phase(scene, BROAD_PHASE_AABB_TREE);
+        scene_set_continuous_collisions(scene, true);
         minigolf_course_t *course = malloc(sizeof(minigolf_course_t));
         *course = get_level(scene, i);
 
         body_t *hole = course->hole;
-        list_t *hole_shape = body_get_shape(hole);
         body_t *ball = course->ball;
-        list_t *ball_shape = body_get_shape(ball);
 
+        // the text only changes with the stroke count, so it is remade then
         char par[12];
+        int shown_strokes = -1;
+        sdl_text_t *text = NULL;
         bool done = sdl_is_done(NULL, scene, course);
-        while(!done && find_collision(hole_shape, ball_shape).collided == 0) {
+        bool holed = false;
+        while(!done && !holed) {
             double time = time_since_last_tick();
             bgm_timer += time;
 
@@ -89,25 +91,36 @@ void run_sim() {
                 bgm_timer = 0;
             }
 
-            snprintf(par, 12, "par: %d", get_stroke_count(*course));
-            sdl_text_t *text = init_text((vector_t) {450, 200}, par);
+            if (get_stroke_count(*course) != shown_strokes) {
+                if (text != NULL) {
+                    free_text(text);
+                }
+                shown_strokes = get_stroke_count(*course);
+                snprintf(par, 12, "par: %d", shown_strokes);
+                text = init_text((vector_t) {450, 200}, par);
+            }
 
             scene_tick(scene, time);
             sdl_render(scene, text);
-            list_free(ball_shape);
-            ball_shape = body_get_shape(ball);
 
-            if (find_collision(hole_shape, ball_shape).collided != 0) {
+            sensor_event_t event;
+            while (scene_poll_sensor_event(scene, &event)) {
+                if (event.kind == SENSOR_ENTER && event.sensor == hole
+                    && event.body == ball) {
+                    holed = true;
+                }
+            }
+            if (holed) {
                 // body_set_centroid(ball, body_get_centroid(hole)); // lmao this doesn't work
                 queue_music(victory);
                 // SDL_Delay(500);
             }
             done = sdl_is_done(NULL, scene, course);
+        }
+        if (text != NULL) {
             free_text(text);
         }
 
-        list_free(hole_shape);
-        list_free(ball_shape);
         free(course);
         scene_free(scene);
         if (done) {
@@ -119,19 +119,19 @@ void init_and_show_pellets(scene_t *scene, int num_pellets) {
  *         2 if pacman is outside along the y axis
  */
 int should_wrap(body_t *pacman, vector_t bottom_left, vector_t top_right) {
-  list_t *points = body_get_shape(pacman);
-  size_t length = list_size(points);
+  const vec_array_t *points = body_peek_shape(pacman);
+  size_t length = vec_array_size(points);
+  const vector_t *vertices = vec_array_data(points);
 
   int num_points_off_x_axis = 0;
   int num_points_off_y_axis = 0;
 
   for (size_t i = 0; i < length; i++) {
-    vector_t *point = (vector_t *) list_get(points, i);
+    const vector_t *point = &vertices[i];
     // check if pacman is outside the x axis
     if (point->x - top_right.x >= 0 || bottom_left.x - point->x >= 0) {
       num_points_off_x_axis++;
       if (num_points_off_x_axis >= length - 1) {
-        list_free(points);
         return OFF_X_AXIS;
       }
     }
@@ -139,13 +139,11 @@ int should_wrap(body_t *pacman, vector_t bottom_left, vector_t top_right) {
     if (point->y - top_right.y >= 0 || bottom_left.y - point->y >= 0) {
       num_points_off_y_axis++;
       if (num_points_off_y_axis >= length - 1) {
-        list_free(points);
         return OFF_Y_AXIS;
       }
     }
   }
   // if pacman is inside both bounds, return 0
-  list_free(points);
   return 0;
 }
 
@@ -80,20 +80,6 @@ list_t *rect_init(double width, double height) {
     return rect;
 }
 
-/** Constructs a circles with the given radius centered at (0, 0) */
-list_t *circle_init(double radius) {
-    list_t *circle = list_init(CIRCLE_POINTS, free);
-    double arc_angle = 2 * M_PI / CIRCLE_POINTS;
-    vector_t point = {.x = radius, .y = 0.0};
-    for (size_t i = 0; i < CIRCLE_POINTS; i++) {
-        vector_t *v = malloc(sizeof(*v));
-        *v = point;
-        list_add(circle, v);
-        point = vec_rotate(point, arc_angle);
-    }
-    return circle;
-}
-
 /** Computes the center of the peg in the given row and column */
 vector_t get_peg_center(size_t row, size_t col) {
     vector_t center = {
@@ -115,6 +101,8 @@ void add_gravity_body(scene_t *scene) {
         free
     );
 
+    body_set_collision_type(body, GRAVITY);
+
     // Move a distnace R below the scene
     vector_t gravity_center = {.x = MAX.x / 2, .y = -R};
     body_set_centroid(body, gravity_center);
@@ -123,16 +111,17 @@ void add_gravity_body(scene_t *scene) {
 
 /** Creates a ball with the given starting position and velocity */
 body_t *get_ball(vector_t center, vector_t velocity) {
-    list_t *shape = circle_init(BALL_RADIUS);
-    body_t *ball = body_init_with_info(
-        shape,
+    body_t *ball = body_init_with_shape(
+        shape_circle(BALL_RADIUS, CIRCLE_POINTS),
+        center,
         BALL_MASS,
         BALL_COLOR,
         make_type_info(BALL),
         free
     );
+    body_set_circle(ball, BALL_RADIUS);
+    body_set_collision_type(ball, BALL);
 
-    body_set_centroid(ball, center);
     body_set_velocity(ball, velocity);
 
     return ball;
@@ -147,17 +136,10 @@ void freeze(body_t *ball, body_t *target, vector_t axis, void *aux) {
     body_remove(ball);
     body_t *frozen = get_ball(body_get_centroid(ball), VEC_ZERO);
     *((body_type_t *) body_get_info(frozen)) = FROZEN;
+    // Other falling bodies freeze when they collide with this body
+    body_set_collision_type(frozen, FROZEN);
     scene_t *scene = aux;
     scene_add_body(scene, frozen);
-
-    // Make other falling bodies freeze when they collide with this body
-    size_t body_count = scene_bodies(scene);
-    for (size_t i = 0; i < body_count; i++) {
-        body_t *body = scene_get_body(scene, i);
-        if (get_type(body) == BALL) {
-            create_collision(scene, body, frozen, freeze, scene, NULL);
-        }
-    }
 }
 
 /** Adds a ball to the scene */
@@ -171,43 +153,43 @@ void add_ball(scene_t *scene) {
     size_t body_count = scene_bodies(scene);
     scene_add_body(scene, ball);
 
-    // Add force creators with other bodies
+    // Collisions are registered by type in add_collisions(),
+    // so only gravity needs a force creator
     for (size_t i = 0; i < body_count; i++) {
         body_t *body = scene_get_body(scene, i);
-        switch (get_type(body)) {
-            case BALL:
-                // Bounce off other balls
-                create_physics_collision(scene, BALL_ELASTICITY, ball, body);
-                break;
-            case WALL:
-                // Bounce off walls and pegs
-                create_physics_collision(scene, PEG_ELASTICITY, ball, body);
-                break;
-            case FROZEN:
-                // Freeze when hitting the ground or frozen balls
-                create_collision(scene, ball, body, freeze, scene, NULL);
-                break;
-            case GRAVITY:
-                // Simulate earth's gravity acting on the ball
-                create_newtonian_gravity(scene, G, body, ball);
+        if (get_type(body) == GRAVITY) {
+            // Simulate earth's gravity acting on the ball
+            create_newtonian_gravity(scene, G, body, ball);
         }
     }
 }
 
+/** Registers how balls collide with each type of body */
+void add_collisions(scene_t *scene) {
+    // Bounce off other balls
+    register_physics_collision(scene, BALL_ELASTICITY, BALL, BALL);
+    // Bounce off walls and pegs
+    register_physics_collision(scene, PEG_ELASTICITY, BALL, WALL);
+    // Freeze when hitting the ground or frozen balls
+    register_collision(scene, BALL, FROZEN, freeze, scene, NULL);
+}
+
 /** Adds the pegs to the scene */
 void add_pegs(scene_t *scene) {
     // Add N_ROWS and N_COLS of pegs.
     for (size_t i = 1; i <= N_ROWS; i++) {
         for (size_t j = 0; j <= i; j++) {
-            list_t *polygon = circle_init(PEG_RADIUS);
-            body_t *body = body_init_with_info(
-                polygon,
+            // every peg shares one circle
+            body_t *body = body_init_with_shape(
+                shape_circle(PEG_RADIUS, CIRCLE_POINTS),
+                get_peg_center(i, j),
                 INFINITY,
                 PEG_COLOR,
                 make_type_info(WALL),
                 free
             );
-            body_set_centroid(body, get_peg_center(i, j));
+            body_set_circle(body, PEG_RADIUS);
+            body_set_collision_type(body, WALL);
             scene_add_body(scene, body);
         }
     }
@@ -226,17 +208,20 @@ void add_walls(scene_t *scene) {
         make_type_info(WALL),
         free
     );
+    body_set_collision_type(body, WALL);
     scene_add_body(scene, body);
 
     rect = rect_init(WALL_LENGTH, WALL_WIDTH);
     polygon_translate(rect, (vector_t) {.x = MAX.x - WALL_LENGTH / 2, .y = 0.0});
     polygon_rotate(rect, -WALL_ANGLE, (vector_t) {.x = MAX.x, .y = 0.0});
     body = body_init_with_info(rect, INFINITY, WALL_COLOR, make_type_info(WALL), free);
+    body_set_collision_type(body, WALL);
     scene_add_body(scene, body);
 
     // Ground is special; it freezes balls when they touch it
     rect = rect_init(MAX.x, WALL_WIDTH);
     body = body_init_with_info(rect, INFINITY, WALL_COLOR, make_type_info(FROZEN), free);
+    body_set_collision_type(body, FROZEN);
     body_set_centroid(body, (vector_t) {.x = MAX.x / 2, .y = WALL_WIDTH / 2});
     scene_add_body(scene, body);
 }
@@ -253,6 +238,7 @@ int main(void) {
     add_gravity_body(scene);
     add_pegs(scene);
     add_walls(scene);
+    add_collisions(scene);
 
     // Repeatedly render scene
     double time_since_drop = INFINITY;
@@ -3,7 +3,7 @@
 #include "sdl_wrapper.h"
 #include "body.h"
 #include "scene.h"
-#include "collision.h"
+#include "forces.h"
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
@@ -29,7 +29,6 @@ const int INVADERS_PER_COL = 3;
 const rgb_color_t GREY = (rgb_color_t) {0.5, 0.5, 0.5};
 const double INVADER_SHOOTS_DT = 3.0;
 
-const int N_POINTS_PELLET = 5;
 const double PELLET_WIDTH = 7.0;
 const double PELLET_MASS = 1;
 const vector_t PLAYER_PELLET_VELOCITY = (vector_t) {0, 400};
@@ -48,6 +47,19 @@ char *TYPE_PLAYER_PELLET = "player pellet";
 char *TYPE_INVADER = "invader";
 char *TYPE_INVADER_PELLET = "invader pellet";
 
+// collision types, see body_set_collision_type()
+typedef enum {
+  PLAYER_BODY,
+  PLAYER_PELLET_BODY,
+  INVADER_BODY,
+  INVADER_PELLET_BODY
+} collision_type_t;
+
+typedef struct {
+  bool is_game_over;
+  size_t invaders_remaining;
+} game_state_t;
+
 void do_nothing(void * variable) {
   ;
 }
@@ -78,6 +90,8 @@ body_t *init_and_show_player(scene_t *scene) {
   // create players body and add it to the scene
   char *type_player = TYPE_PLAYER;
   body_t *player = body_init_with_info(points, PLAYER_MASS, GREEN, type_player, do_nothing);
+  body_set_collision_type(player, PLAYER_BODY);
+  body_set_circle(player, PLAYER_WIDTH);
   body_set_centroid(player, (vector_t){0, vertical_shift});
   scene_add_body(scene, player);
   return player;
@@ -119,94 +133,59 @@ vector_t get_invader_translation(int space_invader_num) {
  * of invaders to the scene starting from the top left
  */
 void init_and_show_invaders(scene_t *scene, int num_invaders) {
-  for (size_t i = 0; i < num_invaders; i++) {
-    list_t *points = list_init(N_POINTS_INVADER, free);
-    vector_t *v = malloc(sizeof(vector_t));
+  vec_array_t *points = vec_array_init(N_POINTS_INVADER);
 
-    // add the first point, an outer corner
-    *v = (vector_t) {0, INVADER_RADIUS};
-    list_add(points, v);
-    vector_t old_v = *v;
+  // add the first point, an outer corner
+  vector_t v = (vector_t) {0, INVADER_RADIUS};
+  vec_array_add(points, v);
 
-    // add the inner corner of the invader, which is at the center of the circle
-    vector_t *origin = malloc(sizeof(vector_t));
-    *origin = (vector_t) {0, 0};
-    list_add(points, origin);
+  // add the inner corner of the invader, which is at the center of the circle
+  vec_array_add(points, VEC_ZERO);
 
-    // rotate 240º, add the other outer corner of the invader
-    double rotation_angle = 4 * M_PI / 3;
-    v = malloc(sizeof(vector_t));
-    *v = vec_rotate(old_v, rotation_angle);
-    list_add(points, v);
-    old_v = *v;
+  // rotate 240º, add the other outer corner of the invader
+  v = vec_rotate(v, 4 * M_PI / 3);
+  vec_array_add(points, v);
 
-    // draw the rest of the invader's body as a circle
-    for (size_t j = 2; j < N_POINTS_INVADER; j++) {
-      rotation_angle = ROTATION_RATIO * M_PI / ((int) N_POINTS_INVADER - 3);
-      v = malloc(sizeof(vector_t));
-      *v = vec_rotate(old_v, rotation_angle);
-      list_add(points, v);
-      old_v = *v;
-    }
+  // draw the rest of the invader's body as a circle
+  for (size_t j = 2; j < N_POINTS_INVADER; j++) {
+    v = vec_rotate(v, ROTATION_RATIO * M_PI / ((int) N_POINTS_INVADER - 3));
+    vec_array_add(points, v);
+  }
 
-    // translate the invader to a spot on the starting grid
-    polygon_translate(points, get_invader_translation((int) i));
+  // every invader shares one shape, centered on its centroid
+  vector_t centroid = polygon_array_centroid(points);
+  polygon_array_translate(points, vec_negate(centroid));
+  shape_t *shape = shape_init(points);
 
-    body_t *invader = body_init_with_info(points, INVADER_MASS, GREY, TYPE_INVADER, do_nothing);
+  for (size_t i = 0; i < num_invaders; i++) {
+    // place the invader at a spot on the starting grid
+    vector_t position = vec_add(get_invader_translation((int) i), centroid);
+    body_t *invader = body_init_with_shape(shape_retain(shape), position,
+      INVADER_MASS, GREY, TYPE_INVADER, do_nothing);
+    body_set_collision_type(invader, INVADER_BODY);
     body_set_rotation(invader, 2.0 * M_PI / 6.0);
     body_set_velocity(invader, INVADER_VELOCITY);
     scene_add_body(scene, invader);
   }
+  shape_release(shape);
 }
 
 void player_shoots(body_t *player, scene_t *scene) {
-  list_t *points = list_init(N_POINTS_PELLET, free);
-
-  vector_t *vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {0, 0};
-  list_add(points, vec);
-
-  vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {0, PELLET_WIDTH};
-  list_add(points, vec);
-
-  vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {PELLET_WIDTH, PELLET_WIDTH};
-  list_add(points, vec);
-
-  vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {PELLET_WIDTH, 0};
-  list_add(points, vec);
-
-  // create pellet's body and add it to the scene
-  body_t *pellet = body_init_with_info(points, PELLET_MASS, GREEN, TYPE_PLAYER_PELLET, do_nothing);
-  body_set_centroid(pellet, body_get_centroid(player));
+  // create pellet's body, sharing one square with every pellet,
+  // and add it to the scene
+  body_t *pellet = body_init_with_shape(shape_rectangle(PELLET_WIDTH, PELLET_WIDTH),
+    body_get_centroid(player), PELLET_MASS, GREEN, TYPE_PLAYER_PELLET, do_nothing);
+  body_set_collision_type(pellet, PLAYER_PELLET_BODY);
   body_set_velocity(pellet, PLAYER_PELLET_VELOCITY);
   scene_add_body(scene, pellet);
 }
 
 void invader_shoots(body_t *invader, scene_t *scene) {
-  list_t *points = list_init(N_POINTS_PELLET, free);
-
-  vector_t *vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {0, 0};
-  list_add(points, vec);
-
-  vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {0, PELLET_WIDTH};
-  list_add(points, vec);
-
-  vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {PELLET_WIDTH, PELLET_WIDTH};
-  list_add(points, vec);
-
-  vec = malloc(sizeof(vector_t));
-  *vec = (vector_t) {PELLET_WIDTH, 0};
-  list_add(points, vec);
-
-  // create pellet's body and add it to the scene
-  body_t *pellet = body_init_with_info(points, PELLET_MASS, GREY, TYPE_INVADER_PELLET,do_nothing);
-  body_set_centroid(pellet, body_get_centroid(invader));
+  // create pellet's body, sharing one square with every pellet,
+  // and add it to the scene
+  body_t *pellet = body_init_with_shape(shape_rectangle(PELLET_WIDTH, PELLET_WIDTH),
+    body_get_centroid(invader), PELLET_MASS, GREY, TYPE_INVADER_PELLET, do_nothing);
+  body_set_collision_type(pellet, INVADER_PELLET_BODY);
   body_set_velocity(pellet, INVADER_PELLET_VELOCITY);
   scene_add_body(scene, pellet);
 }
@@ -217,19 +196,19 @@ void invader_shoots(body_t *invader, scene_t *scene) {
   *        2 if body is outside along the y axis
  */
 int is_body_in_bounds(body_t *body, vector_t bottom_left, vector_t top_right) {
-    list_t *points = body_get_shape(body);
-    size_t length = list_size(points);
+    const vec_array_t *points = body_peek_shape(body);
+    size_t length = vec_array_size(points);
+    const vector_t *vertices = vec_array_data(points);
 
     int num_points_off_x_axis = 0;
     int num_points_off_y_axis = 0;
 
     for (size_t i = 0; i < length; i++) {
-      vector_t *point = (vector_t *) list_get(points, i);
+      const vector_t *point = &vertices[i];
       // check if body is outside the x axis
       if (point->x - top_right.x >= 0 || bottom_left.x - point->x >= 0) {
         num_points_off_x_axis++;
         if (num_points_off_x_axis >= length - 1) {
-          list_free(points);
           return OFF_X_AXIS;
         }
       }
@@ -237,13 +216,11 @@ int is_body_in_bounds(body_t *body, vector_t bottom_left, vector_t top_right) {
       if (point->y - top_right.y >= 0 || bottom_left.y - point->y >= 0) {
         num_points_off_y_axis++;
         if (num_points_off_y_axis >= length - 1) {
-          list_free(points);
           return OFF_Y_AXIS;
         }
       }
     }
     // if body is inside both bounds, return 0
-    list_free(points);
     return 0;
   }
 
@@ -274,131 +251,78 @@ void on_key(scene_t *scene, char key, key_event_type_t type, double held_time,
   }
 }
 
+/**
+ * Ends the game when an invader's pellet hits the player.
+ */
+void player_hit(body_t *pellet, body_t *player, vector_t axis, void *aux) {
+  game_state_t *state = aux;
+  state->is_game_over = true;
+}
+
+/**
+ * Removes an invader and the player's pellet that hit it,
+ * ending the game once every invader is gone.
+ */
+void invader_hit(body_t *pellet, body_t *invader, vector_t axis, void *aux) {
+  // a pellet only destroys the first invader it hits
+  if (body_is_removed(pellet) || body_is_removed(invader)) {
+    return;
+  }
+  game_state_t *state = aux;
+  body_remove(pellet);
+  body_remove(invader);
+  state->invaders_remaining--;
+  if (state->invaders_remaining == 0) {
+    state->is_game_over = true;
+  }
+}
+
 void run_sim(scene_t *scene, vector_t bottom_left, vector_t top_right) {
-  bool is_game_over = false;
+  game_state_t state = {false, INITIAL_N_INVADERS};
   double time_passed_invader_shoots = 0;
 
   body_t *player = init_and_show_player(scene);
   init_and_show_invaders(scene, INITIAL_N_INVADERS);
 
-  sdl_on_key(on_key);
-
-  while(!sdl_is_done(player, scene, NULL) && !is_game_over) {
-    int n_bodies = (int) scene_bodies(scene);
+  // the scene finds pellets hitting their targets itself
+  register_collision(scene, INVADER_PELLET_BODY, PLAYER_BODY, player_hit,
+    &state, NULL);
+  register_collision(scene, PLAYER_PELLET_BODY, INVADER_BODY, invader_hit,
+    &state, NULL);
 
-    int invaders_idx_list[n_bodies];
-    int n_invaders = 0;
-
-    int invader_pellets_idx_list[n_bodies];
-    int n_invader_pellets = 0;
-
-    int player_pellets_idx_list[n_bodies];
-    int n_player_pellets = 0;
-
-    int idx = 0;
+  sdl_on_key(on_key);
 
-    // add all bodies to their respective lists and deal with out of bounds bodies
-    while (idx < n_bodies) {
+  while(!sdl_is_done(player, scene, NULL) && !state.is_game_over) {
+    // deal with out of bounds bodies
+    for (size_t idx = 0; idx < scene_bodies(scene); idx++) {
       body_t *body = scene_get_body(scene, idx);
       char *type = body_get_info(body);
 
       int wrap = is_body_in_bounds(body, bottom_left, top_right);
 
-        if (type == TYPE_PLAYER_PELLET) {
-          if (wrap == 0) {
-            player_pellets_idx_list[n_player_pellets] = idx;
-            idx++;
-            n_player_pellets++;
-          }
-          else {
-            scene_remove_body(scene, idx);
-            n_bodies--;
-          }
-        }
-        else if (type == TYPE_INVADER_PELLET) {
-          if (wrap == 0) {
-            invader_pellets_idx_list[n_invader_pellets] = idx;
-            idx++;
-            n_invader_pellets++;
-          }
-          else {
-            scene_remove_body(scene, idx);
-            n_bodies--;
-          }
-        }
-        else if (type == TYPE_INVADER) {
-          if (wrap == OFF_X_AXIS) {
-            vector_t centroid = body_get_centroid(body);
-            body_set_centroid(body, (vector_t) {centroid.x, centroid.y
-              - 4.0 * (INVADER_RADIUS + PADDING)});
-            vector_t velocity = body_get_velocity(body);
-            body_set_velocity(body, (vector_t) {-velocity.x, velocity.y});
-
-            invaders_idx_list[n_invaders] = idx;
-            idx++;
-            n_invaders++;
-          }
-          if (wrap == OFF_Y_AXIS) {
-            is_game_over = true;
-          }
-          if (wrap == 0) {
-            invaders_idx_list[n_invaders] = idx;
-            idx++;
-            n_invaders++;
-          }
+      if (type == TYPE_PLAYER_PELLET || type == TYPE_INVADER_PELLET) {
+        if (wrap != 0) {
+          body_remove(body);
         }
-        else if (type == TYPE_PLAYER) {
-          if (wrap == OFF_X_AXIS) {
-            vector_t centroid = body_get_centroid(body);
-            body_set_centroid(body, (vector_t) {-centroid.x, centroid.y});
-          }
-          idx++;
+      }
+      else if (type == TYPE_INVADER) {
+        if (wrap == OFF_X_AXIS) {
+          vector_t centroid = body_get_centroid(body);
+          body_set_centroid(body, (vector_t) {centroid.x, centroid.y
+            - 4.0 * (INVADER_RADIUS + PADDING)});
+          vector_t velocity = body_get_velocity(body);
+          body_set_velocity(body, (vector_t) {-velocity.x, velocity.y});
         }
-
-      for (int i = 0; i < n_invader_pellets; i++) {
-        list_t *player_shape = body_get_shape(player);
-        list_t *pellet_shape = body_get_shape(scene_get_body(scene, invader_pellets_idx_list[i]));
-        bool is_collided = find_collision(player_shape, pellet_shape).collided;
-        list_free(player_shape);
-        list_free(pellet_shape);
-
-        if (is_collided) {
-          is_game_over = true;
-          break;
+        if (wrap == OFF_Y_AXIS) {
+          state.is_game_over = true;
         }
       }
-
-      int num_invaders_remaining = n_invaders;
-
-      for (int j = 0; j < n_player_pellets; j++) {
-        for (int k = 0; k < n_invaders; k++) {
-          if (invaders_idx_list[k] != -1) {
-            list_t *invader_shape = body_get_shape(scene_get_body(scene, invaders_idx_list[k]));
-            list_t *pellet_shape = body_get_shape(scene_get_body(scene, player_pellets_idx_list[j]));
-            bool is_collided = find_collision(
-              invader_shape,
-              pellet_shape
-            ).collided;
-            list_free(invader_shape);
-            list_free(pellet_shape);
-
-            if (is_collided && num_invaders_remaining == 1) {
-              is_game_over = true;
-              break;
-            }
-
-            if (is_collided) {
-              scene_remove_body(scene, invaders_idx_list[k]);
-              scene_remove_body(scene, player_pellets_idx_list[j]);
-
-              invaders_idx_list[k] = -1;
-              num_invaders_remaining--;
-              break;
-            }
-          }
+      else if (type == TYPE_PLAYER) {
+        if (wrap == OFF_X_AXIS) {
+          vector_t centroid = body_get_centroid(body);
+          body_set_centroid(body, (vector_t) {-centroid.x, centroid.y});
         }
       }
-
     }
 
     // shoot a new pellet about every INVADER_SHOOTS_DT seconds
@@ -0,0 +1,75 @@
+#ifndef __AABB_H__
+#define __AABB_H__
+
+#include <stdbool.h>
+#include "list.h"
+#include "vec_array.h"
+#include "vector.h"
+
+/**
+ * An axis-aligned bounding box.
+ * min is the bottom left corner and max is the top right corner.
+ * aabb_t is passed by value, like vector_t.
+ */
+typedef struct {
+    vector_t min;
+    vector_t max;
+} aabb_t;
+
+/**
+ * Computes the smallest axis-aligned box containing every vertex of a polygon.
+ * Asserts that the polygon has at least one vertex.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @return the bounding box of the polygon
+ */
+aabb_t aabb_of_polygon(list_t *polygon);
+
+/**
+ * Computes the smallest axis-aligned box containing every vertex of a polygon
+ * stored contiguously, like aabb_of_polygon().
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @return the bounding box of the polygon
+ */
+aabb_t aabb_of_vec_array(const vec_array_t *polygon);
+
+/**
+ * Returns whether two boxes overlap.
+ * Boxes that only touch along an edge or at a corner count as overlapping,
+ * matching the behavior of find_collision() for tangent shapes.
+ *
+ * @param box1 the first box
+ * @param box2 the second box
+ * @return whether the boxes share at least one point
+ */
+bool aabb_overlap(aabb_t box1, aabb_t box2);
+
+/**
+ * Computes the smallest box containing two boxes.
+ *
+ * @param box1 the first box
+ * @param box2 the second box
+ * @return the union of the boxes' extents
+ */
+aabb_t aabb_union(aabb_t box1, aabb_t box2);
+
+/**
+ * Returns whether one box lies entirely within another.
+ *
+ * @param outer the containing box
+ * @param inner the contained box
+ * @return whether every point of inner is in outer
+ */
+bool aabb_contains(aabb_t outer, aabb_t inner);
+
+/**
+ * Computes the perimeter of a box.
+ * Used as the cost of a box when building bounding volume hierarchies.
+ *
+ * @param box the box to measure
+ * @return twice the sum of the box's width and height
+ */
+double aabb_perimeter(aabb_t box);
+
+#endif // #ifndef __AABB_H__
@@ -0,0 +1,106 @@
+#ifndef __AABB_TREE_H__
+#define __AABB_TREE_H__
+
+#include "aabb.h"
+#include "body.h"
+#include "broad_phase.h"
+
+/**
+ * A dynamic bounding volume tree broad phase, in the style of Box2D.
+ * Each body is a leaf holding a "fat" box: its bounding box grown by a margin
+ * and stretched in the direction the body has been moving.
+ * A body is only reinserted once its bounding box leaves its fat box,
+ * so bodies that never move (mass INFINITY) are effectively inserted once,
+ * and their boxes are not even refreshed until they move or rotate.
+ * (Reshaping such a body without moving it is not noticed, so remove it
+ * and add it again afterwards.)
+ * Only the movable bodies are queried against the tree on each search,
+ * and pairs of immovable bodies are cached until one of them moves,
+ * so adding more static bodies barely changes the cost of a search.
+ */
+typedef struct aabb_tree aabb_tree_t;
+
+/**
+ * Allocates memory for an empty tree.
+ *
+ * @return a pointer to the newly allocated tree
+ */
+aabb_tree_t *aabb_tree_init(void);
+
+/**
+ * Releases the memory allocated for a tree.
+ * Does not free any bodies.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ */
+void aabb_tree_free(aabb_tree_t *tree);
+
+/**
+ * Starts tracking a body.
+ * Bodies with INFINITY mass are treated as static.
+ * If called from within a pair callback, the body is inserted
+ * at the start of the next search.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param body the body to track
+ */
+void aabb_tree_add(aabb_tree_t *tree, body_t *body);
+
+/**
+ * Stops tracking a body. Must not be called from within a pair callback.
+ * Asserts that the body is being tracked.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param body the body to stop tracking
+ */
+void aabb_tree_remove(aabb_tree_t *tree, body_t *body);
+
+/**
+ * Gets the height of a tree, which is logarithmic in the number of bodies
+ * as long as the tree stays balanced.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @return the number of edges on the longest path from the root to a leaf,
+ *   or -1 if the tree is empty
+ */
+int aabb_tree_height(aabb_tree_t *tree);
+
+/**
+ * Inserts the bodies added during the last search, and refreshes the bodies'
+ * boxes, reinserting the ones that left their fat boxes, without searching
+ * for pairs, so that aabb_tree_query() finds the bodies where they are now.
+ * Must not be called from within a pair callback.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ */
+void aabb_tree_update(aabb_tree_t *tree);
+
+/**
+ * Reinserts the bodies that left their fat boxes, then calls a function
+ * on each pair of bodies whose current bounding boxes overlap.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param callback the function to call on each overlapping pair
+ * @param aux an auxiliary value to pass to callback
+ */
+void aabb_tree_find_pairs(aabb_tree_t *tree, pair_callback_t callback, void *aux);
+
+/**
+ * Calls a function on each body whose bounding box overlaps a box.
+ * Each body is checked with its bounds as of the last search,
+ * or its current bounds if it was added since.
+ * The callback must not add or remove bodies.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param box the box to look in
+ * @param callback the function to call on each body found
+ * @param aux an auxiliary value to pass to callback
+ */
+void aabb_tree_query(
+    aabb_tree_t *tree,
+    aabb_t box,
+    body_callback_t callback,
+    void *aux
+);
+
+#endif // #ifndef __AABB_TREE_H__
@@ -2,13 +2,18 @@
 #define __BODY_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
 #include <math.h>
+#include "aabb.h"
+#include "capsule.h"
 #include "polygon.h"
 #include "color.h"
 #include "list.h"
+#include "shape.h"
+#include "vec_array.h"
 #include "vector.h"
 
 /**
@@ -16,21 +21,72 @@
  * Implemented as a polygon with uniform density.
  * Bodies can accumulate forces and impulses during each tick.
  * Angular physics (i.e. torques) are not currently implemented.
+ * A body_t* is a handle: the state integrated every tick lives in the
+ * body_store_t the body belongs to.
  */
 typedef struct body body_t;
 
+/**
+ * Dense storage for the state of many bodies that changes every tick:
+ * their centroids, velocities, forces, impulses, corrections, inverse masses,
+ * and flags, each in its own array, so that they can all be integrated
+ * in one loop without following a pointer per body (see body_store_tick()).
+ * Every body is in exactly one store. A body starts out in a store of its
+ * own, kept inline in the body, and a scene moves the bodies added to it
+ * into the scene's store. There is no store shared between scenes.
+ */
+typedef struct body_store body_store_t;
+
 /**
  * Initializes a body without any info.
- * Acts like body_init_with_info() where info and info_freer are NULL.
+ * Acts like body_init_with_info() where info and info_freer are NULL,
+ * so it also frees the shape list.
  */
 body_t *body_init(list_t *shape, double mass, rgb_color_t color);
 
+/**
+ * Initializes a body without any info from a shape stored contiguously,
+ * which the body keeps as its storage, so nothing is copied.
+ * Otherwise acts like body_init().
+ *
+ * @param shape an array of vectors describing the initial shape of the body,
+ *   which the body takes ownership of
+ * @param mass the mass of the body (if INFINITY, stops the body from moving)
+ * @param color the color of the body, used to draw it on the screen
+ * @return a pointer to the newly allocated body
+ */
+body_t *body_init_with_array(vec_array_t *shape, double mass,
+    rgb_color_t color);
+
+/**
+ * Initializes a body whose shape is shared with other bodies (see shape_t),
+ * e.g. one of many identical pegs, so that it stores no vertices of its own
+ * until they are first read (see body_peek_shape()).
+ * Otherwise acts like body_init_with_info().
+ *
+ * @param shape the body's shape, whose origin is placed at the centroid;
+ *   the body takes ownership of this reference to it
+ * @param centroid the body's initial centroid
+ * @param mass the mass of the body (if INFINITY, stops the body from moving)
+ * @param color the color of the body, used to draw it on the screen
+ * @param info additional information to associate with the body,
+ *   or NULL if there is none
+ * @param info_freer if non-NULL, a function call on the info to free it
+ * @return a pointer to the newly allocated body
+ */
+body_t *body_init_with_shape(shape_t *shape, vector_t centroid, double mass,
+    rgb_color_t color, void *info, free_func_t info_freer);
+
 /**
  * Allocates memory for a body with the given parameters.
  * The body is initially at rest.
  * Asserts that the mass is positive and that the required memory is allocated.
+ * The body stores its vertices contiguously (see vec_array_t),
+ * so it copies them out of the list and frees the list.
  *
- * @param shape a list of vectors describing the initial shape of the body
+ * @param shape a list of vectors describing the initial shape of the body.
+ *   The body takes ownership of the list and frees it before returning,
+ *   so the caller must not use or free it after the call.
  * @param mass the mass of the body (if INFINITY, stops the body from moving)
  * @param color the color of the body, used to draw it on the screen
  * @param info additional information to associate with the body,
@@ -62,6 +118,290 @@ void body_free(body_t *body);
  */
 list_t *body_get_shape(body_t *body);
 
+/**
+ * Gets the current shape of a body, like body_get_shape(),
+ * as a newly allocated array, which must be vec_array_free()d.
+ * Copying the array takes one allocation, rather than one per vertex.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the polygon describing the body's current position
+ */
+vec_array_t *body_get_shape_array(body_t *body);
+
+/**
+ * Gets a read-only view of the current shape of a body, without copying it,
+ * e.g. to test it for collisions or draw it every tick.
+ * If the body has moved since its vertices were last read, this first
+ * recomputes them from the shape it stores relative to its centroid.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the polygon describing the body's current position, owned by the
+ *   body. The view is invalidated when the body is moved, rotated,
+ *   reshaped, or freed.
+ */
+const vec_array_t *body_peek_shape(body_t *body);
+
+/**
+ * Gets the shape a body stores, relative to its centroid and unrotated,
+ * e.g. to draw it with body_get_centroid() and body_get_rotation()
+ * without computing the body's own vertices.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's local shape, which may be shared with other bodies
+ */
+const vec_array_t *body_peek_local_shape(body_t *body);
+
+/**
+ * Gets the axis-aligned bounding box of a body's current shape,
+ * or of its circle if it is a circle.
+ * The box is cached and updated whenever the body is moved or given a new
+ * shape, so this takes constant time, except after rotating a polygon,
+ * when the box is recomputed from the rotated vertices once.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the smallest axis-aligned box containing the body
+ */
+aabb_t body_get_bounds(body_t *body);
+
+/**
+ * Returns whether a body's shape is convex, as computed by polygon_is_convex()
+ * when the body was created or last given a new shape.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body's polygon is convex
+ */
+bool body_is_convex(body_t *body);
+
+/**
+ * Marks a body as a circle of a given radius centered at its centroid.
+ * Collisions with the body are then computed against the exact circle,
+ * which is much cheaper than against a polygon with many vertices.
+ * The body's polygon is kept and is still what gets drawn,
+ * so it should approximate the circle.
+ * Giving the body a new shape with body_set_shape() makes it a polygon again.
+ * Asserts that the radius is positive.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param radius the radius of the circle
+ */
+void body_set_circle(body_t *body, double radius);
+
+/**
+ * Returns whether a body has been marked as a circle with body_set_circle().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body is a circle
+ */
+bool body_is_circle(body_t *body);
+
+/**
+ * Gets the radius of a circular body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the radius passed to body_set_circle(), or 0 if the body is a polygon
+ */
+double body_get_radius(body_t *body);
+
+/**
+ * Makes a body collide as a compound of convex parts instead of as its shape,
+ * e.g. so a concave shape can collide as one body.
+ * The parts move and rotate with the body, and its bounding box covers them.
+ * The shape is kept for the body's centroid, but the parts are what gets drawn.
+ * Giving the body a new shape with body_set_shape() or marking it
+ * as a circle makes it collide as that shape again.
+ * A body can have capsule parts (see body_set_capsules()) as well.
+ * Asserts that there is at least one part and that every part is convex.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param parts a list of convex polygons in the same coordinates as the shape,
+ *   which the body copies into contiguous arrays and frees
+ */
+void body_set_parts(body_t *body, list_t *parts);
+
+/**
+ * Makes a concave body collide as the convex pieces of its shape,
+ * found with polygon_decompose(). Does nothing to a convex body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_decompose(body_t *body);
+
+/**
+ * Gets the number of convex parts a body collides as.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the number of parts given to body_set_parts(),
+ *   or 0 if the body collides as its shape
+ */
+size_t body_get_part_count(body_t *body);
+
+/**
+ * Gets a read-only view of one of the convex parts a body collides as,
+ * like body_peek_shape().
+ * Asserts that the index is less than body_get_part_count().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param index the index of the part, in the order given to body_set_parts()
+ * @return the part, owned by the body. The view is invalidated when the body
+ *   is moved, rotated, reshaped, or freed.
+ */
+const vec_array_t *body_peek_part(body_t *body, size_t index);
+
+/**
+ * Gets the unit edge normals of one of a body's convex parts,
+ * cached like body_get_edge_normals().
+ * Asserts that the index is less than body_get_part_count().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param index the index of the part, in the order given to body_set_parts()
+ * @return an array with one normal per vertex of the part, owned by the body.
+ *   The array is invalidated when the body is rotated, reshaped, or freed.
+ */
+const vector_t *body_get_part_normals(body_t *body, size_t index);
+
+/**
+ * Makes a body collide as a compound that includes capsules,
+ * e.g. so that the walls of a course are one body made of segments.
+ * The capsules are copied into the body, move and rotate with it, and are
+ * covered by its bounding box, like the parts given to body_set_parts().
+ * Asserts that there is at least one capsule.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param capsules an array of capsules in the same coordinates as the shape
+ * @param count the number of capsules
+ */
+void body_set_capsules(body_t *body, const capsule_t *capsules, size_t count);
+
+/**
+ * Gets the capsules a body collides as.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return an array of body_get_capsule_count() capsules, owned by the body,
+ *   or NULL if it has none
+ */
+const capsule_t *body_get_capsules(body_t *body);
+
+/**
+ * Gets the number of capsules a body collides as.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the number of capsules given to body_set_capsules(), or 0
+ */
+size_t body_get_capsule_count(body_t *body);
+
+/**
+ * Returns whether a body collides as parts (see body_set_parts() and
+ * body_set_capsules()) rather than as its shape.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body has any parts or capsules
+ */
+bool body_is_compound(body_t *body);
+
+/**
+ * Marks a body as a sensor, or as an ordinary body again.
+ * A sensor never collides: the scene does not invoke contact handlers
+ * between it and other bodies, so it never receives or causes impulses.
+ * Instead, the scene reports when moving bodies start and stop overlapping it
+ * (see scene_poll_sensor_event()), e.g. so a game can detect a ball in a hole.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param sensor whether the body should be a sensor
+ */
+void body_set_sensor(body_t *body, bool sensor);
+
+/**
+ * Returns whether a body has been marked as a sensor with body_set_sensor().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body is a sensor
+ */
+bool body_is_sensor(body_t *body);
+
+/**
+ * Sets the collision type of a body, e.g. the kind of game object it is.
+ * The scene calls the collision handlers registered between two types
+ * (see scene_register_collision_handler()) on bodies of those types.
+ * Every body starts with type 0.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param type a small integer, since the scene keeps a table of
+ *   handlers indexed by pairs of types
+ */
+void body_set_collision_type(body_t *body, size_t type);
+
+/**
+ * Gets the collision type of a body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the type passed to body_set_collision_type(), or 0
+ */
+size_t body_get_collision_type(body_t *body);
+
+/**
+ * Sets which bodies a body can collide with, as bitfields of up to 32
+ * categories: two bodies can only collide if each one's category shares
+ * a bit with the other's mask (see body_can_collide()).
+ * Every body starts in category 1 with a mask of every category.
+ * The scene skips pairs of bodies that cannot collide before doing any other
+ * work on them, so e.g. decorations should be given a category or mask of 0.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param category the categories the body belongs to
+ * @param mask the categories the body can collide with
+ */
+void body_set_collision_filter(body_t *body, uint32_t category, uint32_t mask);
+
+/**
+ * Gets the categories a body belongs to.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the category passed to body_set_collision_filter(), or 1
+ */
+uint32_t body_get_collision_category(body_t *body);
+
+/**
+ * Gets the categories a body can collide with.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the mask passed to body_set_collision_filter(), or UINT32_MAX
+ */
+uint32_t body_get_collision_mask(body_t *body);
+
+/**
+ * Returns whether the collision filters of two bodies allow them to collide.
+ *
+ * @param body1 a pointer to a body returned from body_init()
+ * @param body2 a pointer to another body returned from body_init()
+ * @return whether each body's category shares a bit with the other's mask
+ */
+bool body_can_collide(body_t *body1, body_t *body2);
+
+/**
+ * Gets the unit normals of the edges of a body's current shape,
+ * as computed by polygon_edge_normals().
+ * The normals are cached and only recomputed after the body is rotated
+ * or given a new shape, since translating a body does not change them.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return an array with one normal per vertex of the body's shape.
+ * The array is owned by the body and is invalidated when it is rotated,
+ * reshaped, or freed.
+ */
+vector_t *body_get_edge_normals(body_t *body);
+
+/**
+ * Gets the vertices of a body's current shape as a contiguous array,
+ * for the SIMD kernels in simd.h.
+ * Acts like body_peek_shape(), so nothing is copied.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return an array with the body's vertices, in the order of its shape.
+ * The array is owned by the body and is invalidated when it is moved,
+ * rotated, reshaped, or freed.
+ */
+const vector_t *body_get_vertices(body_t *body);
+
 /**
  * Gets the current center of mass of a body.
  * While this could be calculated with polygon_centroid(), that becomes too slow
@@ -73,6 +413,14 @@ list_t *body_get_shape(body_t *body);
  */
 vector_t body_get_centroid(body_t *body);
 
+/**
+ * Gets the current orientation of a body, as set with body_set_rotation().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's angle in radians, initially 0
+ */
+double body_get_rotation(body_t *body);
+
 /**
  * Gets the current velocity of a body.
  *
@@ -108,6 +456,8 @@ void *body_get_info(body_t *body);
 /**
  * Translates a body to a new position.
  * The position is specified by the position of the body's center of mass.
+ * Takes constant time: the body's vertices are only recomputed
+ * when they are next read.
  *
  * @param body a pointer to a body returned from body_init()
  * @param x the body's new centroid
@@ -126,6 +476,7 @@ void body_set_velocity(body_t *body, vector_t v);
  * Changes a body's orientation in the plane.
  * The body is rotated about its center of mass.
  * Note that the angle is *absolute*, not relative to the current orientation.
+ * Like body_set_centroid(), takes constant time.
  *
  * @param body a pointer to a body returned from body_init()
  * @param angle the body's new angle in radians. Positive is counterclockwise.
@@ -142,6 +493,17 @@ void body_set_rotation(body_t *body, double angle);
  */
 void body_add_force(body_t *body, vector_t force);
 
+/**
+ * Computes the velocity a body will have after body_tick(),
+ * with the forces and impulses applied to it so far this tick.
+ * A body with mass INFINITY keeps its velocity.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param dt the number of seconds the tick will last
+ * @return the body's velocity at the end of the tick
+ */
+vector_t body_get_next_velocity(body_t *body, double dt);
+
 /**
  * Applies an impulse to a body.
  * An impulse causes an instantaneous change in velocity,
@@ -154,6 +516,28 @@ void body_add_force(body_t *body, vector_t force);
  */
 void body_add_impulse(body_t *body, vector_t impulse);
 
+/**
+ * Queues a translation of a body to push it out of a body it overlaps,
+ * e.g. by the depth of a collision along the collision axis.
+ * If multiple corrections are queued in the same tick, they should be added.
+ * Should not change the body's position; see body_apply_correction().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param correction how far to translate the body
+ */
+void body_add_correction(body_t *body, vector_t correction);
+
+/**
+ * Translates a body by the corrections queued with body_add_correction()
+ * since this was last called, then clears them.
+ * The scene does this for all of its bodies at once in each tick,
+ * after the collisions have been found and before the bodies move
+ * (see body_store_apply_corrections()).
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_apply_correction(body_t *body);
+
 /**
  * Updates the body after a given time interval has elapsed.
  * Sets acceleration and velocity according to the forces and impulses
@@ -167,6 +551,56 @@ void body_add_impulse(body_t *body, vector_t impulse);
  */
 void body_tick(body_t *body, double dt);
 
+/**
+ * Allocates memory for an empty body store.
+ * Asserts that the required memory was allocated.
+ *
+ * @param initial_size the number of bodies to allocate space for
+ * @return a pointer to the newly allocated store
+ */
+body_store_t *body_store_init(size_t initial_size);
+
+/**
+ * Releases the memory allocated for a body store.
+ * Asserts that every body in it has been freed or moved to another store.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ */
+void body_store_free(body_store_t *store);
+
+/**
+ * Moves a body into a store, out of the store it was in.
+ * The body keeps its state, and the body_t* stays valid.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_store_add(body_store_t *store, body_t *body);
+
+/**
+ * Gets the number of bodies in a store.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @return the number of bodies in the store
+ */
+size_t body_store_size(body_store_t *store);
+
+/**
+ * Calls body_apply_correction() on every body in a store.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ */
+void body_store_apply_corrections(body_store_t *store);
+
+/**
+ * Calls body_tick() on every body in a store, in one loop over its arrays
+ * that the compiler can vectorize.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @param dt the number of seconds elapsed since the last tick
+ */
+void body_store_tick(body_store_t *store, double dt);
+
 /**
  * Marks a body for removal--future calls to body_is_removed() will return true.
  * Does not free the body.
@@ -186,8 +620,24 @@ void body_remove(body_t *body);
  */
 bool body_is_removed(body_t *body);
 
+/**
+ * Gives a body a new shape, copying it out of the list and freeing the list
+ * like body_init_with_info().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param shape a list of vectors describing the body's new shape
+ */
 void body_set_shape(body_t *body, list_t *shape);
 
+/**
+ * Gives a body a new shape stored contiguously, like body_set_shape(),
+ * which the body takes ownership of.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param shape an array of vectors describing the body's new shape
+ */
+void body_set_shape_array(body_t *body, vec_array_t *shape);
+
 void body_set_color(body_t *body, rgb_color_t color);
 
 #endif // #ifndef __BODY_H__
@@ -0,0 +1,145 @@
+#ifndef __BROAD_PHASE_H__
+#define __BROAD_PHASE_H__
+
+#include "body.h"
+#include "list.h"
+
+/**
+ * A function called by a broad phase for each pair of bodies
+ * whose bounding boxes overlap.
+ * Each such pair is reported exactly once per search.
+ *
+ * @param body1 one body of the pair
+ * @param body2 the other body of the pair
+ * @param aux the auxiliary value passed to the search
+ */
+typedef void (*pair_callback_t)(body_t *body1, body_t *body2, void *aux);
+
+/**
+ * A function called by a broad phase query for each body it finds.
+ *
+ * @param body the body found
+ * @param aux the auxiliary value passed to the query
+ */
+typedef void (*body_callback_t)(body_t *body, void *aux);
+
+/**
+ * The algorithms a broad phase can use to find overlapping bodies.
+ */
+typedef enum {
+    /** A uniform grid rebuilt on every search; see spatial_hash.h */
+    BROAD_PHASE_SPATIAL_HASH,
+    /** Sorted interval endpoints kept between searches; see sweep_and_prune.h */
+    BROAD_PHASE_SWEEP_AND_PRUNE,
+    /** A bounding volume tree of fattened boxes; see aabb_tree.h */
+    BROAD_PHASE_AABB_TREE
+} broad_phase_kind_t;
+
+/**
+ * Finds the pairs of bodies whose bounding boxes overlap,
+ * using one of several interchangeable algorithms.
+ * Bodies are registered with broad_phase_add() and broad_phase_remove(),
+ * so algorithms that keep state between searches can update it incrementally.
+ */
+typedef struct broad_phase broad_phase_t;
+
+/**
+ * Allocates memory for a broad phase with no bodies.
+ *
+ * @param kind the algorithm to use
+ * @return a pointer to the newly allocated broad phase
+ */
+broad_phase_t *broad_phase_init(broad_phase_kind_t kind);
+
+/**
+ * Releases the memory allocated for a broad phase.
+ * Does not free any bodies.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ */
+void broad_phase_free(broad_phase_t *broad_phase);
+
+/**
+ * Gets the algorithm a broad phase uses.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ * @return the kind passed to broad_phase_init()
+ */
+broad_phase_kind_t broad_phase_get_kind(broad_phase_t *broad_phase);
+
+/**
+ * Starts tracking a body.
+ * May be called from within a pair callback;
+ * the body is then only considered from the next search on.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ * @param body the body to track
+ */
+void broad_phase_add(broad_phase_t *broad_phase, body_t *body);
+
+/**
+ * Stops tracking a body. Must not be called from within a pair callback.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ * @param body a body previously passed to broad_phase_add()
+ */
+void broad_phase_remove(broad_phase_t *broad_phase, body_t *body);
+
+/**
+ * Sets the cell width used by the spatial hash algorithm.
+ * Has no effect on the other algorithms.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ * @param cell_size the width of each cell, or 0 to pick one automatically
+ */
+void broad_phase_set_cell_size(broad_phase_t *broad_phase, double cell_size);
+
+/**
+ * Calls a function on each pair of tracked bodies whose current bounding boxes
+ * overlap. Pairs whose collision filters keep them from colliding
+ * (see body_can_collide()) are skipped before their boxes are compared.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ * @param bodies the list of tracked bodies
+ * @param callback the function to call on each overlapping pair
+ * @param aux an auxiliary value to pass to callback
+ */
+void broad_phase_find_pairs(
+    broad_phase_t *broad_phase,
+    list_t *bodies,
+    pair_callback_t callback,
+    void *aux
+);
+
+/**
+ * Brings the bounds the broad phase stores for its bodies up to date
+ * without searching for pairs, so that broad_phase_query() finds the bodies
+ * where they are now rather than where they were at the last search.
+ * Must not be called from within a pair callback.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ * @param bodies the list of tracked bodies
+ */
+void broad_phase_update(broad_phase_t *broad_phase, list_t *bodies);
+
+/**
+ * Calls a function on each tracked body whose bounding box overlaps a box,
+ * e.g. to find what a body could hit along a path without checking every body.
+ * Each body is reported once. Bodies are checked with their bounds as of
+ * the last search or broad_phase_update(), or when they were added if later,
+ * so a body that has moved since is looked for where it was.
+ * The callback must not add or remove bodies.
+ *
+ * @param broad_phase a pointer to a broad phase returned from broad_phase_init()
+ * @param box the box to look in
+ * @param callback the function to call on each body found
+ * @param aux an auxiliary value to pass to callback
+ */
+void broad_phase_query(
+    broad_phase_t *broad_phase,
+    aabb_t box,
+    body_callback_t callback,
+    void *aux
+);
+
+#endif // #ifndef __BROAD_PHASE_H__
@@ -0,0 +1,70 @@
+#ifndef __CAPSULE_H__
+#define __CAPSULE_H__
+
+#include "aabb.h"
+#include "list.h"
+#include "vector.h"
+
+/**
+ * A capsule: every point within a radius of a line segment,
+ * i.e. a rectangle along the segment with a half circle on each end.
+ * A capsule whose segment has no length is a circle.
+ * capsule_t is passed by value, like vector_t, so its two endpoints
+ * are stored inline rather than in a list.
+ */
+typedef struct {
+    vector_t start;
+    vector_t end;
+    double radius;
+} capsule_t;
+
+/**
+ * Finds the point on a capsule's segment closest to a point.
+ *
+ * @param capsule the capsule
+ * @param point the point
+ * @return the closest point on the segment from start to end
+ */
+vector_t capsule_closest_point(capsule_t capsule, vector_t point);
+
+/**
+ * Finds the closest pair of points on two capsules' segments.
+ * If the segments cross, both points are where they cross.
+ *
+ * @param capsule1 the first capsule
+ * @param capsule2 the second capsule
+ * @param point1 set to the closest point on the first capsule's segment
+ * @param point2 set to the closest point on the second capsule's segment
+ */
+void capsule_closest_points(capsule_t capsule1, capsule_t capsule2,
+    vector_t *point1, vector_t *point2);
+
+/**
+ * Projects a capsule onto a unit axis.
+ *
+ * @param capsule the capsule
+ * @param axis the unit vector to project onto
+ * @return the smallest and largest projections, as a vector_t {min, max}
+ */
+vector_t capsule_project(capsule_t capsule, vector_t axis);
+
+/**
+ * Computes the smallest axis-aligned box containing a capsule.
+ *
+ * @param capsule the capsule
+ * @return the bounding box of the capsule
+ */
+aabb_t capsule_bounds(capsule_t capsule);
+
+/**
+ * Makes a polygon approximating a capsule, e.g. to draw it.
+ * Each end is a half circle of the given number of vertices.
+ * Asserts that there are at least 2 vertices per end.
+ *
+ * @param capsule the capsule
+ * @param cap_points the number of vertices around each end
+ * @return a new list of 2 * cap_points vertices in counterclockwise order
+ */
+list_t *capsule_polygon(capsule_t capsule, size_t cap_points);
+
+#endif // #ifndef __CAPSULE_H__
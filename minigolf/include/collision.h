@@ -2,7 +2,10 @@
 #define __COLLISION_H__
 
 #include <stdbool.h>
+#include "body.h"
+#include "capsule.h"
 #include "list.h"
+#include "vec_array.h"
 #include "vector.h"
 
 /**
@@ -21,6 +24,67 @@ typedef struct {
     vector_t axis;
 } collision_info_t;
 
+/**
+ * Describes how two colliding shapes overlap, for pushing them apart.
+ */
+typedef struct {
+    /**
+     * How far the second shape would have to move along the collision axis
+     * to stop overlapping the first
+     */
+    double depth;
+    /** The number of points in contacts: 1, or 2 if edges overlap edge-on */
+    size_t contact_count;
+    /** The points where the shapes touch, midway through the overlap */
+    vector_t contacts[2];
+} contact_manifold_t;
+
+/**
+ * Represents when a moving shape first touches a fixed shape.
+ */
+typedef struct {
+    /** Whether the moving shape touches the fixed shape during its motion */
+    bool hit;
+    /**
+     * If the shapes touch, the fraction of the motion completed when they
+     * first touch, between 0 and 1.
+     * If hit is false, this value is undefined.
+     */
+    double time;
+    /**
+     * If the shapes touch, the axis they touch along.
+     * This is a unit vector pointing from the moving shape towards the fixed one.
+     * If hit is false, this value is undefined.
+     */
+    vector_t axis;
+} impact_info_t;
+
+/**
+ * The algorithms that can decide whether two polygons collide.
+ */
+typedef enum {
+    /**
+     * GJK for pairs of convex polygons with many vertices,
+     * the separating axis test otherwise
+     */
+    NARROW_PHASE_AUTO,
+    /** Always the separating axis test */
+    NARROW_PHASE_SAT,
+    /** GJK and EPA whenever both polygons are convex; see gjk.h */
+    NARROW_PHASE_GJK
+} narrow_phase_kind_t;
+
+/**
+ * Counts how often find_body_collision_cached() is able to skip the full
+ * separating axis test because the cached axis still separates the shapes.
+ */
+typedef struct {
+    /** The number of tests that started by trying a cached axis */
+    size_t axis_cache_tests;
+    /** The number of those tests the cached axis separated */
+    size_t axis_cache_hits;
+} collision_stats_t;
+
 /**
  * Computes the status of the collision between two convex polygons.
  * The shapes are given as lists of vertices in counterclockwise order.
@@ -34,4 +98,254 @@ typedef struct {
  */
 collision_info_t find_collision(list_t *shape1, list_t *shape2);
 
+/**
+ * Computes the status of the collision between two polygons,
+ * like find_collision(), and describes how they overlap if they collide.
+ * Contact points are found by clipping the edge of one shape that faces
+ * the collision axis against the sides of the other shape's facing edge.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param manifold if not NULL and the shapes collide, set to the penetration
+ *   depth along the collision axis and the points where the shapes touch
+ * @return whether the shapes are colliding, and if so, the collision axis
+ */
+collision_info_t find_collision_manifold(list_t *shape1, list_t *shape2,
+  contact_manifold_t *manifold);
+
+/**
+ * Computes the status of the collision between two convex polygons stored
+ * contiguously, like find_collision(), without copying their vertices
+ * or allocating memory.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @return whether the shapes are colliding, and if so, the collision axis
+ */
+collision_info_t find_collision_array(const vec_array_t *shape1,
+  const vec_array_t *shape2);
+
+/**
+ * Computes the status of the collision between two polygons stored
+ * contiguously, like find_collision_manifold().
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param manifold if not NULL and the shapes collide, set to the penetration
+ *   depth along the collision axis and the points where the shapes touch
+ * @return whether the shapes are colliding, and if so, the collision axis
+ */
+collision_info_t find_collision_manifold_array(const vec_array_t *shape1,
+  const vec_array_t *shape2, contact_manifold_t *manifold);
+
+/**
+ * Computes the status of the collision between two circles.
+ * Circles that only touch count as colliding.
+ *
+ * @param center1 the center of the first circle
+ * @param radius1 the radius of the first circle
+ * @param center2 the center of the second circle
+ * @param radius2 the radius of the second circle
+ * @return whether the circles are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from center1 towards center2.
+ */
+collision_info_t find_circle_collision(vector_t center1, double radius1,
+  vector_t center2, double radius2);
+
+/**
+ * Computes the status of the collision between a circle and a convex polygon.
+ * The polygon is given as a list of vertices in counterclockwise order.
+ * Gives the same result as find_collision() on the polygon and a finely
+ * tessellated circle, but its cost depends only on the polygon's vertices.
+ *
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param shape the polygon
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from the circle towards the polygon.
+ */
+collision_info_t find_circle_polygon_collision(vector_t center, double radius,
+  list_t *shape);
+
+/**
+ * Computes the status of the collision between a circle and a convex polygon
+ * stored contiguously, like find_circle_polygon_collision().
+ *
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param shape the polygon
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from the circle towards the polygon.
+ */
+collision_info_t find_circle_polygon_collision_array(vector_t center,
+  double radius, const vec_array_t *shape);
+
+/**
+ * Computes the status of the collision between two capsules in closed form:
+ * they collide if the distance between their segments is at most the sum of
+ * their radii. A capsule with a zero-length segment is a circle.
+ *
+ * @param capsule1 the first capsule
+ * @param capsule2 the second capsule
+ * @return whether the capsules are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from capsule1 towards capsule2.
+ */
+collision_info_t find_capsule_collision(capsule_t capsule1, capsule_t capsule2);
+
+/**
+ * Computes the status of the collision between a circle and a capsule,
+ * from the distance between the circle's center and the capsule's segment.
+ *
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param capsule the capsule
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from the circle towards the capsule.
+ */
+collision_info_t find_circle_capsule_collision(vector_t center, double radius,
+  capsule_t capsule);
+
+/**
+ * Computes the status of the collision between a convex polygon and a capsule.
+ * Gives the same result as find_collision() on the polygon and a finely
+ * tessellated capsule, but only tests the polygon's edge normals, the normal
+ * of the capsule's segment, and the axes from the segment's ends to the
+ * polygon's nearest vertices.
+ *
+ * @param shape the polygon
+ * @param capsule the capsule
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from the polygon towards the capsule.
+ */
+collision_info_t find_polygon_capsule_collision(list_t *shape,
+  capsule_t capsule);
+
+/**
+ * Computes the status of the collision between a convex polygon stored
+ * contiguously and a capsule, like find_polygon_capsule_collision().
+ *
+ * @param shape the polygon
+ * @param capsule the capsule
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from the polygon towards the capsule.
+ */
+collision_info_t find_polygon_capsule_collision_array(const vec_array_t *shape,
+  capsule_t capsule);
+
+/**
+ * Computes the status of the collision between two bodies' shapes.
+ * Equivalent to calling find_collision() on the bodies' shapes,
+ * except that bodies marked with body_set_circle() are treated as exact circles
+ * (see find_circle_collision() and find_circle_polygon_collision()).
+ * Compares the bodies' cached bounding boxes first,
+ * so bodies that are far apart are rejected in constant time
+ * without copying their shapes.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @return whether the bodies are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from body1 towards body2.
+ */
+collision_info_t find_body_collision(body_t *body1, body_t *body2);
+
+/**
+ * Computes the status of the collision between two bodies,
+ * like find_body_collision(), reusing an axis from a previous call.
+ * Bodies that moved apart usually stay separated along the same axis,
+ * so the cached axis is tested first and, if it still separates the bodies,
+ * the rest of the separating axis test is skipped.
+ * Afterwards, the cache holds the axis that separated the bodies,
+ * or the axis of least overlap if they collided.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param axis_cache the axis to try first, or VEC_ZERO if there is none yet.
+ * Should be kept between calls for the same pair of bodies.
+ * @return whether the bodies are colliding, and if so, the collision axis
+ */
+collision_info_t find_body_collision_cached(body_t *body1, body_t *body2,
+  vector_t *axis_cache);
+
+/**
+ * Computes the status of the collision between two bodies,
+ * like find_body_collision_cached(), and describes how they overlap
+ * if they collide (see find_collision_manifold()).
+ * A circle touches a shape at one point, along the collision axis.
+ * A compound body (see body_set_parts() and body_set_capsules()) collides
+ * wherever one of its parts does, and the deepest such collision is reported; the axis cache is not
+ * used for compound bodies.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param axis_cache the axis to try first, or NULL to not use one
+ * @param manifold if not NULL and the bodies collide, set to the penetration
+ *   depth along the collision axis and the points where the bodies touch
+ * @return whether the bodies are colliding, and if so, the collision axis
+ */
+collision_info_t find_body_collision_manifold(body_t *body1, body_t *body2,
+  vector_t *axis_cache, contact_manifold_t *manifold);
+
+/**
+ * Computes the status of the collisions between one body and many others,
+ * e.g. a moving body and every wall of a level.
+ * Equivalent to calling find_body_collision() on the query body and each
+ * candidate, but the query body's shape and the values the narrow phase
+ * needs from it are prepared once rather than once per candidate,
+ * and candidates whose bounding boxes miss the query body's are skipped
+ * without preparing them.
+ *
+ * @param query the body to test against every candidate
+ * @param candidates an array of bodies to test against the query body
+ * @param count the number of candidates
+ * @param results an array with room for count results, set to whether
+ *   the query body collides with each candidate, and if so, the collision
+ *   axis pointing from the query body towards the candidate
+ */
+void find_collisions_batch(body_t *query, body_t **candidates, size_t count,
+  collision_info_t *results);
+
+/**
+ * Sweeps a body along a straight line and finds when it first touches
+ * another body that stays still, so that bodies moving far in one tick
+ * cannot pass through thin bodies between one tick and the next.
+ * Both bodies must be convex polygons, circles (see body_set_circle()),
+ * or compounds of convex parts and capsules (see body_set_parts()),
+ * in which case the earliest impact of any part counts.
+ * Polygons are swept with the separating axis test, tracking when their
+ * projections onto each axis start and stop overlapping, and circles are
+ * swept as rays against the other body grown by the circle's radius,
+ * so the time of impact is exact rather than found by sampling.
+ * Bodies that already touch at the start of the motion do not count as hitting.
+ *
+ * @param moving the body that moves
+ * @param displacement how far the moving body moves, from its current position
+ * @param fixed the body that stays still
+ * @return whether and when the moving body first touches the fixed body
+ */
+impact_info_t find_time_of_impact(body_t *moving, vector_t displacement,
+  body_t *fixed);
+
+/**
+ * Gets the counts of axis cache tests and hits since the program started
+ * or since collision_reset_stats() was last called.
+ *
+ * @return the current statistics
+ */
+collision_stats_t collision_get_stats(void);
+
+/**
+ * Resets the axis cache statistics to zero.
+ */
+void collision_reset_stats(void);
+
+/**
+ * Selects the algorithm used for collisions between two polygons
+ * by find_collision() and the body collision functions.
+ * Circles are always handled analytically.
+ * The default is NARROW_PHASE_AUTO; the others are mostly for benchmarking.
+ *
+ * @param kind the algorithm to use from now on
+ */
+void collision_set_narrow_phase(narrow_phase_kind_t kind);
+
 #endif // #ifndef __COLLISION_H__
@@ -0,0 +1,36 @@
+#ifndef __DECOMPOSITION_H__
+#define __DECOMPOSITION_H__
+
+#include "list.h"
+#include "vector.h"
+
+/**
+ * Splits a simple polygon into triangles by ear clipping:
+ * repeatedly cutting off a vertex whose triangle with its neighbors
+ * lies inside the polygon.
+ * The polygon may be clockwise or counterclockwise and may be concave,
+ * but its edges must not cross. Collinear vertices produce no triangles.
+ * Asserts that the polygon has at least 3 vertices.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @return a new list of triangles, each a new list of 3 vertices
+ *   in counterclockwise order. Freeing the list frees the triangles.
+ */
+list_t *polygon_triangulate(list_t *polygon);
+
+/**
+ * Splits a simple polygon into convex polygons using the Hertel-Mehlhorn
+ * algorithm: triangulates it (see polygon_triangulate()), then merges
+ * neighboring pieces across each diagonal whose removal keeps them convex.
+ * This gives at most four times the fewest possible convex pieces,
+ * and a convex polygon gives a single piece.
+ * Meant to run once when a shape is loaded, since it takes cubic time
+ * in the number of vertices.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @return a new list of convex polygons, each a new list of vertices
+ *   in counterclockwise order. Freeing the list frees the polygons.
+ */
+list_t *polygon_decompose(list_t *polygon);
+
+#endif // #ifndef __DECOMPOSITION_H__
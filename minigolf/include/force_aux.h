@@ -11,7 +11,8 @@ typedef struct force_aux {
     list_t *body_list;
     double constant;
     collision_handler_t collision_handler;
-    bool is_collision_handled;
+    // the last separating or least-overlap axis, see find_body_collision_cached()
+    vector_t cached_axis;
     void *extra_aux;
     free_func_t freer;
 } force_aux_t;
@@ -24,9 +25,9 @@ void force_set_collision_handler(force_aux_t *aux, collision_handler_t handler);
 
 collision_handler_t force_get_collision_handler(force_aux_t *aux);
 
-void force_set_is_collision_handled(force_aux_t *aux, bool is_collision_handled);
+void force_set_cached_axis(force_aux_t *aux, vector_t axis);
 
-bool force_get_is_collision_handled(force_aux_t *aux);
+vector_t force_get_cached_axis(force_aux_t *aux);
 
 void force_set_extra_aux(force_aux_t *aux, void *extra_aux);
 
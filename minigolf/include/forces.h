@@ -61,7 +61,8 @@ void create_drag(scene_t *scene, double gamma, body_t *body);
  * This generalizes create_destructive_collision() from last week,
  * allowing different things to happen on a collision.
  * The handler is passed the bodies, the collision axis, and an auxiliary value.
- * It should only be called once while the bodies are still colliding.
+ * It is called once when the bodies start colliding (a CONTACT_BEGIN handler,
+ * see scene_add_contact_handler()), and again only after they separate.
  *
  * @param scene the scene containing the bodies
  * @param body1 the first body
@@ -94,13 +95,16 @@ void create_destructive_collision(scene_t *scene, body_t *body1, body_t *body2);
 /**
  * Adds a force creator to a scene that applies impulses
  * to resolve collisions between two bodies in the scene.
- * This should be represented as an on-collision callback
- * registered with create_collision().
+ * The scene's contact solver handles the collision
+ * (see scene_add_physics_contact()), together with every other contact
+ * touching on the same tick.
  *
- * You may remember from project01 that you should avoid applying impulses
- * multiple times while the bodies are still colliding.
- * You should also have a special case that allows either body1 or body2
- * to have mass INFINITY, as this is useful for simulating walls.
+ * Either body1 or body2 may have mass INFINITY,
+ * as this is useful for simulating walls.
+ * On every tick the bodies overlap, they are also pushed apart along the
+ * collision axis by the penetration depth, split in proportion to their
+ * inverse masses (see body_add_correction()), so that resting contacts
+ * stop overlapping after one tick.
  *
  * @param scene the scene containing the bodies
  * @param elasticity the "coefficient of restitution" of the collision;
@@ -116,6 +120,43 @@ void create_physics_collision(
 
 );
 
+/**
+ * Like create_collision(), but between every body of one collision type
+ * and every body of another (see scene_register_collision_handler()),
+ * so the handler does not have to be added again for each new body.
+ *
+ * @param scene the scene containing the bodies
+ * @param type1 the type of the bodies passed to the handler as body1
+ * @param type2 the type of the bodies passed to the handler as body2
+ * @param handler a function to call whenever two such bodies collide
+ * @param aux an auxiliary value to pass to the handler
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void register_collision(
+    scene_t *scene,
+    size_t type1,
+    size_t type2,
+    collision_handler_t handler,
+    void *aux,
+    free_func_t freer
+);
+
+/**
+ * Like create_physics_collision(), but between every body of one collision
+ * type and every body of another (see scene_register_physics_contact()).
+ *
+ * @param scene the scene containing the bodies
+ * @param elasticity the "coefficient of restitution" of the collisions
+ * @param type1 the type of the first bodies
+ * @param type2 the type of the second bodies
+ */
+void register_physics_collision(
+    scene_t *scene,
+    double elasticity,
+    size_t type1,
+    size_t type2
+);
+
 void create_friction_collision(
   scene_t *scene,
   body_t *body,
@@ -123,6 +164,19 @@ void create_friction_collision(
   double coefficient
 );
 
+/**
+ * A collision_handler_t that applies a single impulse along the collision
+ * axis, as create_physics_collision() did before the contact solver.
+ * Kept with its original signature for callers that pass it to
+ * create_collision() or register_collision() with a force_aux_t holding
+ * the elasticity as aux. New code should use create_physics_collision(),
+ * since this impulse is applied on top of anything the solver does.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param axis the collision axis, pointing from body1 towards body2
+ * @param aux a force_aux_t whose constant is the elasticity
+ */
 void physics_collision_handler(body_t *body1, body_t *body2, vector_t axis, void *aux);
 
 void friction_collision(void *aux);
@@ -133,8 +187,30 @@ void spring(void *aux);
 
 void drag(void *aux);
 
-void destructive_collision(void *aux);
+/**
+ * The contact handler added by create_destructive_collision(),
+ * which removes both bodies when they begin touching.
+ *
+ * BREAKING CHANGE: this used to be a force creator, void (*)(void *aux),
+ * which tested the bodies in a force_aux_t for a collision every tick.
+ * It is now a contact_handler_t that the scene calls once the bodies touch,
+ * so code that passed it to scene_add_bodies_force_creator() or called it
+ * directly must use create_destructive_collision() instead.
+ */
+void destructive_collision(body_t *body1, body_t *body2, vector_t axis,
+    const contact_manifold_t *manifold, void *aux);
 
-void collision(void *aux);
+/**
+ * The contact handler added by create_collision() and register_collision(),
+ * which calls the collision_handler_t stored in aux (a force_aux_t)
+ * with its extra aux.
+ *
+ * BREAKING CHANGE: like destructive_collision(), this used to be a force
+ * creator taking only aux and is now a contact_handler_t, so code that
+ * passed it to scene_add_bodies_force_creator() or called it directly
+ * must use create_collision() or register_collision() instead.
+ */
+void collision(body_t *body1, body_t *body2, vector_t axis,
+    const contact_manifold_t *manifold, void *aux);
 
 #endif // #ifndef __FORCES_H__
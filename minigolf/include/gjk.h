@@ -0,0 +1,44 @@
+#ifndef __GJK_H__
+#define __GJK_H__
+
+#include <stdbool.h>
+#include "list.h"
+#include "vec_array.h"
+#include "vector.h"
+
+/**
+ * Tests whether two convex polygons intersect using the
+ * Gilbert-Johnson-Keerthi algorithm, and if they do, finds the axis of least
+ * penetration using the expanding polytope algorithm.
+ * Both work on the Minkowski difference of the shapes, whose extreme points
+ * are found by hill climbing around each polygon's vertices, so they take
+ * time roughly linear in the number of vertices rather than quadratic
+ * like the separating axis test.
+ * The shapes are given as lists of vertices in counterclockwise order.
+ *
+ * Shapes that only touch, and inputs where the iterations fail to converge,
+ * are reported as undecided by setting the axis to VEC_ZERO;
+ * callers should fall back to the separating axis test in that case.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param axis set to a unit vector. If the shapes are apart, it is an axis
+ * that separates them. If they intersect, it is the direction shape2 would
+ * have to move to separate them by the shortest distance.
+ * @return whether the shapes intersect
+ */
+bool gjk_intersect(list_t *shape1, list_t *shape2, vector_t *axis);
+
+/**
+ * Tests whether two convex polygons stored contiguously intersect,
+ * like gjk_intersect(), without copying their vertices.
+ *
+ * @param shape1 the first shape
+ * @param shape2 the second shape
+ * @param axis set like the axis of gjk_intersect()
+ * @return whether the shapes intersect
+ */
+bool gjk_intersect_array(const vec_array_t *shape1, const vec_array_t *shape2,
+    vector_t *axis);
+
+#endif // #ifndef __GJK_H__
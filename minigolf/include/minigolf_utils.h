@@ -2,6 +2,7 @@
 #define __MINIGOLF_UTILS_H__
 
 #include "list.h"
+#include "vec_array.h"
 #include "vector.h"
 #include "collision.h"
 #include "scene.h"
@@ -18,12 +19,13 @@ typedef struct minigolf_course {
 
 void make_obstacle(scene_t *scene, list_t *obstacle_shape, minigolf_course_t course);
 
-list_t *make_rectangle_with_width(vector_t point1, vector_t point2, int width, int offset);
+vec_array_t *make_rectangle_with_width(vector_t point1, vector_t point2, int width, int offset);
 
 /**
  * Makes a minigolf course in a scene out of wall coordinates, the center of the
  * ball, the center of the hole, and the par for the course
  * Wall coordinates are the corners of the course in counterclockwise order.
+ * The course takes ownership of the list of wall coordinates and frees it.
  */
 minigolf_course_t make_minigolf_course(scene_t *scene, list_t *wall_coordinates,
   vector_t ball_center, vector_t hole_center, int par);
@@ -0,0 +1,74 @@
+#ifndef __PAIR_TABLE_H__
+#define __PAIR_TABLE_H__
+
+#include <stddef.h>
+#include "list.h"
+
+/**
+ * A hash table keyed by an unordered pair of pointers, e.g. two body_t*s.
+ * The pairs (a, b) and (b, a) refer to the same entry.
+ * Each key maps to a single non-NULL value.
+ * The table automatically grows its internal array when it gets too full.
+ */
+typedef struct pair_table pair_table_t;
+
+/**
+ * Allocates memory for an empty table.
+ * Asserts that the required memory was allocated.
+ *
+ * @param initial_size the number of entries to allocate space for
+ * @param freer if non-NULL, a function to call on the values in the table
+ *   in pair_table_free() when they are no longer in use
+ * @return a pointer to the newly allocated table
+ */
+pair_table_t *pair_table_init(size_t initial_size, free_func_t freer);
+
+/**
+ * Releases the memory allocated for a table and the values it contains.
+ *
+ * @param table a pointer to a table returned from pair_table_init()
+ */
+void pair_table_free(pair_table_t *table);
+
+/**
+ * Gets the number of entries in a table.
+ *
+ * @param table a pointer to a table returned from pair_table_init()
+ * @return the number of pairs stored in the table
+ */
+size_t pair_table_size(pair_table_t *table);
+
+/**
+ * Looks up the value stored for a pair.
+ *
+ * @param table a pointer to a table returned from pair_table_init()
+ * @param key1 one element of the pair
+ * @param key2 the other element of the pair
+ * @return the value stored for the pair, or NULL if there is none
+ */
+void *pair_table_get(pair_table_t *table, void *key1, void *key2);
+
+/**
+ * Stores a value for a pair.
+ * Asserts that the keys and value are non-NULL
+ * and that the pair is not already in the table.
+ *
+ * @param table a pointer to a table returned from pair_table_init()
+ * @param key1 one element of the pair
+ * @param key2 the other element of the pair
+ * @param value the value to store
+ */
+void pair_table_put(pair_table_t *table, void *key1, void *key2, void *value);
+
+/**
+ * Removes a pair from a table and returns its value.
+ * The value is not freed.
+ *
+ * @param table a pointer to a table returned from pair_table_init()
+ * @param key1 one element of the pair
+ * @param key2 the other element of the pair
+ * @return the value that was stored for the pair, or NULL if there was none
+ */
+void *pair_table_remove(pair_table_t *table, void *key1, void *key2);
+
+#endif // #ifndef __PAIR_TABLE_H__
@@ -2,9 +2,18 @@
 #define __POLYGON_H__
 
 #include "color.h"
+#include <stdbool.h>
 #include "list.h"
+#include "vec_array.h"
 #include "vector.h"
 
+/**
+ * Convex polygons with fewer vertices than this are projected by scanning
+ * every vertex rather than by binary search (see polygon_project_convex()),
+ * both here and in the collision tests, since for them the scan is faster.
+ */
+extern const size_t BINARY_PROJECTION_MIN_VERTICES;
+
 /**
  * Contains the polygon's vertices, color, velocity, and elasticity.
  */
@@ -57,6 +66,62 @@ void polygon_translate(list_t *polygon, vector_t translation);
  */
 void polygon_rotate(list_t *polygon, double angle, vector_t point);
 
+/**
+ * Returns whether a polygon is convex, i.e. every turn between consecutive
+ * edges goes the same way. Collinear vertices are allowed.
+ * Works for both clockwise and counterclockwise polygons.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @return whether the polygon is convex
+ */
+bool polygon_is_convex(list_t *polygon);
+
+/**
+ * Computes the unit normal of each edge of a polygon.
+ * Edge i runs from vertex i to vertex i + 1 (wrapping around to vertex 0),
+ * and its normal is the edge direction rotated 90 degrees counterclockwise.
+ * These are the candidate separating axes used by find_collision().
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @param normals an array with room for one vector per vertex,
+ * which is filled with the edge normals
+ */
+void polygon_edge_normals(list_t *polygon, vector_t *normals);
+
+/**
+ * Copies the vertices of a polygon into a contiguous array,
+ * e.g. for the SIMD kernels in simd.h.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @param vertices an array with room for one vector per vertex
+ */
+void polygon_copy_vertices(list_t *polygon, vector_t *vertices);
+
+/**
+ * Projects every vertex of a polygon onto an axis.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @param axis the unit vector to project onto
+ * @return the smallest and largest projections, as a vector_t {min, max}
+ */
+vector_t polygon_project(list_t *polygon, vector_t axis);
+
+/**
+ * Projects a convex polygon onto an axis, like polygon_project().
+ * Around a convex polygon the edge directions turn steadily,
+ * so the vertices furthest along the axis in either direction are found
+ * by binary search over the edges, in logarithmic time.
+ * Polygons with fewer than BINARY_PROJECTION_MIN_VERTICES vertices are
+ * scanned linearly instead, which is faster for them.
+ * Repeated consecutive vertices (edges of length zero) are allowed.
+ * The polygon may be clockwise or counterclockwise.
+ *
+ * @param polygon the list of vertices that make up a convex polygon
+ * @param axis the unit vector to project onto
+ * @return the smallest and largest projections, as a vector_t {min, max}
+ */
+vector_t polygon_project_convex(list_t *polygon, vector_t axis);
+
 /**
  * Initializes a star with a given radius and number of points.
  *
@@ -75,4 +140,109 @@ list_t *star_init(double radius, size_t num_points);
  */
 vector_t *get_vector_from_polygon(list_t *polygon, size_t i);
 
+/**
+ * The functions below are variants of the ones above for polygons stored
+ * contiguously in a vec_array_t, which read each vertex without following
+ * a pointer. Their vertices must be listed like those of a list_t polygon.
+ */
+
+/**
+ * Computes the area of a polygon, like polygon_area().
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @return the area of the polygon
+ */
+double polygon_array_area(const vec_array_t *polygon);
+
+/**
+ * Computes the center of mass of a polygon, like polygon_centroid().
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @return the centroid of the polygon
+ */
+vector_t polygon_array_centroid(const vec_array_t *polygon);
+
+/**
+ * Translates all vertices in a polygon by a given vector.
+ * Note: mutates the original polygon.
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @param translation the vector to add to each vertex's position
+ */
+void polygon_array_translate(vec_array_t *polygon, vector_t translation);
+
+/**
+ * Rotates vertices in a polygon by a given angle about a given point.
+ * Note: mutates the original polygon.
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @param angle the angle to rotate the polygon, in radians.
+ * A positive angle means counterclockwise.
+ * @param point the point to rotate around
+ */
+void polygon_array_rotate(vec_array_t *polygon, double angle, vector_t point);
+
+/**
+ * Rotates a polygon about the origin and then translates it,
+ * e.g. to place a shape stored relative to its centroid.
+ * Unlike polygon_array_rotate(), computes the sine and cosine only once.
+ * Asserts that the polygon and the result have the same size.
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @param angle the angle to rotate the polygon, in radians.
+ * A positive angle means counterclockwise.
+ * @param position the vector to add to each rotated vertex
+ * @param result an array of the same size, which is overwritten with
+ * the transformed vertices
+ */
+void polygon_array_transform(const vec_array_t *polygon, double angle,
+    vector_t position, vec_array_t *result);
+
+/**
+ * Returns whether a polygon is convex, like polygon_is_convex().
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @return whether the polygon is convex
+ */
+bool polygon_array_is_convex(const vec_array_t *polygon);
+
+/**
+ * Computes the unit normal of each edge of a polygon,
+ * like polygon_edge_normals().
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @param normals an array with room for one vector per vertex,
+ * which is filled with the edge normals
+ */
+void polygon_array_edge_normals(const vec_array_t *polygon, vector_t *normals);
+
+/**
+ * Projects every vertex of a polygon onto an axis.
+ *
+ * @param polygon the array of vertices that make up the polygon
+ * @param axis the unit vector to project onto
+ * @return the smallest and largest projections, as a vector_t {min, max}
+ */
+vector_t polygon_array_project(const vec_array_t *polygon, vector_t axis);
+
+/**
+ * Projects a convex polygon onto an axis in logarithmic time,
+ * like polygon_project_convex().
+ *
+ * @param polygon the array of vertices that make up a convex polygon
+ * @param axis the unit vector to project onto
+ * @return the smallest and largest projections, as a vector_t {min, max}
+ */
+vector_t polygon_array_project_convex(const vec_array_t *polygon,
+    vector_t axis);
+
+/**
+ * Initializes a star like star_init(), stored in a single allocation.
+ *
+ * @param radius - the outer radius of the star
+ * @param num_points - the number of outer points in the star
+ * @return array of points that make up a star
+ **/
+vec_array_t *star_array_init(double radius, size_t num_points);
+
 #endif // #ifndef __POLYGON_H__
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include "list.h"
 #include "body.h"
+#include "broad_phase.h"
+#include "collision.h"
 
 /**
  * A collection of bodies and force creators.
@@ -19,6 +21,50 @@ typedef struct scene scene_t;
  */
 typedef void (*force_creator_t)(void *aux);
 
+/**
+ * The stages of a contact between two bodies that the scene reports
+ * to contact handlers (see scene_add_contact_handler()).
+ */
+typedef enum {
+    /** The bodies started colliding this tick */
+    CONTACT_BEGIN,
+    /** The bodies were already colliding and still are */
+    CONTACT_PERSIST,
+    /** The bodies stopped colliding this tick */
+    CONTACT_END
+} contact_event_kind_t;
+
+/**
+ * A function called when a contact between two bodies begins, persists,
+ * or ends.
+ * @param body1 the first body passed to scene_add_contact_handler()
+ * @param body2 the second body passed to scene_add_contact_handler()
+ * @param axis a unit vector pointing from body1 towards body2 that the
+ *   bodies collide along, or last collided along if the contact ended
+ * @param manifold how the bodies overlap (see find_body_collision_manifold()),
+ *   or NULL if the contact ended
+ * @param aux the auxiliary value passed to scene_add_contact_handler()
+ */
+typedef void (*contact_handler_t)(body_t *body1, body_t *body2, vector_t axis,
+    const contact_manifold_t *manifold, void *aux);
+
+/**
+ * Whether a sensor event is a body starting or stopping to overlap a sensor.
+ */
+typedef enum {
+    SENSOR_ENTER,
+    SENSOR_EXIT
+} sensor_event_kind_t;
+
+/**
+ * A body starting or stopping to overlap a sensor (see body_set_sensor()).
+ */
+typedef struct {
+    sensor_event_kind_t kind;
+    body_t *sensor;
+    body_t *body;
+} sensor_event_t;
+
 /**
  * Allocates memory for an empty scene.
  * Makes a reasonable guess of the number of bodies to allocate space for.
@@ -107,10 +153,193 @@ void scene_add_bodies_force_creator(
     free_func_t freer
 );
 
+/**
+ * Registers a function to call when two bodies start colliding,
+ * keep colliding, or stop colliding.
+ * The scene keeps the state of every pair of bodies with contact handlers
+ * in a hash table. On each tick, its collision stage runs the narrow phase
+ * once for each such pair whose bounding boxes overlap, compares the result
+ * with the previous tick, and calls the pair's handlers for that event.
+ * Pairs that stop overlapping get a CONTACT_END event.
+ * Sensors (see body_set_sensor()) never have contacts.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param kind the event to call the handler on
+ * @param handler the function to call
+ * @param aux an auxiliary value to pass to the handler.
+ *   The handler is removed if either body is removed.
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void scene_add_contact_handler(
+    scene_t *scene,
+    body_t *body1,
+    body_t *body2,
+    contact_event_kind_t kind,
+    contact_handler_t handler,
+    void *aux,
+    free_func_t freer
+);
+
+/**
+ * Registers a contact handler between every body of one collision type
+ * and every body of another (see body_set_collision_type()),
+ * including bodies added to the scene later.
+ * Rather than keeping state for every pair of bodies that could collide,
+ * the scene keeps a table of handlers for each pair of types, and only
+ * tracks a contact (see scene_add_contact_handler()) between two bodies
+ * once the collision stage finds their bounding boxes overlapping.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param type1 the type of the body passed to the handler as body1
+ * @param type2 the type of the body passed to the handler as body2
+ * @param kind the event to call the handler on
+ * @param handler the function to call
+ * @param aux an auxiliary value to pass to the handler
+ * @param freer if non-NULL, a function to call in order to free aux
+ *   when the scene is freed
+ */
+void scene_register_collision_handler(
+    scene_t *scene,
+    size_t type1,
+    size_t type2,
+    contact_event_kind_t kind,
+    contact_handler_t handler,
+    void *aux,
+    free_func_t freer
+);
+
+/**
+ * Keeps two bodies from passing through each other, bouncing them apart
+ * when they hit. The scene tracks their contact like one with contact
+ * handlers (see scene_add_contact_handler()), and on every tick they touch,
+ * a contact solver applies impulses along the collision axis (see
+ * body_add_impulse()), then pushes them out of each other (see
+ * body_add_correction()).
+ * The solver handles every touching pair together: it makes several passes,
+ * each correcting one pair's velocity at a time, so that piles and stacks
+ * of bodies settle without jittering. Each pair starts from the impulse it
+ * needed on the previous tick (warm starting), so resting contacts only
+ * need small adjustments.
+ * Bodies approaching each other slower than a small threshold do not
+ * bounce, so bodies resting under gravity come to rest.
+ * Only the normal direction is solved; there is no friction.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param elasticity the "coefficient of restitution" of the collision;
+ *   0 is a perfectly inelastic collision and 1 is a perfectly elastic one
+ */
+void scene_add_physics_contact(
+    scene_t *scene,
+    body_t *body1,
+    body_t *body2,
+    double elasticity
+);
+
+/**
+ * Like scene_add_physics_contact(), but between every body of one collision
+ * type and every body of another (see scene_register_collision_handler()).
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param type1 the type of the first bodies
+ * @param type2 the type of the second bodies
+ * @param elasticity the "coefficient of restitution" of the collisions
+ */
+void scene_register_physics_contact(
+    scene_t *scene,
+    size_t type1,
+    size_t type2,
+    double elasticity
+);
+
+/**
+ * Returns whether two bodies with contact handlers or a physics contact,
+ * or whose types have either, were colliding as of the last time the scene
+ * checked them.
+ * This is a hash table lookup, so it is cheap enough to call every tick.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body1 the first body
+ * @param body2 the second body
+ * @return whether the bodies are in contact,
+ *   or false if they have no contact handlers and are not touching
+ */
+bool scene_bodies_touching(scene_t *scene, body_t *body1, body_t *body2);
+
+/**
+ * Chooses the algorithm the collision stage uses to find bodies whose
+ * bounding boxes overlap. The default is BROAD_PHASE_SPATIAL_HASH.
+ * Every algorithm finds the same pairs, so this only affects performance:
+ * a spatial hash suits scenes whose bodies are all about the same size,
+ * sweep and prune suits scenes where most bodies move a little each tick,
+ * and an AABB tree suits scenes of mostly static bodies (mass INFINITY).
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param kind the broad phase algorithm to use
+ */
+void scene_set_broad_phase(scene_t *scene, broad_phase_kind_t kind);
+
+/**
+ * Sets the width of the cells in the grid the spatial hash broad phase uses
+ * to find bodies near each other.
+ * Cells should be a little larger than a typical body.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param cell_size the width of each cell, or 0 (the default)
+ *   to choose a width from the sizes of the bodies on every tick
+ */
+void scene_set_grid_cell_size(scene_t *scene, double cell_size);
+
+/**
+ * Turns continuous collision detection on or off. It is off by default.
+ * When it is on, a body with finite mass that is a convex polygon or a circle
+ * and moves further than its own width or height in one tick is swept along
+ * its path (see find_time_of_impact()) towards the bodies with mass INFINITY
+ * it has contact handlers or collision handlers with. If it would hit one,
+ * it is stopped where they first touch, their contact handlers are
+ * invoked there, it bounces off if they have a physics contact
+ * (see scene_add_physics_contact()), and the body moves on for the rest of
+ * the tick, so that large time steps do not let fast bodies pass through
+ * thin walls.
+ * The bodies with mass INFINITY are swept against where they are at the end
+ * of the tick, as if they had been there all along, so ones that move are
+ * found even if they only moved into the path during the tick.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param enabled whether to sweep fast bodies along their paths
+ */
+void scene_set_continuous_collisions(scene_t *scene, bool enabled);
+
+/**
+ * Takes the oldest sensor event the scene has not reported yet.
+ * After each tick, the scene checks every sensor (see body_set_sensor())
+ * against the bodies that are not sensors and can move (mass not INFINITY),
+ * asking the broad phase for the bodies in the sensor's bounding box
+ * (see broad_phase_query()) rather than checking every body.
+ * Bodies whose collision filters keep them from colliding with a sensor
+ * (see body_can_collide()) are skipped.
+ * The check is cheap: bodies overlap a sensor if their bounding boxes do,
+ * refined to an exact test when either of them is a circle.
+ * An event is queued when a body starts overlapping a sensor and when it
+ * stops. Events involving a body are dropped when the body is removed.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param event set to the oldest event, if there is one
+ * @return whether there was an event
+ */
+bool scene_poll_sensor_event(scene_t *scene, sensor_event_t *event);
+
 /**
  * Executes a tick of a given scene over a small time interval.
- * This requires executing all the force creators
- * and then ticking each body (see body_tick()).
+ * This requires running the collision stage, executing all the force creators,
+ * solving the physics contacts (see scene_add_physics_contact()),
+ * moving the bodies by the positional corrections they queued
+ * (see body_store_apply_corrections()), ticking the bodies
+ * (see body_store_tick()), and then queuing sensor events
+ * (see scene_poll_sensor_event()).
  * If any bodies are marked for removal, they should be removed from the scene
  * and freed, along with any force creators acting on them.
  *
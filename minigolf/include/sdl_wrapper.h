@@ -95,6 +95,28 @@ void sdl_clear(void);
  */
 void sdl_draw_polygon(list_t *points, rgb_color_t color);
 
+/**
+ * Draws a polygon from the given array of vertices and a color,
+ * like sdl_draw_polygon().
+ *
+ * @param points the array of vertices of the polygon
+ * @param color the color used to fill in the polygon
+ */
+void sdl_draw_polygon_array(const vec_array_t *points, rgb_color_t color);
+
+/**
+ * Draws a polygon given in local space, rotated about its origin
+ * and then placed at a position, like sdl_draw_polygon(),
+ * e.g. to draw a body from body_peek_local_shape().
+ *
+ * @param points the array of vertices of the polygon, relative to its origin
+ * @param position where to place the polygon's origin
+ * @param angle the angle to rotate the polygon by, in radians
+ * @param color the color used to fill in the polygon
+ */
+void sdl_draw_shape(const vec_array_t *points, vector_t position, double angle,
+    rgb_color_t color);
+
 /**
  * Displays the rendered frame on the SDL window.
  * Must be called after drawing the polygons in order to show them.
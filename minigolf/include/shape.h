@@ -0,0 +1,108 @@
+#ifndef __SHAPE_H__
+#define __SHAPE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "aabb.h"
+#include "vec_array.h"
+
+/**
+ * An immutable polygon in local space, which many bodies can share,
+ * each placing the origin of the shape at its centroid and rotating the shape
+ * about it (see body_init_with_shape()).
+ * Shapes are reference counted: every holder of a shape owns one reference,
+ * takes another with shape_retain(), and gives it up with shape_release().
+ */
+typedef struct shape shape_t;
+
+/**
+ * Allocates a shape from a polygon, which should be centered on its centroid
+ * so that bodies rotate it about their centroids.
+ * The shape starts with one reference, owned by the caller.
+ *
+ * @param points the vertices of the polygon, which the shape takes ownership of
+ * @return a pointer to the newly allocated shape
+ */
+shape_t *shape_init(vec_array_t *points);
+
+/**
+ * Gets a circle (approximated by a regular polygon) centered at the origin,
+ * whose first vertex is at {radius, 0} and whose vertices go counterclockwise.
+ * Circles are memoized: while any reference to a circle with the same radius
+ * and number of points exists, this returns that circle instead of a new one.
+ *
+ * @param radius the radius of the circle
+ * @param num_points the number of vertices
+ * @return a new reference to the circle, owned by the caller
+ */
+shape_t *shape_circle(double radius, size_t num_points);
+
+/**
+ * Gets a star like star_array_init(), centered at the origin,
+ * memoized like shape_circle().
+ *
+ * @param radius the outer radius of the star
+ * @param num_points the number of outer points in the star
+ * @return a new reference to the star, owned by the caller
+ */
+shape_t *shape_star(double radius, size_t num_points);
+
+/**
+ * Gets an axis-aligned rectangle centered at the origin,
+ * with its vertices counterclockwise from the top right corner,
+ * memoized like shape_circle().
+ *
+ * @param width the width of the rectangle
+ * @param height the height of the rectangle
+ * @return a new reference to the rectangle, owned by the caller
+ */
+shape_t *shape_rectangle(double width, double height);
+
+/**
+ * Takes another reference to a shape.
+ *
+ * @param shape a pointer to a shape returned from shape_init()
+ * @return the shape, for convenience
+ */
+shape_t *shape_retain(shape_t *shape);
+
+/**
+ * Gives up a reference to a shape, freeing it if that was the last one.
+ *
+ * @param shape a pointer to a shape returned from shape_init()
+ */
+void shape_release(shape_t *shape);
+
+/**
+ * Gets the number of references to a shape.
+ *
+ * @param shape a pointer to a shape returned from shape_init()
+ * @return the number of holders of the shape
+ */
+size_t shape_get_ref_count(const shape_t *shape);
+
+/**
+ * Gets the vertices of a shape, relative to its origin.
+ *
+ * @param shape a pointer to a shape returned from shape_init()
+ * @return the shape's vertices, owned by the shape
+ */
+const vec_array_t *shape_get_points(const shape_t *shape);
+
+/**
+ * Gets the bounding box of a shape, relative to its origin.
+ *
+ * @param shape a pointer to a shape returned from shape_init()
+ * @return the smallest axis-aligned box containing the shape
+ */
+aabb_t shape_get_bounds(const shape_t *shape);
+
+/**
+ * Returns whether a shape is convex, like polygon_is_convex().
+ *
+ * @param shape a pointer to a shape returned from shape_init()
+ * @return whether the shape is convex
+ */
+bool shape_is_convex(const shape_t *shape);
+
+#endif // #ifndef __SHAPE_H__
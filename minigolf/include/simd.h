@@ -0,0 +1,73 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "vector.h"
+
+/**
+ * The instruction sets the vertex kernels can run on.
+ * Each one processes more vertices per instruction than the one before.
+ */
+typedef enum {
+    /** Plain C, one vertex at a time */
+    SIMD_SCALAR,
+    /** 128-bit SSE2 registers, two vertices at a time */
+    SIMD_SSE2,
+    /** 256-bit AVX2 registers, four vertices at a time */
+    SIMD_AVX2
+} simd_level_t;
+
+/**
+ * Returns whether the CPU running the program supports an instruction set.
+ * SIMD_SCALAR is always supported.
+ *
+ * @param level the instruction set
+ * @return whether the kernels can use it
+ */
+bool simd_supported(simd_level_t level);
+
+/**
+ * Gets the instruction set the kernels currently use.
+ * By default this is the best one the CPU supports,
+ * detected the first time a kernel runs.
+ *
+ * @return the instruction set in use
+ */
+simd_level_t simd_get_level(void);
+
+/**
+ * Makes the kernels use an instruction set, e.g. to compare them.
+ * Asserts that the CPU supports it.
+ *
+ * @param level the instruction set to use
+ */
+void simd_set_level(simd_level_t level);
+
+/**
+ * Projects an array of points onto an axis.
+ * Every instruction set computes each projection as x * axis.x + y * axis.y,
+ * rounding the same way as vec_dot(), so they give identical results.
+ * Asserts that there is at least one point.
+ *
+ * @param points the points, stored contiguously
+ * @param count the number of points
+ * @param axis the unit vector to project onto
+ * @return the smallest and largest projections, as a vector_t {min, max}
+ */
+vector_t simd_project(const vector_t *points, size_t count, vector_t axis);
+
+/**
+ * Finds the smallest and largest coordinates of an array of points,
+ * i.e. the corners of their axis-aligned bounding box.
+ * Asserts that there is at least one point.
+ *
+ * @param points the points, stored contiguously
+ * @param count the number of points
+ * @param min set to the smallest x and y coordinates
+ * @param max set to the largest x and y coordinates
+ */
+void simd_bounds(const vector_t *points, size_t count, vector_t *min,
+    vector_t *max);
+
+#endif // #ifndef __SIMD_H__
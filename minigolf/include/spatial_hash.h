@@ -0,0 +1,107 @@
+#ifndef __SPATIAL_HASH_H__
+#define __SPATIAL_HASH_H__
+
+#include "aabb.h"
+#include "body.h"
+#include "broad_phase.h"
+#include "list.h"
+
+/**
+ * A uniform grid of square cells, stored sparsely in a hash table,
+ * that finds the pairs of bodies whose bounding boxes overlap.
+ * Each body is filed under every cell its bounding box touches,
+ * so only bodies sharing a cell are ever compared.
+ * Bodies covering too many cells are compared against every other body instead.
+ * The grid reuses its internal arrays between searches.
+ */
+typedef struct spatial_hash spatial_hash_t;
+
+/**
+ * Allocates memory for an empty grid.
+ *
+ * @param cell_size the width of each cell, or 0 to pick a width automatically
+ *   from the sizes of the bodies on every search
+ * @return a pointer to the newly allocated grid
+ */
+spatial_hash_t *spatial_hash_init(double cell_size);
+
+/**
+ * Releases the memory allocated for a grid.
+ * Does not free any bodies.
+ *
+ * @param hash a pointer to a grid returned from spatial_hash_init()
+ */
+void spatial_hash_free(spatial_hash_t *hash);
+
+/**
+ * Changes the width of the grid's cells.
+ *
+ * @param hash a pointer to a grid returned from spatial_hash_init()
+ * @param cell_size the new width of each cell, or 0 to pick one automatically
+ */
+void spatial_hash_set_cell_size(spatial_hash_t *hash, double cell_size);
+
+/**
+ * Records that a body was added since the last search,
+ * so that spatial_hash_query() finds it before the grid is rebuilt.
+ *
+ * @param hash a pointer to a grid returned from spatial_hash_init()
+ * @param body the body added to the list of bodies searched
+ */
+void spatial_hash_add(spatial_hash_t *hash, body_t *body);
+
+/**
+ * Forgets a body, so that spatial_hash_query() no longer reports it.
+ * Must not be called from within a pair callback.
+ *
+ * @param hash a pointer to a grid returned from spatial_hash_init()
+ * @param body the body removed from the list of bodies searched
+ */
+void spatial_hash_remove(spatial_hash_t *hash, body_t *body);
+
+/**
+ * Rebuilds the grid from the current bounds of a list of bodies without
+ * searching it, so that spatial_hash_query() finds them where they are now.
+ *
+ * @param hash a pointer to a grid returned from spatial_hash_init()
+ * @param bodies the list of bodies to file in the grid
+ */
+void spatial_hash_update(spatial_hash_t *hash, list_t *bodies);
+
+/**
+ * Rebuilds the grid from the current bounds of a list of bodies
+ * and calls a function on each pair of bodies whose bounding boxes overlap.
+ * The callback may add bodies to the list; they are ignored until the next search.
+ *
+ * @param hash a pointer to a grid returned from spatial_hash_init()
+ * @param bodies the list of bodies to search
+ * @param callback the function to call on each overlapping pair
+ * @param aux an auxiliary value to pass to callback
+ */
+void spatial_hash_find_pairs(
+    spatial_hash_t *hash,
+    list_t *bodies,
+    pair_callback_t callback,
+    void *aux
+);
+
+/**
+ * Calls a function on each body whose bounding box overlaps a box,
+ * using the grid built by the last search, so each body is checked
+ * with its bounds as of that search.
+ * Bodies added since then are checked with their current bounds.
+ * The callback must not add or remove bodies.
+ *
+ * @param hash a pointer to a grid returned from spatial_hash_init()
+ * @param box the box to look in
+ * @param callback the function to call on each body found
+ * @param aux an auxiliary value to pass to callback
+ */
+void spatial_hash_query(
+    spatial_hash_t *hash,
+    aabb_t box,
+    body_callback_t callback,
+    void *aux
+);
+
+#endif // #ifndef __SPATIAL_HASH_H__
@@ -0,0 +1,92 @@
+#ifndef __SWEEP_AND_PRUNE_H__
+#define __SWEEP_AND_PRUNE_H__
+
+#include "aabb.h"
+#include "body.h"
+#include "broad_phase.h"
+
+/**
+ * An incremental sweep-and-prune broad phase.
+ * Keeps the x-extents of every body's bounding box as a list of endpoints
+ * sorted across searches. Since bodies move only a little between ticks,
+ * insertion sort restores the order in close to linear time,
+ * and a single sweep over the endpoints then finds every overlapping pair,
+ * for a total cost of about O(bodies + overlaps) per search.
+ */
+typedef struct sweep_and_prune sweep_and_prune_t;
+
+/**
+ * Allocates memory for a sweep-and-prune broad phase with no bodies.
+ *
+ * @return a pointer to the newly allocated broad phase
+ */
+sweep_and_prune_t *sweep_and_prune_init(void);
+
+/**
+ * Releases the memory allocated for a broad phase.
+ * Does not free any bodies.
+ *
+ * @param sap a pointer to a broad phase returned from sweep_and_prune_init()
+ */
+void sweep_and_prune_free(sweep_and_prune_t *sap);
+
+/**
+ * Starts tracking a body.
+ * Safe to call from within a pair callback.
+ *
+ * @param sap a pointer to a broad phase returned from sweep_and_prune_init()
+ * @param body the body to track
+ */
+void sweep_and_prune_add(sweep_and_prune_t *sap, body_t *body);
+
+/**
+ * Stops tracking a body.
+ * Asserts that the body is being tracked.
+ *
+ * @param sap a pointer to a broad phase returned from sweep_and_prune_init()
+ * @param body the body to stop tracking
+ */
+void sweep_and_prune_remove(sweep_and_prune_t *sap, body_t *body);
+
+/**
+ * Updates the endpoints from the bodies' current bounds and re-sorts them
+ * without searching for pairs, so that sweep_and_prune_query() finds the
+ * bodies where they are now.
+ *
+ * @param sap a pointer to a broad phase returned from sweep_and_prune_init()
+ */
+void sweep_and_prune_update(sweep_and_prune_t *sap);
+
+/**
+ * Updates the endpoints from the bodies' current bounds, re-sorts them,
+ * and calls a function on each pair of bodies whose bounding boxes overlap.
+ *
+ * @param sap a pointer to a broad phase returned from sweep_and_prune_init()
+ * @param callback the function to call on each overlapping pair
+ * @param aux an auxiliary value to pass to callback
+ */
+void sweep_and_prune_find_pairs(
+    sweep_and_prune_t *sap,
+    pair_callback_t callback,
+    void *aux
+);
+
+/**
+ * Calls a function on each body whose bounding box overlaps a box.
+ * Uses the endpoints as sorted by the last search, so each body is checked
+ * with its bounds as of that search, or as of when it was added if later.
+ * The callback must not add or remove bodies.
+ *
+ * @param sap a pointer to a broad phase returned from sweep_and_prune_init()
+ * @param box the box to look in
+ * @param callback the function to call on each body found
+ * @param aux an auxiliary value to pass to callback
+ */
+void sweep_and_prune_query(
+    sweep_and_prune_t *sap,
+    aabb_t box,
+    body_callback_t callback,
+    void *aux
+);
+
+#endif // #ifndef __SWEEP_AND_PRUNE_H__
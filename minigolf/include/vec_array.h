@@ -0,0 +1,106 @@
+#ifndef __VEC_ARRAY_H__
+#define __VEC_ARRAY_H__
+
+#include <stddef.h>
+#include "list.h"
+#include "vector.h"
+
+/**
+ * A growable array of vectors, stored inline in one contiguous allocation.
+ * Unlike a list_t of vector_t*, reading a vertex does not follow a pointer,
+ * and a polygon of any size is a single allocation,
+ * so it is the preferred way to store polygons.
+ */
+typedef struct vec_array vec_array_t;
+
+/**
+ * Allocates memory for a new array with space for the given number of vectors.
+ * The array is initially empty.
+ * Asserts that the required memory was allocated.
+ *
+ * @param initial_size the number of vectors to allocate space for
+ * @return a pointer to the newly allocated array
+ */
+vec_array_t *vec_array_init(size_t initial_size);
+
+/**
+ * Allocates a new array holding a copy of each vector in a list.
+ *
+ * @param list a list of vector_t*
+ * @return a pointer to the newly allocated array
+ */
+vec_array_t *vec_array_from_list(list_t *list);
+
+/**
+ * Allocates a new array holding a copy of each vector in another array.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ * @return a pointer to the newly allocated array
+ */
+vec_array_t *vec_array_copy(const vec_array_t *array);
+
+/**
+ * Allocates a new list holding a copy of each vector in an array,
+ * for code that still takes polygons as lists.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ * @return a new list of vector_t*, which frees its elements
+ */
+list_t *vec_array_to_list(const vec_array_t *array);
+
+/**
+ * Releases the memory allocated for an array.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ */
+void vec_array_free(vec_array_t *array);
+
+/**
+ * Gets the number of vectors in an array.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ * @return the number of vectors in the array
+ */
+size_t vec_array_size(const vec_array_t *array);
+
+/**
+ * Gets the vector at a given index in an array.
+ * Asserts that the index is valid, given the array's current size.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ * @param index an index in the array (the first vector is at 0)
+ * @return the vector at the given index
+ */
+vector_t vec_array_get(const vec_array_t *array, size_t index);
+
+/**
+ * Replaces the vector at a given index in an array.
+ * Asserts that the index is valid, given the array's current size.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ * @param index an index in the array (the first vector is at 0)
+ * @param value the new vector
+ */
+void vec_array_set(vec_array_t *array, size_t index, vector_t value);
+
+/**
+ * Appends a vector to the end of an array.
+ * If the array is filled to capacity, resizes it to fit more vectors
+ * and asserts that the resize succeeded.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ * @param value the vector to add to the end of the array
+ */
+void vec_array_add(vec_array_t *array, vector_t value);
+
+/**
+ * Gets the array's vectors as a read-only C array, e.g. to loop over them
+ * or to pass them to the SIMD kernels in simd.h.
+ * The pointer is invalidated when the array grows or is freed.
+ *
+ * @param array a pointer to an array returned from vec_array_init()
+ * @return a pointer to the first of vec_array_size() vectors
+ */
+const vector_t *vec_array_data(const vec_array_t *array);
+
+#endif // #ifndef __VEC_ARRAY_H__
@@ -0,0 +1,73 @@
+#include "aabb.h"
+#include <assert.h>
+#include <math.h>
+
+aabb_t aabb_of_polygon(list_t *polygon) {
+    size_t size = list_size(polygon);
+    assert(size != 0);
+
+    vector_t *point = list_get(polygon, 0);
+    aabb_t box = {*point, *point};
+    for (size_t i = 1; i < size; i++) {
+        point = list_get(polygon, i);
+        if (point->x < box.min.x) {
+            box.min.x = point->x;
+        }
+        else if (point->x > box.max.x) {
+            box.max.x = point->x;
+        }
+        if (point->y < box.min.y) {
+            box.min.y = point->y;
+        }
+        else if (point->y > box.max.y) {
+            box.max.y = point->y;
+        }
+    }
+    return box;
+}
+
+aabb_t aabb_of_vec_array(const vec_array_t *polygon) {
+    size_t size = vec_array_size(polygon);
+    assert(size != 0);
+
+    const vector_t *points = vec_array_data(polygon);
+    aabb_t box = {points[0], points[0]};
+    for (size_t i = 1; i < size; i++) {
+        box.min.x = fmin(box.min.x, points[i].x);
+        box.min.y = fmin(box.min.y, points[i].y);
+        box.max.x = fmax(box.max.x, points[i].x);
+        box.max.y = fmax(box.max.y, points[i].y);
+    }
+    return box;
+}
+
+bool aabb_overlap(aabb_t box1, aabb_t box2) {
+    return box1.max.x >= box2.min.x && box2.max.x >= box1.min.x
+        && box1.max.y >= box2.min.y && box2.max.y >= box1.min.y;
+}
+
+aabb_t aabb_union(aabb_t box1, aabb_t box2) {
+    aabb_t box = box1;
+    if (box2.min.x < box.min.x) {
+        box.min.x = box2.min.x;
+    }
+    if (box2.min.y < box.min.y) {
+        box.min.y = box2.min.y;
+    }
+    if (box2.max.x > box.max.x) {
+        box.max.x = box2.max.x;
+    }
+    if (box2.max.y > box.max.y) {
+        box.max.y = box2.max.y;
+    }
+    return box;
+}
+
+bool aabb_contains(aabb_t outer, aabb_t inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y
+        && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+}
+
+double aabb_perimeter(aabb_t box) {
+    return 2 * ((box.max.x - box.min.x) + (box.max.y - box.min.y));
+}
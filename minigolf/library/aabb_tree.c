@@ -0,0 +1,553 @@
+#include "aabb_tree.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+const int NULL_NODE = -1;
+const int TREE_INITIAL = 16;
+const size_t TREE_GROWTH_FACTOR = 2;
+// fat boxes are grown by this fraction of the body's size on every side
+const double FAT_MARGIN = 0.1;
+// and stretched by this many ticks' worth of the body's last displacement
+const double DISPLACEMENT_MULTIPLIER = 4;
+
+/**
+ * A node of the tree. Internal nodes have two children and no body.
+ * Free nodes are chained through parent, and have height -1.
+ */
+typedef struct tree_node {
+    // for a leaf, the fat box; otherwise, the union of the children's boxes
+    aabb_t box;
+    int parent;
+    int child1;
+    int child2;
+    int height;
+    // the remaining fields are only used by leaves
+    body_t *body;
+    aabb_t tight;
+    vector_t displacement;
+    bool is_static;
+    // for a static leaf, its body's centroid and rotation as of the tight box
+    vector_t centroid;
+    double angle;
+} tree_node_t;
+
+typedef struct aabb_tree {
+    tree_node_t *nodes;
+    int capacity;
+    int root;
+    int free_list;
+    // every leaf in the tree
+    int *leaves;
+    size_t leaf_count;
+    size_t leaf_capacity;
+    // scratch space for queries
+    int *stack;
+    size_t stack_capacity;
+    int *hits;
+    size_t hit_capacity;
+    // pairs of static leaves whose fat boxes overlap, stored consecutively
+    int *static_pairs;
+    size_t static_pair_count;
+    size_t static_pair_capacity;
+    bool static_pairs_dirty;
+    // bodies added by a pair callback during the current search
+    list_t *pending;
+    bool searching;
+} aabb_tree_t;
+
+/**
+ * Grows an array of ints so it can hold at least needed elements.
+ */
+int *ensure_tree_capacity(int *array, size_t *capacity, size_t needed) {
+    if (needed <= *capacity) {
+        return array;
+    }
+    size_t new_capacity = *capacity == 0 ? (size_t) TREE_INITIAL : *capacity;
+    while (new_capacity < needed) {
+        new_capacity *= TREE_GROWTH_FACTOR;
+    }
+    array = realloc(array, new_capacity * sizeof(int));
+    assert(array != NULL);
+    *capacity = new_capacity;
+    return array;
+}
+
+/**
+ * Links nodes [start, capacity) into the free list.
+ */
+void link_free_nodes(aabb_tree_t *tree, int start) {
+    for (int i = start; i < tree->capacity; i++) {
+        tree->nodes[i].parent = i + 1 < tree->capacity ? i + 1 : NULL_NODE;
+        tree->nodes[i].height = -1;
+    }
+    tree->free_list = start;
+}
+
+int allocate_node(aabb_tree_t *tree) {
+    if (tree->free_list == NULL_NODE) {
+        int old_capacity = tree->capacity;
+        tree->capacity *= TREE_GROWTH_FACTOR;
+        tree->nodes = realloc(tree->nodes, tree->capacity * sizeof(tree_node_t));
+        assert(tree->nodes != NULL);
+        link_free_nodes(tree, old_capacity);
+    }
+    int node = tree->free_list;
+    tree->free_list = tree->nodes[node].parent;
+    tree->nodes[node].parent = NULL_NODE;
+    tree->nodes[node].child1 = NULL_NODE;
+    tree->nodes[node].child2 = NULL_NODE;
+    tree->nodes[node].height = 0;
+    tree->nodes[node].body = NULL;
+    return node;
+}
+
+void free_node(aabb_tree_t *tree, int node) {
+    tree->nodes[node].parent = tree->free_list;
+    tree->nodes[node].height = -1;
+    tree->free_list = node;
+}
+
+bool is_leaf(aabb_tree_t *tree, int node) {
+    return tree->nodes[node].child1 == NULL_NODE;
+}
+
+int max_height(int height1, int height2) {
+    return height1 > height2 ? height1 : height2;
+}
+
+/**
+ * Replaces child old_child of parent with new_child, or makes new_child
+ * the root if parent is NULL_NODE.
+ */
+void replace_child(aabb_tree_t *tree, int parent, int old_child, int new_child) {
+    if (parent == NULL_NODE) {
+        tree->root = new_child;
+    }
+    else if (tree->nodes[parent].child1 == old_child) {
+        tree->nodes[parent].child1 = new_child;
+    }
+    else {
+        tree->nodes[parent].child2 = new_child;
+    }
+}
+
+/**
+ * Performs a left or right rotation if node a is imbalanced,
+ * as in an AVL tree. Returns the node now at a's position.
+ */
+int balance(aabb_tree_t *tree, int a) {
+    tree_node_t *nodes = tree->nodes;
+    if (is_leaf(tree, a) || nodes[a].height < 2) {
+        return a;
+    }
+
+    int b = nodes[a].child1;
+    int c = nodes[a].child2;
+    int difference = nodes[c].height - nodes[b].height;
+
+    if (difference > 1) {
+        // rotate c up
+        int f = nodes[c].child1;
+        int g = nodes[c].child2;
+        nodes[c].child1 = a;
+        nodes[c].parent = nodes[a].parent;
+        nodes[a].parent = c;
+        replace_child(tree, nodes[c].parent, a, c);
+
+        // keep the taller of c's children under c
+        int taller = nodes[f].height > nodes[g].height ? f : g;
+        int shorter = taller == f ? g : f;
+        nodes[c].child2 = taller;
+        nodes[a].child2 = shorter;
+        nodes[shorter].parent = a;
+        nodes[a].box = aabb_union(nodes[b].box, nodes[shorter].box);
+        nodes[c].box = aabb_union(nodes[a].box, nodes[taller].box);
+        nodes[a].height = 1 + max_height(nodes[b].height, nodes[shorter].height);
+        nodes[c].height = 1 + max_height(nodes[a].height, nodes[taller].height);
+        return c;
+    }
+
+    if (difference < -1) {
+        // rotate b up
+        int d = nodes[b].child1;
+        int e = nodes[b].child2;
+        nodes[b].child1 = a;
+        nodes[b].parent = nodes[a].parent;
+        nodes[a].parent = b;
+        replace_child(tree, nodes[b].parent, a, b);
+
+        int taller = nodes[d].height > nodes[e].height ? d : e;
+        int shorter = taller == d ? e : d;
+        nodes[b].child2 = taller;
+        nodes[a].child1 = shorter;
+        nodes[shorter].parent = a;
+        nodes[a].box = aabb_union(nodes[c].box, nodes[shorter].box);
+        nodes[b].box = aabb_union(nodes[a].box, nodes[taller].box);
+        nodes[a].height = 1 + max_height(nodes[c].height, nodes[shorter].height);
+        nodes[b].height = 1 + max_height(nodes[a].height, nodes[taller].height);
+        return b;
+    }
+
+    return a;
+}
+
+/**
+ * Walks from a node to the root, rebalancing and refitting each ancestor.
+ */
+void refit_ancestors(aabb_tree_t *tree, int node) {
+    while (node != NULL_NODE) {
+        node = balance(tree, node);
+        tree_node_t *nodes = tree->nodes;
+        int child1 = nodes[node].child1;
+        int child2 = nodes[node].child2;
+        nodes[node].height = 1 + max_height(nodes[child1].height, nodes[child2].height);
+        nodes[node].box = aabb_union(nodes[child1].box, nodes[child2].box);
+        node = nodes[node].parent;
+    }
+}
+
+/**
+ * Inserts a leaf, choosing the sibling that least increases the total
+ * perimeter of the tree's boxes (the surface area heuristic).
+ */
+void insert_leaf(aabb_tree_t *tree, int leaf) {
+    if (tree->root == NULL_NODE) {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    tree_node_t *nodes = tree->nodes;
+    aabb_t leaf_box = nodes[leaf].box;
+    int sibling = tree->root;
+    while (!is_leaf(tree, sibling)) {
+        double perimeter = aabb_perimeter(nodes[sibling].box);
+        double combined = aabb_perimeter(aabb_union(nodes[sibling].box, leaf_box));
+        // cost of pairing the leaf with this node
+        double cost = 2 * combined;
+        // extra cost every ancestor pays if the leaf goes further down
+        double inherited = 2 * (combined - perimeter);
+
+        double child_costs[2];
+        int children[2] = {nodes[sibling].child1, nodes[sibling].child2};
+        for (int i = 0; i < 2; i++) {
+            aabb_t child_box = nodes[children[i]].box;
+            double child_combined = aabb_perimeter(aabb_union(child_box, leaf_box));
+            child_costs[i] = is_leaf(tree, children[i])
+                ? child_combined + inherited
+                : child_combined - aabb_perimeter(child_box) + inherited;
+        }
+
+        if (cost < child_costs[0] && cost < child_costs[1]) {
+            break;
+        }
+        sibling = child_costs[0] < child_costs[1] ? children[0] : children[1];
+    }
+
+    int old_parent = nodes[sibling].parent;
+    int new_parent = allocate_node(tree);
+    nodes = tree->nodes;
+    nodes[new_parent].parent = old_parent;
+    nodes[new_parent].box = aabb_union(leaf_box, nodes[sibling].box);
+    nodes[new_parent].height = nodes[sibling].height + 1;
+    nodes[new_parent].child1 = sibling;
+    nodes[new_parent].child2 = leaf;
+    nodes[sibling].parent = new_parent;
+    nodes[leaf].parent = new_parent;
+    replace_child(tree, old_parent, sibling, new_parent);
+
+    refit_ancestors(tree, new_parent);
+}
+
+void remove_leaf(aabb_tree_t *tree, int leaf) {
+    if (leaf == tree->root) {
+        tree->root = NULL_NODE;
+        return;
+    }
+
+    tree_node_t *nodes = tree->nodes;
+    int parent = nodes[leaf].parent;
+    int grandparent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf
+        ? nodes[parent].child2
+        : nodes[parent].child1;
+
+    replace_child(tree, grandparent, parent, sibling);
+    nodes[sibling].parent = grandparent;
+    free_node(tree, parent);
+    refit_ancestors(tree, grandparent);
+}
+
+/**
+ * Computes a leaf's fat box from its tight box and last displacement.
+ */
+aabb_t fatten(aabb_t box, vector_t displacement) {
+    double width = box.max.x - box.min.x;
+    double height = box.max.y - box.min.y;
+    double margin = FAT_MARGIN * (width > height ? width : height);
+    box.min = vec_subtract(box.min, (vector_t) {margin, margin});
+    box.max = vec_add(box.max, (vector_t) {margin, margin});
+
+    vector_t stretch = vec_multiply(DISPLACEMENT_MULTIPLIER, displacement);
+    if (stretch.x < 0) {
+        box.min.x += stretch.x;
+    }
+    else {
+        box.max.x += stretch.x;
+    }
+    if (stretch.y < 0) {
+        box.min.y += stretch.y;
+    }
+    else {
+        box.max.y += stretch.y;
+    }
+    return box;
+}
+
+vector_t box_center(aabb_t box) {
+    return vec_multiply(0.5, vec_add(box.min, box.max));
+}
+
+void insert_body(aabb_tree_t *tree, body_t *body) {
+    int leaf = allocate_node(tree);
+    tree_node_t *node = &tree->nodes[leaf];
+    node->body = body;
+    node->tight = body_get_bounds(body);
+    node->displacement = VEC_ZERO;
+    node->box = fatten(node->tight, VEC_ZERO);
+    node->is_static = !isfinite(body_get_mass(body));
+    node->centroid = body_get_centroid(body);
+    node->angle = body_get_rotation(body);
+    insert_leaf(tree, leaf);
+
+    tree->leaves = ensure_tree_capacity(tree->leaves, &tree->leaf_capacity,
+        tree->leaf_count + 1);
+    tree->leaves[tree->leaf_count++] = leaf;
+    if (tree->nodes[leaf].is_static) {
+        tree->static_pairs_dirty = true;
+    }
+}
+
+aabb_tree_t *aabb_tree_init(void) {
+    aabb_tree_t *tree = malloc(sizeof(aabb_tree_t));
+    assert(tree != NULL);
+    tree->capacity = TREE_INITIAL;
+    tree->nodes = malloc(tree->capacity * sizeof(tree_node_t));
+    assert(tree->nodes != NULL);
+    link_free_nodes(tree, 0);
+    tree->root = NULL_NODE;
+    tree->leaves = NULL;
+    tree->leaf_count = 0;
+    tree->leaf_capacity = 0;
+    tree->stack = NULL;
+    tree->stack_capacity = 0;
+    tree->hits = NULL;
+    tree->hit_capacity = 0;
+    tree->static_pairs = NULL;
+    tree->static_pair_count = 0;
+    tree->static_pair_capacity = 0;
+    tree->static_pairs_dirty = false;
+    tree->pending = list_init(1, null_free);
+    tree->searching = false;
+    return tree;
+}
+
+void aabb_tree_free(aabb_tree_t *tree) {
+    free(tree->nodes);
+    free(tree->leaves);
+    free(tree->stack);
+    free(tree->hits);
+    free(tree->static_pairs);
+    list_free(tree->pending);
+    free(tree);
+}
+
+void aabb_tree_add(aabb_tree_t *tree, body_t *body) {
+    if (tree->searching) {
+        list_add(tree->pending, body);
+    }
+    else {
+        insert_body(tree, body);
+    }
+}
+
+void aabb_tree_remove(aabb_tree_t *tree, body_t *body) {
+    assert(!tree->searching);
+    size_t index = 0;
+    while (index < tree->leaf_count && tree->nodes[tree->leaves[index]].body != body) {
+        index++;
+    }
+    assert(index < tree->leaf_count);
+
+    int leaf = tree->leaves[index];
+    if (tree->nodes[leaf].is_static) {
+        tree->static_pairs_dirty = true;
+    }
+    remove_leaf(tree, leaf);
+    free_node(tree, leaf);
+    tree->leaves[index] = tree->leaves[--tree->leaf_count];
+}
+
+int aabb_tree_height(aabb_tree_t *tree) {
+    return tree->root == NULL_NODE ? -1 : tree->nodes[tree->root].height;
+}
+
+/**
+ * Collects the leaves whose fat boxes overlap a box into tree->hits.
+ * Returns the number of leaves found.
+ */
+size_t query_tree(aabb_tree_t *tree, aabb_t box) {
+    size_t hit_count = 0;
+    size_t stack_size = 0;
+    if (tree->root != NULL_NODE) {
+        tree->stack = ensure_tree_capacity(tree->stack, &tree->stack_capacity, 1);
+        tree->stack[stack_size++] = tree->root;
+    }
+    while (stack_size > 0) {
+        int node = tree->stack[--stack_size];
+        if (!aabb_overlap(tree->nodes[node].box, box)) {
+            continue;
+        }
+        if (is_leaf(tree, node)) {
+            tree->hits = ensure_tree_capacity(tree->hits, &tree->hit_capacity,
+                hit_count + 1);
+            tree->hits[hit_count++] = node;
+        }
+        else {
+            tree->stack = ensure_tree_capacity(tree->stack, &tree->stack_capacity,
+                stack_size + 2);
+            tree->stack[stack_size++] = tree->nodes[node].child1;
+            tree->stack[stack_size++] = tree->nodes[node].child2;
+        }
+    }
+    return hit_count;
+}
+
+/**
+ * Refreshes every leaf's tight box, reinserting the leaves that left
+ * their fat boxes. Static leaves whose bodies have not moved or turned
+ * since their tight boxes were last refreshed are skipped.
+ */
+void update_leaves(aabb_tree_t *tree) {
+    for (size_t i = 0; i < tree->leaf_count; i++) {
+        int leaf = tree->leaves[i];
+        tree_node_t *node = &tree->nodes[leaf];
+        if (node->is_static) {
+            vector_t centroid = body_get_centroid(node->body);
+            double angle = body_get_rotation(node->body);
+            if (centroid.x == node->centroid.x && centroid.y == node->centroid.y
+                && angle == node->angle) {
+                continue;
+            }
+            node->centroid = centroid;
+            node->angle = angle;
+        }
+        aabb_t tight = body_get_bounds(node->body);
+        node->displacement = vec_subtract(box_center(tight), box_center(node->tight));
+        node->tight = tight;
+        if (aabb_contains(node->box, tight)) {
+            continue;
+        }
+
+        remove_leaf(tree, leaf);
+        node = &tree->nodes[leaf];
+        node->box = fatten(tight, node->is_static ? VEC_ZERO : node->displacement);
+        insert_leaf(tree, leaf);
+        if (tree->nodes[leaf].is_static) {
+            tree->static_pairs_dirty = true;
+        }
+    }
+}
+
+/**
+ * Recomputes the pairs of static leaves whose fat boxes overlap.
+ */
+void rebuild_static_pairs(aabb_tree_t *tree) {
+    tree->static_pair_count = 0;
+    for (size_t i = 0; i < tree->leaf_count; i++) {
+        int leaf = tree->leaves[i];
+        if (!tree->nodes[leaf].is_static) {
+            continue;
+        }
+        size_t hit_count = query_tree(tree, tree->nodes[leaf].box);
+        for (size_t h = 0; h < hit_count; h++) {
+            int other = tree->hits[h];
+            if (other > leaf && tree->nodes[other].is_static) {
+                tree->static_pairs = ensure_tree_capacity(tree->static_pairs,
+                    &tree->static_pair_capacity, 2 * tree->static_pair_count + 2);
+                tree->static_pairs[2 * tree->static_pair_count] = leaf;
+                tree->static_pairs[2 * tree->static_pair_count + 1] = other;
+                tree->static_pair_count++;
+            }
+        }
+    }
+    tree->static_pairs_dirty = false;
+}
+
+void aabb_tree_update(aabb_tree_t *tree) {
+    assert(!tree->searching);
+    while (list_size(tree->pending) > 0) {
+        insert_body(tree, list_remove(tree->pending, list_size(tree->pending) - 1));
+    }
+    update_leaves(tree);
+}
+
+void aabb_tree_find_pairs(aabb_tree_t *tree, pair_callback_t callback, void *aux) {
+    aabb_tree_update(tree);
+    if (tree->static_pairs_dirty) {
+        rebuild_static_pairs(tree);
+    }
+
+    tree->searching = true;
+    tree_node_t *nodes = tree->nodes;
+    // static bodies can move within their fat boxes, so check the tight boxes
+    for (size_t p = 0; p < tree->static_pair_count; p++) {
+        tree_node_t *node1 = &nodes[tree->static_pairs[2 * p]];
+        tree_node_t *node2 = &nodes[tree->static_pairs[2 * p + 1]];
+        if (body_can_collide(node1->body, node2->body)
+            && aabb_overlap(node1->tight, node2->tight)) {
+            callback(node1->body, node2->body, aux);
+        }
+    }
+
+    // each movable body finds its static neighbors,
+    // and the movable neighbors that come after it
+    for (size_t i = 0; i < tree->leaf_count; i++) {
+        int leaf = tree->leaves[i];
+        if (nodes[leaf].is_static) {
+            continue;
+        }
+        size_t hit_count = query_tree(tree, nodes[leaf].tight);
+        for (size_t h = 0; h < hit_count; h++) {
+            int other = tree->hits[h];
+            if (other == leaf || (!nodes[other].is_static && other < leaf)) {
+                continue;
+            }
+            if (body_can_collide(nodes[leaf].body, nodes[other].body)
+                && aabb_overlap(nodes[leaf].tight, nodes[other].tight)) {
+                callback(nodes[leaf].body, nodes[other].body, aux);
+            }
+        }
+    }
+    tree->searching = false;
+}
+
+void aabb_tree_query(aabb_tree_t *tree, aabb_t box, body_callback_t callback,
+    void *aux) {
+
+    for (size_t i = 0; i < list_size(tree->pending); i++) {
+        body_t *body = list_get(tree->pending, i);
+        if (aabb_overlap(body_get_bounds(body), box)) {
+            callback(body, aux);
+        }
+    }
+    // a leaf's fat box contains its tight box, so no overlapping leaf is pruned
+    size_t hit_count = query_tree(tree, box);
+    for (size_t h = 0; h < hit_count; h++) {
+        tree_node_t *node = &tree->nodes[tree->hits[h]];
+        if (aabb_overlap(node->tight, box)) {
+            callback(node->body, aux);
+        }
+    }
+}
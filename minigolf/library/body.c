@@ -1,36 +1,470 @@
 #include "body.h"
+#include "decomposition.h"
+#include "shape.h"
+#include "simd.h"
+#include <string.h>
 
-typedef struct body {
-    list_t *shape;
-    double mass;
-    rgb_color_t color;
+/**
+ * One convex piece of a compound body, stored like the body's shape,
+ * with its edge normals, which are recomputed lazily like the body's own.
+ */
+typedef struct body_part {
+    vec_array_t *local;
+    vec_array_t *points;
+    vector_t *normals;
+} body_part_t;
+
+/**
+ * Bits of a body's flags in its store.
+ */
+typedef enum {
+    // body_remove() has been called on the body
+    BODY_REMOVED = 1
+} body_flag_t;
+
+typedef struct body_store {
+    vector_t *centroids;
+    vector_t *velocities;
+    vector_t *forces;
+    vector_t *impulses;
+    vector_t *corrections;
+    // 0 for bodies with mass INFINITY
+    double *inverse_masses;
+    uint8_t *flags;
+    // the body each entry belongs to, to keep its index up to date
+    body_t **bodies;
+    size_t size;
+    size_t capacity;
+} body_store_t;
+
+const size_t BODY_STORE_GROWTH = 2;
+
+/**
+ * The state of a body that is not in a scene, kept inside the body itself.
+ * The body's own store of one (see body_t's loose field) points its arrays
+ * at these fields, so reading the state looks the same in either case.
+ */
+typedef struct body_entry {
     vector_t centroid;
     vector_t velocity;
-    double angle;
     vector_t force;
     vector_t impulse;
+    vector_t correction;
+    double inverse_mass;
+    uint8_t flags;
+    body_t *body;
+} body_entry_t;
+
+/**
+ * A body stores its shape, parts, and capsules once, relative to its centroid
+ * and unrotated, so moving or rotating it only changes its transform
+ * (centroid and angle). Their world-space vertices are cached and only
+ * recomputed when something reads them after the transform has changed.
+ */
+typedef struct body {
+    // where the body's centroid, velocity, etc. are stored:
+    // loose until it is added to a scene, and then the scene's store
+    body_store_t *store;
+    size_t index;
+    // a store holding just this body, which it starts out in
+    body_store_t loose;
+    body_entry_t loose_entry;
+    // the vertices relative to the centroid, possibly shared with other bodies
+    shape_t *local_shape;
+    // the vertices in world space, recomputed lazily after moving,
+    // or NULL until they are first read
+    vec_array_t *shape;
+    bool shape_stale;
+    // the centroid when the world-space vertices were last marked stale,
+    // so that moving the body need not touch it (see body_sync_moved())
+    vector_t marked_centroid;
+    // relative to the centroid, so moving the body leaves it unchanged;
+    // kept up to date by every function that reshapes the body,
+    // except that rotating a body recomputes it lazily
+    aabb_t bounds;
+    bool bounds_stale;
+    bool convex;
+    // radius of the circle the shape approximates, or 0 if it is a polygon
+    double radius;
+    // unit edge normals, recomputed lazily after rotating or reshaping
+    vector_t *edge_normals;
+    size_t normals_capacity;
+    bool normals_stale;
+    // convex pieces the body collides as, or NULL if it collides as its shape
+    body_part_t *parts;
+    size_t part_count;
+    bool parts_stale;
+    bool part_normals_stale;
+    // capsules the body also collides as, stored inline
+    // relative to the centroid and in world space
+    capsule_t *local_capsules;
+    capsule_t *capsules;
+    size_t capsule_count;
+    bool capsules_stale;
+    // whether the body only reports overlaps instead of colliding
+    bool sensor;
+    // small integer the scene dispatches collision handlers on
+    size_t collision_type;
+    // bitfields of the categories the body is in and can collide with
+    uint32_t category;
+    uint32_t mask;
+    double mass;
+    rgb_color_t color;
+    double angle;
     void *info;
     free_func_t info_freer;
-    bool remove;
 } body_t;
 
+/**
+ * Converts a polygon in world space to the body's local space,
+ * i.e. relative to its centroid and undoing its rotation.
+ */
+vec_array_t *body_to_local(body_t *body, const vec_array_t *polygon) {
+    vec_array_t *local = vec_array_copy(polygon);
+    polygon_array_translate(local, vec_negate(body_get_centroid(body)));
+    polygon_array_rotate(local, -body->angle, VEC_ZERO);
+    return local;
+}
+
+/**
+ * Converts a point in the body's local space to world space.
+ */
+vector_t body_to_world(body_t *body, vector_t point) {
+    return vec_add(body_get_centroid(body), vec_rotate(point, body->angle));
+}
+
+/**
+ * Marks every world-space vertex of a body as out of date,
+ * after its transform has changed.
+ */
+void body_mark_moved(body_t *body) {
+    body->shape_stale = true;
+    body->parts_stale = body->part_count > 0;
+    body->capsules_stale = body->capsule_count > 0;
+}
+
+/**
+ * Marks a body's world-space vertices as out of date if the body has moved
+ * since they were last marked. Moving a body only changes its centroid
+ * in its store, so that body_store_tick() need not touch the body itself.
+ */
+void body_sync_moved(body_t *body) {
+    vector_t centroid = body_get_centroid(body);
+    if (centroid.x != body->marked_centroid.x
+        || centroid.y != body->marked_centroid.y) {
+
+        body->marked_centroid = centroid;
+        body_mark_moved(body);
+    }
+}
+
+/**
+ * Recomputes the world-space vertices of a body's shape
+ * if its transform has changed since they were last computed.
+ */
+void body_update_shape(body_t *body) {
+    body_sync_moved(body);
+    if (body->shape_stale) {
+        const vec_array_t *local = shape_get_points(body->local_shape);
+        if (body->shape == NULL) {
+            body->shape = vec_array_copy(local);
+        }
+        polygon_array_transform(local, body->angle, body_get_centroid(body),
+            body->shape);
+        body->shape_stale = false;
+    }
+}
+
+/**
+ * Recomputes the world-space vertices of a body's parts, like
+ * body_update_shape().
+ */
+void body_update_parts(body_t *body) {
+    body_sync_moved(body);
+    if (body->parts_stale) {
+        for (size_t i = 0; i < body->part_count; i++) {
+            polygon_array_transform(body->parts[i].local, body->angle,
+                body_get_centroid(body), body->parts[i].points);
+        }
+        body->parts_stale = false;
+    }
+}
+
+/**
+ * Recomputes the world-space ends of a body's capsules, like
+ * body_update_shape().
+ */
+void body_update_capsules(body_t *body) {
+    body_sync_moved(body);
+    if (body->capsules_stale) {
+        for (size_t i = 0; i < body->capsule_count; i++) {
+            capsule_t local = body->local_capsules[i];
+            body->capsules[i].start = body_to_world(body, local.start);
+            body->capsules[i].end = body_to_world(body, local.end);
+        }
+        body->capsules_stale = false;
+    }
+}
+
+body_store_t *body_store_init(size_t initial_size) {
+    if (initial_size == 0) {
+        initial_size = 1;
+    }
+    body_store_t *store = malloc(sizeof(body_store_t));
+    assert(store != NULL);
+    store->centroids = malloc(initial_size * sizeof(vector_t));
+    store->velocities = malloc(initial_size * sizeof(vector_t));
+    store->forces = malloc(initial_size * sizeof(vector_t));
+    store->impulses = malloc(initial_size * sizeof(vector_t));
+    store->corrections = malloc(initial_size * sizeof(vector_t));
+    store->inverse_masses = malloc(initial_size * sizeof(double));
+    store->flags = malloc(initial_size * sizeof(uint8_t));
+    store->bodies = malloc(initial_size * sizeof(body_t *));
+    assert(store->centroids != NULL && store->velocities != NULL);
+    assert(store->forces != NULL && store->impulses != NULL);
+    assert(store->corrections != NULL && store->inverse_masses != NULL);
+    assert(store->flags != NULL && store->bodies != NULL);
+    store->size = 0;
+    store->capacity = initial_size;
+    return store;
+}
+
+void body_store_free(body_store_t *store) {
+    assert(store->size == 0);
+    free(store->centroids);
+    free(store->velocities);
+    free(store->forces);
+    free(store->impulses);
+    free(store->corrections);
+    free(store->inverse_masses);
+    free(store->flags);
+    free(store->bodies);
+    free(store);
+}
+
+/**
+ * Makes room for one more body at the end of a store's arrays.
+ */
+void body_store_grow(body_store_t *store) {
+    if (store->size < store->capacity) {
+        return;
+    }
+    size_t capacity = BODY_STORE_GROWTH * store->capacity;
+    store->centroids = realloc(store->centroids, capacity * sizeof(vector_t));
+    store->velocities = realloc(store->velocities, capacity * sizeof(vector_t));
+    store->forces = realloc(store->forces, capacity * sizeof(vector_t));
+    store->impulses = realloc(store->impulses, capacity * sizeof(vector_t));
+    store->corrections = realloc(store->corrections, capacity * sizeof(vector_t));
+    store->inverse_masses = realloc(store->inverse_masses,
+        capacity * sizeof(double));
+    store->flags = realloc(store->flags, capacity * sizeof(uint8_t));
+    store->bodies = realloc(store->bodies, capacity * sizeof(body_t *));
+    assert(store->centroids != NULL && store->velocities != NULL);
+    assert(store->forces != NULL && store->impulses != NULL);
+    assert(store->corrections != NULL && store->inverse_masses != NULL);
+    assert(store->flags != NULL && store->bodies != NULL);
+    store->capacity = capacity;
+}
+
+/**
+ * Copies the entry at one index of a store to an index of another
+ * (or the same) store, and points the entry's body at its new place.
+ */
+void body_store_copy_entry(body_store_t *to, size_t to_index,
+    body_store_t *from, size_t from_index) {
+
+    to->centroids[to_index] = from->centroids[from_index];
+    to->velocities[to_index] = from->velocities[from_index];
+    to->forces[to_index] = from->forces[from_index];
+    to->impulses[to_index] = from->impulses[from_index];
+    to->corrections[to_index] = from->corrections[from_index];
+    to->inverse_masses[to_index] = from->inverse_masses[from_index];
+    to->flags[to_index] = from->flags[from_index];
+    body_t *body = from->bodies[from_index];
+    to->bodies[to_index] = body;
+    body->store = to;
+    body->index = to_index;
+}
+
+/**
+ * Removes the entry at an index of a store by moving the last entry into it.
+ */
+void body_store_remove_entry(body_store_t *store, size_t index) {
+    assert(index < store->size);
+    store->size--;
+    if (index != store->size) {
+        body_store_copy_entry(store, index, store, store->size);
+    }
+}
+
+/**
+ * Puts a new body in its own store of one, with the given centroid and mass
+ * and no velocity, forces, impulses or corrections.
+ * The store's arrays point into the body, so nothing is allocated.
+ */
+void body_init_loose(body_t *body, vector_t centroid, double mass) {
+    body_entry_t *entry = &body->loose_entry;
+    *entry = (body_entry_t) {
+        .centroid = centroid,
+        .velocity = VEC_ZERO,
+        .force = VEC_ZERO,
+        .impulse = VEC_ZERO,
+        .correction = VEC_ZERO,
+        .inverse_mass = isfinite(mass) ? 1.0 / mass : 0,
+        .flags = 0,
+        .body = body
+    };
+    body->loose = (body_store_t) {
+        .centroids = &entry->centroid,
+        .velocities = &entry->velocity,
+        .forces = &entry->force,
+        .impulses = &entry->impulse,
+        .corrections = &entry->correction,
+        .inverse_masses = &entry->inverse_mass,
+        .flags = &entry->flags,
+        .bodies = &entry->body,
+        .size = 1,
+        .capacity = 1
+    };
+    body->store = &body->loose;
+    body->index = 0;
+}
+
+void body_store_add(body_store_t *store, body_t *body) {
+    body_store_t *from = body->store;
+    size_t from_index = body->index;
+    if (from == store) {
+        return;
+    }
+    body_store_grow(store);
+    body_store_copy_entry(store, store->size, from, from_index);
+    store->size++;
+    body_store_remove_entry(from, from_index);
+}
+
+size_t body_store_size(body_store_t *store) {
+    return store->size;
+}
+
+void body_store_apply_corrections(body_store_t *store) {
+    for (size_t i = 0; i < store->size; i++) {
+        vector_t correction = store->corrections[i];
+        if (correction.x != 0 || correction.y != 0) {
+            store->centroids[i] = vec_add(store->centroids[i], correction);
+            store->corrections[i] = VEC_ZERO;
+        }
+    }
+}
+
+/**
+ * Integrates the bodies at indices start (inclusive) to end (exclusive)
+ * of a store over a tick, as described by body_tick().
+ * A body with mass INFINITY has an inverse mass of 0,
+ * so it needs no branch: it keeps its velocity and moves at it.
+ */
+void body_store_integrate(body_store_t *store, size_t start, size_t end,
+    double dt) {
+
+    vector_t *centroids = store->centroids;
+    vector_t *velocities = store->velocities;
+    vector_t *forces = store->forces;
+    vector_t *impulses = store->impulses;
+    double *inverse_masses = store->inverse_masses;
+    for (size_t i = start; i < end; i++) {
+        double inverse_mass = inverse_masses[i];
+        vector_t velocity = velocities[i];
+        vector_t total = {
+            inverse_mass * impulses[i].x + dt * (inverse_mass * forces[i].x)
+                + velocity.x,
+            inverse_mass * impulses[i].y + dt * (inverse_mass * forces[i].y)
+                + velocity.y
+        };
+        // move at the average of the velocities before and after the tick
+        vector_t centroid = {
+            centroids[i].x + dt * (0.5 * (total.x + velocity.x)),
+            centroids[i].y + dt * (0.5 * (total.y + velocity.y))
+        };
+        centroids[i] = centroid;
+        velocities[i] = total;
+        forces[i] = (vector_t) {0, 0};
+        impulses[i] = (vector_t) {0, 0};
+    }
+}
+
+void body_store_tick(body_store_t *store, double dt) {
+    body_store_integrate(store, 0, store->size, dt);
+}
+
+/**
+ * Sets a body's bounding box from one in world space.
+ */
+void body_set_bounds(body_t *body, aabb_t bounds) {
+    vector_t centroid = body_get_centroid(body);
+    body->bounds = (aabb_t) {
+        vec_subtract(bounds.min, centroid),
+        vec_subtract(bounds.max, centroid)
+    };
+    body->bounds_stale = false;
+}
+
 body_t *body_init(list_t *shape, double mass, rgb_color_t color) {
+    body_t *body = body_init_with_array(vec_array_from_list(shape), mass, color);
+    list_free(shape);
+    return body;
+}
+
+body_t *body_init_with_array(vec_array_t *shape, double mass,
+    rgb_color_t color) {
+
+    vector_t centroid = polygon_array_centroid(shape);
+    vec_array_t *local = vec_array_copy(shape);
+    polygon_array_translate(local, vec_negate(centroid));
+    body_t *body = body_init_with_shape(shape_init(local), centroid, mass, color,
+        NULL, NULL);
+    // the vertices are already in place, so they need not be recomputed
+    body->shape = shape;
+    body->shape_stale = false;
+    body_set_bounds(body, aabb_of_vec_array(shape));
+    return body;
+}
+
+body_t *body_init_with_shape(shape_t *shape, vector_t centroid, double mass,
+    rgb_color_t color, void *info, free_func_t info_freer) {
+
     body_t *body = malloc(sizeof(body_t));
 
     assert(mass > 0);
     assert(body != NULL);
 
-    body->shape = shape;
+    body_init_loose(body, centroid, mass);
+    body->angle = 0.0;
+    body->local_shape = shape;
+    body->shape = NULL;
+    body->shape_stale = true;
+    body->marked_centroid = centroid;
+    body->bounds = shape_get_bounds(shape);
+    body->bounds_stale = false;
+    body->convex = shape_is_convex(shape);
+    body->radius = 0;
+    body->edge_normals = NULL;
+    body->normals_capacity = 0;
+    body->normals_stale = true;
+    body->parts = NULL;
+    body->part_count = 0;
+    body->parts_stale = false;
+    body->part_normals_stale = false;
+    body->local_capsules = NULL;
+    body->capsules = NULL;
+    body->capsule_count = 0;
+    body->capsules_stale = false;
+    body->sensor = false;
+    body->collision_type = 0;
+    body->category = 1;
+    body->mask = UINT32_MAX;
     body->mass = mass;
     body->color = color;
-    body->centroid = polygon_centroid(shape);
-    body->velocity = VEC_ZERO;
-    body->angle = 0.0;
-    body->force = VEC_ZERO;
-    body->impulse = VEC_ZERO;
-    body->info = NULL;
-    body->info_freer = null_free;
-    body->remove = false;
+    body->info = info;
+    body->info_freer = info_freer != NULL ? info_freer : null_free;
     return body;
 }
 
@@ -59,33 +493,274 @@ body_t *body_init_with_info(list_t *shape, double mass, rgb_color_t color,
     return body;
 }
 
+/**
+ * Releases a body's parts, if it has any.
+ */
+void body_free_parts(body_t *body) {
+    for (size_t i = 0; i < body->part_count; i++) {
+        vec_array_free(body->parts[i].local);
+        vec_array_free(body->parts[i].points);
+        free(body->parts[i].normals);
+    }
+    free(body->parts);
+    body->parts = NULL;
+    body->part_count = 0;
+}
+
 void body_free(body_t *body) {
-    list_free(body->shape);
+    shape_release(body->local_shape);
+    if (body->shape != NULL) {
+        vec_array_free(body->shape);
+    }
+    free(body->edge_normals);
+    body_free_parts(body);
+    free(body->local_capsules);
+    free(body->capsules);
     body->info_freer(body->info);
+    body_store_remove_entry(body->store, body->index);
     free(body);
 }
 
 list_t *body_get_shape(body_t *body) {
-    size_t size = list_size(body->shape);
-    list_t *new_list = list_init(size, free);
-    for (size_t i = 0; i < size; i++) {
-        vector_t v_og = *(vector_t *)list_get(body->shape, i);
-        /* make a deep copy of each vector */
-        vector_t *v_copy = malloc(sizeof(vector_t));
-        assert(v_copy != NULL);
-        v_copy->x = v_og.x;
-        v_copy->y = v_og.y;
-        list_add(new_list, v_copy);
+    return vec_array_to_list(body_peek_shape(body));
+}
+
+vec_array_t *body_get_shape_array(body_t *body) {
+    return vec_array_copy(body_peek_shape(body));
+}
+
+const vec_array_t *body_peek_shape(body_t *body) {
+    body_update_shape(body);
+    return body->shape;
+}
+
+const vec_array_t *body_peek_local_shape(body_t *body) {
+    return shape_get_points(body->local_shape);
+}
+
+/**
+ * Computes the bounding box of a body's shape, treating circles exactly.
+ */
+aabb_t body_shape_bounds(body_t *body) {
+    if (body_is_compound(body)) {
+        body_update_parts(body);
+        body_update_capsules(body);
+        aabb_t bounds = body->part_count > 0
+            ? aabb_of_vec_array(body->parts[0].points)
+            : capsule_bounds(body->capsules[0]);
+        for (size_t i = 1; i < body->part_count; i++) {
+            bounds = aabb_union(bounds, aabb_of_vec_array(body->parts[i].points));
+        }
+        for (size_t i = 0; i < body->capsule_count; i++) {
+            bounds = aabb_union(bounds, capsule_bounds(body->capsules[i]));
+        }
+        return bounds;
+    }
+    if (body->radius > 0) {
+        vector_t extent = {body->radius, body->radius};
+        return (aabb_t) {
+            vec_subtract(body_get_centroid(body), extent),
+            vec_add(body_get_centroid(body), extent)
+        };
+    }
+    body_update_shape(body);
+    aabb_t bounds;
+    simd_bounds(vec_array_data(body->shape), vec_array_size(body->shape),
+        &bounds.min, &bounds.max);
+    return bounds;
+}
+
+/**
+ * Makes a body collide as its shape again instead of as parts.
+ */
+void body_clear_parts(body_t *body) {
+    body_free_parts(body);
+    free(body->local_capsules);
+    free(body->capsules);
+    body->local_capsules = NULL;
+    body->capsules = NULL;
+    body->capsule_count = 0;
+}
+
+void body_set_circle(body_t *body, double radius) {
+    assert(radius > 0);
+    body_clear_parts(body);
+    body->radius = radius;
+    body_set_bounds(body, body_shape_bounds(body));
+}
+
+bool body_is_convex(body_t *body) {
+    return body->convex;
+}
+
+bool body_is_circle(body_t *body) {
+    return body->radius > 0;
+}
+
+double body_get_radius(body_t *body) {
+    return body->radius;
+}
+
+void body_set_parts(body_t *body, list_t *parts) {
+    size_t count = list_size(parts);
+    assert(count > 0);
+    body_free_parts(body);
+    body->parts = malloc(count * sizeof(body_part_t));
+    assert(body->parts != NULL);
+    for (size_t i = 0; i < count; i++) {
+        vec_array_t *points = vec_array_from_list(list_get(parts, i));
+        assert(polygon_array_is_convex(points));
+        body->parts[i].local = body_to_local(body, points);
+        body->parts[i].points = points;
+        body->parts[i].normals = malloc(vec_array_size(points) * sizeof(vector_t));
+        assert(body->parts[i].normals != NULL);
+    }
+    list_free(parts);
+    body->part_count = count;
+    body->parts_stale = false;
+    body->part_normals_stale = true;
+    body->radius = 0;
+    body_set_bounds(body, body_shape_bounds(body));
+}
+
+void body_decompose(body_t *body) {
+    if (!body->convex) {
+        list_t *outline = vec_array_to_list(body_peek_shape(body));
+        body_set_parts(body, polygon_decompose(outline));
+        list_free(outline);
+    }
+}
+
+size_t body_get_part_count(body_t *body) {
+    return body->part_count;
+}
+
+const vec_array_t *body_peek_part(body_t *body, size_t index) {
+    assert(index < body->part_count);
+    body_update_parts(body);
+    return body->parts[index].points;
+}
+
+const vector_t *body_get_part_normals(body_t *body, size_t index) {
+    assert(index < body->part_count);
+    if (body->part_normals_stale) {
+        body_update_parts(body);
+        for (size_t i = 0; i < body->part_count; i++) {
+            polygon_array_edge_normals(body->parts[i].points,
+                body->parts[i].normals);
+        }
+        body->part_normals_stale = false;
+    }
+    return body->parts[index].normals;
+}
+
+void body_set_capsules(body_t *body, const capsule_t *capsules, size_t count) {
+    assert(count > 0);
+    body->local_capsules = realloc(body->local_capsules, count * sizeof(capsule_t));
+    body->capsules = realloc(body->capsules, count * sizeof(capsule_t));
+    assert(body->local_capsules != NULL);
+    assert(body->capsules != NULL);
+    memcpy(body->capsules, capsules, count * sizeof(capsule_t));
+    for (size_t i = 0; i < count; i++) {
+        capsule_t *local = &body->local_capsules[i];
+        *local = capsules[i];
+        local->start = vec_rotate(vec_subtract(local->start, body_get_centroid(body)),
+            -body->angle);
+        local->end = vec_rotate(vec_subtract(local->end, body_get_centroid(body)),
+            -body->angle);
+    }
+    body->capsule_count = count;
+    body->capsules_stale = false;
+    body->radius = 0;
+    body_set_bounds(body, body_shape_bounds(body));
+}
+
+const capsule_t *body_get_capsules(body_t *body) {
+    body_update_capsules(body);
+    return body->capsules;
+}
+
+size_t body_get_capsule_count(body_t *body) {
+    return body->capsule_count;
+}
+
+bool body_is_compound(body_t *body) {
+    return body->part_count > 0 || body->capsule_count > 0;
+}
+
+void body_set_sensor(body_t *body, bool sensor) {
+    body->sensor = sensor;
+}
+
+bool body_is_sensor(body_t *body) {
+    return body->sensor;
+}
+
+void body_set_collision_type(body_t *body, size_t type) {
+    body->collision_type = type;
+}
+
+size_t body_get_collision_type(body_t *body) {
+    return body->collision_type;
+}
+
+void body_set_collision_filter(body_t *body, uint32_t category, uint32_t mask) {
+    body->category = category;
+    body->mask = mask;
+}
+
+uint32_t body_get_collision_category(body_t *body) {
+    return body->category;
+}
+
+uint32_t body_get_collision_mask(body_t *body) {
+    return body->mask;
+}
+
+bool body_can_collide(body_t *body1, body_t *body2) {
+    return (body1->category & body2->mask) && (body2->category & body1->mask);
+}
+
+aabb_t body_get_bounds(body_t *body) {
+    if (body->bounds_stale) {
+        body_set_bounds(body, body_shape_bounds(body));
     }
-    return new_list;
+    vector_t centroid = body_get_centroid(body);
+    return (aabb_t) {
+        vec_add(body->bounds.min, centroid),
+        vec_add(body->bounds.max, centroid)
+    };
+}
+
+vector_t *body_get_edge_normals(body_t *body) {
+    if (body->normals_stale) {
+        body_update_shape(body);
+        size_t size = vec_array_size(body->shape);
+        if (size > body->normals_capacity) {
+            body->edge_normals = realloc(body->edge_normals, size * sizeof(vector_t));
+            assert(body->edge_normals != NULL);
+            body->normals_capacity = size;
+        }
+        polygon_array_edge_normals(body->shape, body->edge_normals);
+        body->normals_stale = false;
+    }
+    return body->edge_normals;
+}
+
+const vector_t *body_get_vertices(body_t *body) {
+    return vec_array_data(body_peek_shape(body));
 }
 
 vector_t body_get_centroid(body_t *body) {
-    return body->centroid;
+    return body->store->centroids[body->index];
+}
+
+double body_get_rotation(body_t *body) {
+    return body->angle;
 }
 
 vector_t body_get_velocity(body_t *body) {
-    return body->velocity;
+    return body->store->velocities[body->index];
 }
 
 double body_get_mass(body_t *body) {
@@ -101,65 +776,96 @@ void *body_get_info(body_t *body) {
 }
 
 void body_set_centroid(body_t *body, vector_t x) {
-    vector_t move = vec_subtract(x, body->centroid);
-    polygon_translate(body->shape, move);
-    body->centroid = x;
+    vector_t *centroid = &body->store->centroids[body->index];
+    if (x.x == centroid->x && x.y == centroid->y) {
+        return;
+    }
+    // the bounding box is relative to the centroid, so it stays the same
+    *centroid = x;
 }
 
 void body_set_velocity(body_t *body, vector_t v) {
-    body->velocity = v;
+    body->store->velocities[body->index] = v;
 }
 
 void body_set_rotation(body_t *body, double angle) {
-    polygon_rotate(body->shape, angle - body->angle, body->centroid);
+    if (angle == body->angle) {
+        return;
+    }
     body->angle = angle;
+    body_mark_moved(body);
+    // a circle's box does not depend on its rotation
+    body->bounds_stale = !body_is_circle(body);
+    body->normals_stale = true;
+    body->part_normals_stale = body->part_count > 0;
 }
 
 void body_add_force(body_t *body, vector_t force) {
-    body->force = vec_add(body->force, force);
+    vector_t *total = &body->store->forces[body->index];
+    *total = vec_add(*total, force);
 }
 
 void body_add_impulse(body_t *body, vector_t impulse) {
-    body->impulse = vec_add(body->impulse, impulse);
+    vector_t *total = &body->store->impulses[body->index];
+    *total = vec_add(*total, impulse);
 }
 
+void body_add_correction(body_t *body, vector_t correction) {
+    vector_t *total = &body->store->corrections[body->index];
+    *total = vec_add(*total, correction);
+}
+
+void body_apply_correction(body_t *body) {
+    vector_t *correction = &body->store->corrections[body->index];
+    if (correction->x != 0 || correction->y != 0) {
+        body_set_centroid(body, vec_add(body_get_centroid(body), *correction));
+        *correction = VEC_ZERO;
+    }
+}
 
-void body_tick(body_t *body, double dt) {
-    vector_t total = body->velocity;
-    if (isfinite(body->mass)) {
-        vector_t acc = vec_multiply(1.0 / body->mass, body->force);
-        vector_t vel_force = vec_multiply(dt, acc);
-        vector_t vel_impulse = vec_multiply(1.0 / body->mass, body->impulse);
 
-        total = vec_add(vec_add(vel_impulse, vel_force), body->velocity);
-        // set velocity to the avg between vel and current velocity
-        vector_t vel_avg = vec_multiply(0.5, vec_add(total, body->velocity));
-        body_set_velocity(body, vel_avg);
+vector_t body_get_next_velocity(body_t *body, double dt) {
+    body_store_t *store = body->store;
+    size_t i = body->index;
+    if (!isfinite(body->mass)) {
+        return store->velocities[i];
     }
-    vector_t dist = vec_multiply(dt, body->velocity);
-    vector_t center = vec_add(body->centroid, dist);
-    body_set_centroid(body, center);
-    body_set_velocity(body, total);
-    body->force = VEC_ZERO;
-    body->impulse = VEC_ZERO;
+    vector_t change = vec_add(store->impulses[i], vec_multiply(dt, store->forces[i]));
+    return vec_add(store->velocities[i], vec_multiply(1.0 / body->mass, change));
+}
+
+void body_tick(body_t *body, double dt) {
+    body_store_integrate(body->store, body->index, body->index + 1, dt);
 }
 
 
 void body_remove(body_t *body) {
-    body->remove = true;
+    body->store->flags[body->index] |= BODY_REMOVED;
 }
 
 
 bool body_is_removed(body_t *body) {
-    if (body->remove) {
-        return true;
-    }
-    return false;
+    return body->store->flags[body->index] & BODY_REMOVED;
 }
 
 void body_set_shape(body_t *body, list_t *shape) {
-  list_free(body->shape);
+  body_set_shape_array(body, vec_array_from_list(shape));
+  list_free(shape);
+}
+
+void body_set_shape_array(body_t *body, vec_array_t *shape) {
+  shape_release(body->local_shape);
+  if (body->shape != NULL) {
+    vec_array_free(body->shape);
+  }
+  body->local_shape = shape_init(body_to_local(body, shape));
   body->shape = shape;
+  body->shape_stale = false;
+  body->convex = polygon_array_is_convex(shape);
+  body->radius = 0;
+  body_clear_parts(body);
+  body->normals_stale = true;
+  body_set_bounds(body, body_shape_bounds(body));
 }
 
 void body_set_color(body_t *body, rgb_color_t color) {
@@ -0,0 +1,136 @@
+#include "broad_phase.h"
+#include "aabb_tree.h"
+#include "spatial_hash.h"
+#include "sweep_and_prune.h"
+#include <assert.h>
+#include <stdlib.h>
+
+typedef struct broad_phase {
+    broad_phase_kind_t kind;
+    // only the structure matching kind is non-NULL
+    spatial_hash_t *grid;
+    sweep_and_prune_t *sap;
+    aabb_tree_t *tree;
+} broad_phase_t;
+
+broad_phase_t *broad_phase_init(broad_phase_kind_t kind) {
+    broad_phase_t *broad_phase = malloc(sizeof(broad_phase_t));
+    assert(broad_phase != NULL);
+    broad_phase->kind = kind;
+    broad_phase->grid = NULL;
+    broad_phase->sap = NULL;
+    broad_phase->tree = NULL;
+    switch (kind) {
+        case BROAD_PHASE_SPATIAL_HASH:
+            broad_phase->grid = spatial_hash_init(0);
+            break;
+        case BROAD_PHASE_SWEEP_AND_PRUNE:
+            broad_phase->sap = sweep_and_prune_init();
+            break;
+        case BROAD_PHASE_AABB_TREE:
+            broad_phase->tree = aabb_tree_init();
+            break;
+    }
+    return broad_phase;
+}
+
+void broad_phase_free(broad_phase_t *broad_phase) {
+    switch (broad_phase->kind) {
+        case BROAD_PHASE_SPATIAL_HASH:
+            spatial_hash_free(broad_phase->grid);
+            break;
+        case BROAD_PHASE_SWEEP_AND_PRUNE:
+            sweep_and_prune_free(broad_phase->sap);
+            break;
+        case BROAD_PHASE_AABB_TREE:
+            aabb_tree_free(broad_phase->tree);
+            break;
+    }
+    free(broad_phase);
+}
+
+broad_phase_kind_t broad_phase_get_kind(broad_phase_t *broad_phase) {
+    return broad_phase->kind;
+}
+
+void broad_phase_add(broad_phase_t *broad_phase, body_t *body) {
+    switch (broad_phase->kind) {
+        case BROAD_PHASE_SPATIAL_HASH:
+            // the grid is rebuilt from the body list on every search,
+            // but queries until then must still find the body
+            spatial_hash_add(broad_phase->grid, body);
+            break;
+        case BROAD_PHASE_SWEEP_AND_PRUNE:
+            sweep_and_prune_add(broad_phase->sap, body);
+            break;
+        case BROAD_PHASE_AABB_TREE:
+            aabb_tree_add(broad_phase->tree, body);
+            break;
+    }
+}
+
+void broad_phase_remove(broad_phase_t *broad_phase, body_t *body) {
+    switch (broad_phase->kind) {
+        case BROAD_PHASE_SPATIAL_HASH:
+            spatial_hash_remove(broad_phase->grid, body);
+            break;
+        case BROAD_PHASE_SWEEP_AND_PRUNE:
+            sweep_and_prune_remove(broad_phase->sap, body);
+            break;
+        case BROAD_PHASE_AABB_TREE:
+            aabb_tree_remove(broad_phase->tree, body);
+            break;
+    }
+}
+
+void broad_phase_set_cell_size(broad_phase_t *broad_phase, double cell_size) {
+    if (broad_phase->kind == BROAD_PHASE_SPATIAL_HASH) {
+        spatial_hash_set_cell_size(broad_phase->grid, cell_size);
+    }
+}
+
+void broad_phase_find_pairs(broad_phase_t *broad_phase, list_t *bodies,
+    pair_callback_t callback, void *aux) {
+
+    switch (broad_phase->kind) {
+        case BROAD_PHASE_SPATIAL_HASH:
+            spatial_hash_find_pairs(broad_phase->grid, bodies, callback, aux);
+            break;
+        case BROAD_PHASE_SWEEP_AND_PRUNE:
+            sweep_and_prune_find_pairs(broad_phase->sap, callback, aux);
+            break;
+        case BROAD_PHASE_AABB_TREE:
+            aabb_tree_find_pairs(broad_phase->tree, callback, aux);
+            break;
+    }
+}
+
+void broad_phase_update(broad_phase_t *broad_phase, list_t *bodies) {
+    switch (broad_phase->kind) {
+        case BROAD_PHASE_SPATIAL_HASH:
+            spatial_hash_update(broad_phase->grid, bodies);
+            break;
+        case BROAD_PHASE_SWEEP_AND_PRUNE:
+            sweep_and_prune_update(broad_phase->sap);
+            break;
+        case BROAD_PHASE_AABB_TREE:
+            aabb_tree_update(broad_phase->tree);
+            break;
+    }
+}
+
+void broad_phase_query(broad_phase_t *broad_phase, aabb_t box,
+    body_callback_t callback, void *aux) {
+
+    switch (broad_phase->kind) {
+        case BROAD_PHASE_SPATIAL_HASH:
+            spatial_hash_query(broad_phase->grid, box, callback, aux);
+            break;
+        case BROAD_PHASE_SWEEP_AND_PRUNE:
+            sweep_and_prune_query(broad_phase->sap, box, callback, aux);
+            break;
+        case BROAD_PHASE_AABB_TREE:
+            aabb_tree_query(broad_phase->tree, box, callback, aux);
+            break;
+    }
+}
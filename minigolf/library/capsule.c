@@ -0,0 +1,121 @@
+#include "capsule.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * Returns how far along a segment the closest point to a point is,
+ * as a fraction of the segment clamped to [0, 1].
+ */
+double segment_fraction(vector_t start, vector_t end, vector_t point) {
+    vector_t along = vec_subtract(end, start);
+    double length_squared = vec_dot(along, along);
+    if (length_squared == 0) {
+        return 0;
+    }
+    double fraction = vec_dot(vec_subtract(point, start), along) / length_squared;
+    return fmin(fmax(fraction, 0), 1);
+}
+
+vector_t capsule_closest_point(capsule_t capsule, vector_t point) {
+    double fraction = segment_fraction(capsule.start, capsule.end, point);
+    return vec_add(capsule.start,
+        vec_multiply(fraction, vec_subtract(capsule.end, capsule.start)));
+}
+
+/**
+ * Returns whether two segments cross, setting crossing to where they do.
+ * Parallel segments never count as crossing.
+ */
+bool segments_cross(capsule_t capsule1, capsule_t capsule2, vector_t *crossing) {
+    vector_t along1 = vec_subtract(capsule1.end, capsule1.start);
+    vector_t along2 = vec_subtract(capsule2.end, capsule2.start);
+    double denominator = vec_cross(along1, along2);
+    if (denominator == 0) {
+        return false;
+    }
+    vector_t offset = vec_subtract(capsule2.start, capsule1.start);
+    double fraction1 = vec_cross(offset, along2) / denominator;
+    double fraction2 = vec_cross(offset, along1) / denominator;
+    if (fraction1 < 0 || fraction1 > 1 || fraction2 < 0 || fraction2 > 1) {
+        return false;
+    }
+    *crossing = vec_add(capsule1.start, vec_multiply(fraction1, along1));
+    return true;
+}
+
+void capsule_closest_points(capsule_t capsule1, capsule_t capsule2,
+    vector_t *point1, vector_t *point2) {
+    vector_t crossing;
+    if (segments_cross(capsule1, capsule2, &crossing)) {
+        *point1 = crossing;
+        *point2 = crossing;
+        return;
+    }
+    // segments that do not cross are closest at an endpoint of one of them
+    vector_t candidates1[] = {
+        capsule1.start,
+        capsule1.end,
+        capsule_closest_point(capsule1, capsule2.start),
+        capsule_closest_point(capsule1, capsule2.end)
+    };
+    vector_t candidates2[] = {
+        capsule_closest_point(capsule2, capsule1.start),
+        capsule_closest_point(capsule2, capsule1.end),
+        capsule2.start,
+        capsule2.end
+    };
+    double min_distance = INFINITY;
+    for (size_t i = 0; i < 4; i++) {
+        vector_t offset = vec_subtract(candidates2[i], candidates1[i]);
+        double distance = vec_dot(offset, offset);
+        if (distance < min_distance) {
+            min_distance = distance;
+            *point1 = candidates1[i];
+            *point2 = candidates2[i];
+        }
+    }
+}
+
+vector_t capsule_project(capsule_t capsule, vector_t axis) {
+    double projection1 = vec_dot(axis, capsule.start);
+    double projection2 = vec_dot(axis, capsule.end);
+    return (vector_t) {
+        fmin(projection1, projection2) - capsule.radius,
+        fmax(projection1, projection2) + capsule.radius
+    };
+}
+
+aabb_t capsule_bounds(capsule_t capsule) {
+    vector_t extent = {capsule.radius, capsule.radius};
+    vector_t min = {
+        fmin(capsule.start.x, capsule.end.x),
+        fmin(capsule.start.y, capsule.end.y)
+    };
+    vector_t max = {
+        fmax(capsule.start.x, capsule.end.x),
+        fmax(capsule.start.y, capsule.end.y)
+    };
+    return (aabb_t) {vec_subtract(min, extent), vec_add(max, extent)};
+}
+
+list_t *capsule_polygon(capsule_t capsule, size_t cap_points) {
+    assert(cap_points >= 2);
+    vector_t along = vec_subtract(capsule.end, capsule.start);
+    double angle = atan2(along.y, along.x);
+    list_t *polygon = list_init(2 * cap_points, free);
+    // sweep half a turn around each end, starting on the right of the segment
+    vector_t ends[] = {capsule.end, capsule.start};
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < cap_points; j++) {
+            double turn = angle - M_PI / 2 + i * M_PI
+                + M_PI * j / (cap_points - 1);
+            vector_t *vertex = malloc(sizeof(vector_t));
+            assert(vertex != NULL);
+            *vertex = vec_add(ends[i], vec_multiply(capsule.radius,
+                (vector_t) {cos(turn), sin(turn)}));
+            list_add(polygon, vertex);
+        }
+    }
+    return polygon;
+}
@@ -1,95 +1,60 @@
 #include "collision.h"
+#include "aabb.h"
+#include "capsule.h"
+#include "gjk.h"
 #include "list.h"
 #include "vector.h"
 #include "polygon.h"
+#include "simd.h"
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 
-double max(double d1, double d2) {
-  return d1 > d2 ? d1 : d2;
-}
+// under NARROW_PHASE_AUTO, pairs of polygons with at least this many vertices
+// between them use GJK, whose cost grows linearly rather than quadratically
+const size_t GJK_MIN_VERTICES = 16;
+// a capsule whose segment is within this fraction of perpendicular to the
+// collision axis is treated as lying flat against the other shape
+const double CAPSULE_FLAT_TOLERANCE = 1e-6;
 
-double min(double d1, double d2) {
-  return d1 < d2 ? d1 : d2;
-}
+collision_stats_t collision_stats = {0, 0};
+narrow_phase_kind_t narrow_phase = NARROW_PHASE_AUTO;
 
 /**
- * Takes in a list of vector_ts and returns either the top right or the bottom
- * left bounding corner based on whether comparison_func is either min or max
+ * A polygon to project onto axes, along with whether it is convex.
+ * Convex polygons can be projected in logarithmic time.
+ * The points are stored contiguously, so the SIMD kernel can project
+ * several at a time.
  */
-vector_t bounding_corner(list_t *shape, double (*comparison_func) (double, double)) {
-  size_t size = list_size(shape);
-  assert(size != 0);
-  vector_t *point = (vector_t *) list_get(shape, 0);
-  double x = point->x;
-  double y = point->y;
-  for (size_t i = 1; i < size; i++) {
-    point = (vector_t *) list_get(shape, i);
-    x = comparison_func(point->x, x);
-    y = comparison_func(point->y, y);
-  }
-  return (vector_t) {x, y};
-}
+typedef struct projectable {
+  const vec_array_t *points;
+  bool convex;
+} projectable_t;
 
 /**
  * Takes in two shapes and returns whether the bounding box intersects
  */
-bool bounding_box_intersect(list_t *shape1, list_t *shape2) {
-  vector_t bottom_left1 = bounding_corner(shape1, min);
-  vector_t bottom_left2 = bounding_corner(shape2, min);
-  vector_t top_right1 = bounding_corner(shape1, max);
-  vector_t top_right2 = bounding_corner(shape2, max);
-  bool xs_overlap =
-    top_right1.x >= bottom_left2.x && top_right2.x >= bottom_left1.x;
-  bool ys_overlap =
-    top_right1.y >= bottom_left2.y && top_right2.y >= bottom_left1.y;
-
-  return xs_overlap && ys_overlap;
+bool bounding_box_intersect(const vec_array_t *shape1,
+  const vec_array_t *shape2) {
+  return aabb_overlap(aabb_of_vec_array(shape1), aabb_of_vec_array(shape2));
 }
 
 /**
- * Takes two vector_ts and returns a unit vector_t pointing in the direction
- * of the line formed by connecting the two vertices
+ * Takes a shape and a unit vector_t axis, and projects each point in the
+ * shape onto the axis, then returns the minimum and maximum values produced
+ * as a vector_t of form {min, max}.
+ * Shapes are projected with the SIMD kernel (see simd_project()),
+ * except for large convex shapes, which are projected by binary search
+ * (see polygon_array_project_convex()).
  */
-vector_t make_unit_vector(vector_t v1, vector_t v2) {
-  vector_t direction = vec_subtract(v2, v1);
-  double magnitude = vec_distance(v1, v2);
-  vector_t unit_vector = vec_multiply(1.0 / magnitude, direction);
-  return unit_vector;
-}
-
-vector_t get_perpendicular(vector_t v, vector_t centroid1, vector_t centroid2) {
-  vector_t unit = make_unit_vector(centroid1, centroid2);
-  vector_t perpendicular = (vector_t) {-v.y / sqrt(v.x * v.x + v.y * v.y),
-    v.x / sqrt(v.x * v.x + v.y * v.y)};
-  if (vec_dot(unit, perpendicular) > 0) {
-    return perpendicular;
+vector_t project_shape(projectable_t shape, vector_t axis) {
+  size_t size = vec_array_size(shape.points);
+  // small polygons are projected with the SIMD kernel
+  if (shape.convex && size >= BINARY_PROJECTION_MIN_VERTICES) {
+    return polygon_array_project_convex(shape.points, axis);
   }
-  return vec_multiply(-1, perpendicular);
-}
-
-/**
- * Takes a list_t of vector_ts representing a shape, and two vector_ts,
- * and projects each point in the shape onto the line created by the two
- * vectors, then returns the minimum and maximum values produced as a vector_t
- * of form {min, max}.
- */
-vector_t project_shape(list_t *shape, vector_t min_point, vector_t max_point, vector_t centroid1, vector_t centroid2) {
-  vector_t unit_vector = get_perpendicular(make_unit_vector(min_point, max_point), centroid1, centroid2);
-  size_t size = list_size(shape);
-  assert(size > 0);
-  vector_t *point = (vector_t *) list_get(shape, 0);
-  double min_projection = vec_dot(unit_vector, *point);
-  double max_projection = vec_dot(unit_vector, *point);
-
-  for (size_t i = 1; i < size; i++) {
-    point = (vector_t *) list_get(shape, i);
-    double projection = vec_dot(unit_vector, *point);
-    min_projection = min(min_projection, projection);
-    max_projection = max(max_projection, projection);
-  }
-  return (vector_t) {min_projection, max_projection};
+  return simd_project(vec_array_data(shape.points), size, axis);
 }
 
 double overlap(vector_t projection1, vector_t projection2) {
@@ -119,54 +84,1275 @@ double overlap(vector_t projection1, vector_t projection2) {
 }
 
 /**
- * Takes two list_ts of vector_ts shape1 and shape2, and returns a
- * collision_info_t that indicates whether the shapes are colliding
- * and along what axis
+ * Gets the unit normal of edge i of a shape (see polygon_array_edge_normals())
+ * from normals, or computes it from the shape's vertices if normals is NULL,
+ * so that shapes without cached normals need no array to hold them.
+ */
+vector_t shape_edge_normal(projectable_t shape, const vector_t *normals,
+  size_t i) {
+  if (normals != NULL) {
+    return normals[i];
+  }
+  const vector_t *points = vec_array_data(shape.points);
+  size_t size = vec_array_size(shape.points);
+  vector_t edge = vec_subtract(points[(i + 1) % size], points[i]);
+  double magnitude = sqrt(vec_dot(edge, edge));
+  return (vector_t) {-edge.y / magnitude, edge.x / magnitude};
+}
+
+/**
+ * Projects both shapes onto an axis. Returns false if the axis separates
+ * the shapes, storing it in min_axis. Otherwise, keeps track of the axis with
+ * the least overlap in min_overlap and min_axis, and returns true.
  */
-collision_info_t all_projections_overlapping(list_t *shape1, list_t *shape2) {
-  size_t size1 = list_size(shape1);
+bool axis_overlapping(projectable_t shape1, projectable_t shape2,
+  vector_t axis, double *min_overlap, vector_t *min_axis) {
+  vector_t projection1 = project_shape(shape1, axis);
+  vector_t projection2 = project_shape(shape2, axis);
+
+  if (projection1.y < projection2.x || projection2.y < projection1.x) {
+    *min_axis = axis;
+    return false;
+  }
+  double overlap_amt = overlap(projection1, projection2);
+  if (*min_overlap == 0 || overlap_amt < *min_overlap) {
+    *min_overlap = overlap_amt;
+    *min_axis = axis;
+  }
+  return true;
+}
+
+/**
+ * Projects both shapes onto each edge normal of edges, which is one of them
+ * (see shape_edge_normal()). Returns false as soon as an axis separates the
+ * shapes, and otherwise keeps track of the axis with the least overlap,
+ * like axis_overlapping().
+ */
+bool edges_overlapping(projectable_t shape1, projectable_t shape2,
+  projectable_t edges, const vector_t *normals, double *min_overlap,
+  vector_t *min_axis) {
+  size_t size = vec_array_size(edges.points);
+  for (size_t i = 0; i < size; i++) {
+    if (!axis_overlapping(shape1, shape2, shape_edge_normal(edges, normals, i),
+          min_overlap, min_axis)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Points a collision axis from the first shape's centroid towards the second's.
+ */
+vector_t orient_axis(vector_t axis, vector_t centroid1, vector_t centroid2) {
+  if (vec_dot(axis, vec_subtract(centroid2, centroid1)) <= 0) {
+    return vec_negate(axis);
+  }
+  return axis;
+}
+
+/**
+ * Returns whether a cached axis separates two shapes, recording the attempt
+ * in the axis cache statistics. Any separating axis proves the shapes are
+ * apart, even if it is no longer one of their edge normals.
+ */
+bool cached_axis_separates(projectable_t shape1, projectable_t shape2,
+  vector_t *axis_cache) {
+  if (axis_cache == NULL || (axis_cache->x == 0 && axis_cache->y == 0)) {
+    return false;
+  }
+  collision_stats.axis_cache_tests++;
   double min_overlap = 0;
   vector_t axis = VEC_ZERO;
+  if (!axis_overlapping(shape1, shape2, *axis_cache, &min_overlap, &axis)) {
+    collision_stats.axis_cache_hits++;
+    return true;
+  }
+  return false;
+}
 
-  vector_t centroid1 = polygon_centroid(shape1);
-  vector_t centroid2 = polygon_centroid(shape2);
-  for (size_t i = 0; i < size1; i++) {
-    vector_t *point1 = (vector_t *) list_get(shape1, i % size1);
-    vector_t *point2 = (vector_t *) list_get(shape1, (i + 1) % size1);
-    vector_t projection1 = project_shape(shape1, *point1, *point2, centroid1, centroid2);
-    vector_t projection2 = project_shape(shape2, *point1, *point2, centroid1, centroid2);
+/**
+ * Runs the separating axis test on two shapes, given the unit normals of
+ * each shape's edges, or NULL to compute them (see shape_edge_normal()),
+ * and the shapes' centroids, and returns a collision_info_t that indicates
+ * whether the shapes are colliding and along what axis.
+ * If axis_cache is not NULL, it is set to the separating axis or the axis of
+ * least overlap.
+ */
+collision_info_t separating_axis_collision(projectable_t shape1,
+  const vector_t *normals1, vector_t centroid1, projectable_t shape2,
+  const vector_t *normals2, vector_t centroid2,
+  vector_t *axis_cache) {
+  double min_overlap = 0;
+  vector_t axis = VEC_ZERO;
+  bool collided = edges_overlapping(shape1, shape2, shape1, normals1,
+      &min_overlap, &axis)
+    && edges_overlapping(shape1, shape2, shape2, normals2,
+      &min_overlap, &axis);
+  if (axis_cache != NULL) {
+    *axis_cache = axis;
+  }
+  if (!collided) {
+    return (collision_info_t) {false, VEC_ZERO};
+  }
+  return (collision_info_t) {true, orient_axis(axis, centroid1, centroid2)};
+}
 
-    double overlap_amt = overlap(projection1, projection2);
-    if (projection1.y < projection2.x || projection2.y < projection1.x) {
-      return (collision_info_t) {false, axis};
-    } else if (min_overlap == 0 || overlap_amt < min_overlap) {
-      min_overlap = overlap_amt;
-      axis = get_perpendicular(make_unit_vector(*point1, *point2), centroid1, centroid2);
+/**
+ * Projects a circle and a shape onto an axis. Returns false if the axis
+ * separates them, storing it in min_axis. Otherwise, keeps track of the axis
+ * with the least overlap in min_overlap and min_axis, and returns true.
+ */
+bool circle_axis_overlapping(vector_t center, double radius, projectable_t shape,
+  vector_t axis, double *min_overlap, vector_t *min_axis) {
+  double projected_center = vec_dot(axis, center);
+  vector_t projection1 = {projected_center - radius, projected_center + radius};
+  vector_t projection2 = project_shape(shape, axis);
+
+  if (projection1.y < projection2.x || projection2.y < projection1.x) {
+    *min_axis = axis;
+    return false;
+  }
+  double overlap_amt = overlap(projection1, projection2);
+  if (*min_overlap == 0 || overlap_amt < *min_overlap) {
+    *min_overlap = overlap_amt;
+    *min_axis = axis;
+  }
+  return true;
+}
+
+/**
+ * Projects a circle and a polygon onto the polygon's edge normals and the axis
+ * through the vertex nearest the circle's center. Returns false as soon as an
+ * axis separates them, storing that axis in min_axis. Otherwise, keeps track
+ * of the axis with the least overlap in min_overlap and min_axis.
+ */
+bool circle_polygon_overlapping(vector_t center, double radius,
+  projectable_t shape, const vector_t *normals, double *min_overlap,
+  vector_t *min_axis) {
+  const vector_t *points = vec_array_data(shape.points);
+  size_t size = vec_array_size(shape.points);
+  for (size_t i = 0; i < size; i++) {
+    if (!circle_axis_overlapping(center, radius, shape,
+          shape_edge_normal(shape, normals, i), min_overlap, min_axis)) {
+      return false;
     }
   }
 
-  size_t size2 = list_size(shape2);
-  for (size_t i = 0; i < size2; i++) {
-    vector_t *point1 = (vector_t *) list_get(shape2, i % size2);
-    vector_t *point2 = (vector_t *) list_get(shape2, (i + 1) % size2);
-    vector_t projection1 = project_shape(shape1, *point1, *point2, centroid1, centroid2);
-    vector_t projection2 = project_shape(shape2, *point1, *point2, centroid1, centroid2);
+  vector_t nearest = VEC_ZERO;
+  double nearest_distance = INFINITY;
+  for (size_t i = 0; i < size; i++) {
+    vector_t offset = vec_subtract(points[i], center);
+    double distance = vec_dot(offset, offset);
+    if (distance < nearest_distance) {
+      nearest = offset;
+      nearest_distance = distance;
+    }
+  }
+  // if the center is on a vertex, the edge normals have already decided
+  if (nearest_distance > 0) {
+    vector_t vertex_axis = vec_multiply(1 / sqrt(nearest_distance), nearest);
+    return circle_axis_overlapping(center, radius, shape, vertex_axis,
+      min_overlap, min_axis);
+  }
+  return true;
+}
 
-    double overlap_amt = overlap(projection1, projection2);
+/**
+ * Runs the separating axis test on a circle and a polygon, given the unit
+ * normals of the polygon's edges, or NULL to compute them
+ * (see shape_edge_normal()), and its centroid.
+ * The returned axis points from the circle towards the polygon.
+ * If axis_cache is not NULL, the axis it holds is tried first, and it is
+ * replaced by the separating axis or the axis of least overlap.
+ */
+collision_info_t circle_polygon_collision(vector_t center, double radius,
+  projectable_t shape, const vector_t *normals, vector_t centroid, vector_t *axis_cache) {
+  double min_overlap = 0;
+  vector_t axis = VEC_ZERO;
+  if (axis_cache != NULL && (axis_cache->x != 0 || axis_cache->y != 0)) {
+    collision_stats.axis_cache_tests++;
+    if (!circle_axis_overlapping(center, radius, shape, *axis_cache,
+          &min_overlap, &axis)) {
+      collision_stats.axis_cache_hits++;
+      return (collision_info_t) {false, VEC_ZERO};
+    }
+    // the cached axis may not be a candidate axis anymore, so forget it
+    min_overlap = 0;
+    axis = VEC_ZERO;
+  }
+  bool collided = circle_polygon_overlapping(center, radius, shape, normals,
+    &min_overlap, &axis);
+  if (axis_cache != NULL) {
+    *axis_cache = axis;
+  }
+  if (!collided) {
+    return (collision_info_t) {false, VEC_ZERO};
+  }
+  return (collision_info_t) {true, orient_axis(axis, center, centroid)};
+}
+
+collision_info_t find_circle_collision(vector_t center1, double radius1,
+  vector_t center2, double radius2) {
+  vector_t offset = vec_subtract(center2, center1);
+  double distance_squared = vec_dot(offset, offset);
+  double radii = radius1 + radius2;
+  if (distance_squared > radii * radii) {
+    return (collision_info_t) {false, VEC_ZERO};
+  }
+  if (distance_squared == 0) {
+    // concentric circles have no preferred axis
+    return (collision_info_t) {true, (vector_t) {0, 1}};
+  }
+  return (collision_info_t) {
+    true,
+    vec_multiply(1 / sqrt(distance_squared), offset)
+  };
+}
+
+collision_info_t find_circle_polygon_collision(vector_t center, double radius,
+  list_t *shape) {
+  vec_array_t *array = vec_array_from_list(shape);
+  collision_info_t info =
+    find_circle_polygon_collision_array(center, radius, array);
+  vec_array_free(array);
+  return info;
+}
+
+collision_info_t find_circle_polygon_collision_array(vector_t center,
+  double radius, const vec_array_t *shape) {
+  aabb_t circle_bounds = {
+    {center.x - radius, center.y - radius},
+    {center.x + radius, center.y + radius}
+  };
+  if (!aabb_overlap(circle_bounds, aabb_of_vec_array(shape))) {
+    return (collision_info_t) {false, VEC_ZERO};
+  }
+  projectable_t polygon = {shape, polygon_array_is_convex(shape)};
+  return circle_polygon_collision(center, radius, polygon, NULL,
+    polygon_array_centroid(shape), NULL);
+}
+
+collision_info_t find_capsule_collision(capsule_t capsule1, capsule_t capsule2) {
+  vector_t point1, point2;
+  capsule_closest_points(capsule1, capsule2, &point1, &point2);
+  collision_info_t info = find_circle_collision(point1, capsule1.radius,
+    point2, capsule2.radius);
+  if (info.collided && point1.x == point2.x && point1.y == point2.y) {
+    // crossing segments have no closest points to separate,
+    // so push the capsules apart along the line between their middles
+    vector_t middle1 = vec_multiply(0.5, vec_add(capsule1.start, capsule1.end));
+    vector_t middle2 = vec_multiply(0.5, vec_add(capsule2.start, capsule2.end));
+    vector_t offset = vec_subtract(middle2, middle1);
+    double distance = sqrt(vec_dot(offset, offset));
+    if (distance > 0) {
+      info.axis = vec_multiply(1 / distance, offset);
+    }
+  }
+  return info;
+}
+
+collision_info_t find_circle_capsule_collision(vector_t center, double radius,
+  capsule_t capsule) {
+  return find_capsule_collision((capsule_t) {center, center, radius}, capsule);
+}
+
+/**
+ * Runs the separating axis test on a capsule and a polygon, given the unit
+ * normals of the polygon's edges, or NULL to compute them
+ * (see shape_edge_normal()), and its centroid. Besides the edge normals,
+ * the candidate axes are the normal of the capsule's segment and the axes
+ * from each end of the segment to the polygon's nearest vertex.
+ * The returned axis points from the capsule towards the polygon.
+ */
+collision_info_t capsule_polygon_collision(capsule_t capsule,
+  projectable_t shape, const vector_t *normals, vector_t centroid) {
+  const vector_t *points = vec_array_data(shape.points);
+  size_t size = vec_array_size(shape.points);
+  vector_t axes[3];
+  size_t axis_count = 0;
+  vector_t along = vec_subtract(capsule.end, capsule.start);
+  double length = sqrt(vec_dot(along, along));
+  if (length > 0) {
+    axes[axis_count++] = (vector_t) {-along.y / length, along.x / length};
+  }
+  vector_t ends[] = {capsule.start, capsule.end};
+  for (size_t i = 0; i < (length > 0 ? 2 : 1); i++) {
+    vector_t nearest = VEC_ZERO;
+    double nearest_distance = INFINITY;
+    for (size_t j = 0; j < size; j++) {
+      vector_t offset = vec_subtract(points[j], ends[i]);
+      double distance = vec_dot(offset, offset);
+      if (distance < nearest_distance) {
+        nearest = offset;
+        nearest_distance = distance;
+      }
+    }
+    if (nearest_distance > 0) {
+      axes[axis_count++] = vec_multiply(1 / sqrt(nearest_distance), nearest);
+    }
+  }
+
+  double min_overlap = INFINITY;
+  vector_t min_axis = VEC_ZERO;
+  for (size_t i = 0; i < size + axis_count; i++) {
+    vector_t axis = i < size ? shape_edge_normal(shape, normals, i)
+      : axes[i - size];
+    vector_t projection1 = capsule_project(capsule, axis);
+    vector_t projection2 = project_shape(shape, axis);
     if (projection1.y < projection2.x || projection2.y < projection1.x) {
-      return (collision_info_t) {false, axis};
-    } else if (min_overlap == 0 || overlap_amt < min_overlap) {
+      return (collision_info_t) {false, VEC_ZERO};
+    }
+    double overlap_amt = overlap(projection1, projection2);
+    if (overlap_amt < min_overlap) {
       min_overlap = overlap_amt;
-      axis = get_perpendicular(make_unit_vector(*point1, *point2), centroid1, centroid2);
+      min_axis = axis;
     }
   }
-  return (collision_info_t) {true, axis};
+  vector_t middle = vec_multiply(0.5, vec_add(capsule.start, capsule.end));
+  return (collision_info_t) {true, orient_axis(min_axis, middle, centroid)};
+}
+
+collision_info_t find_polygon_capsule_collision(list_t *shape,
+  capsule_t capsule) {
+  vec_array_t *array = vec_array_from_list(shape);
+  collision_info_t info = find_polygon_capsule_collision_array(array, capsule);
+  vec_array_free(array);
+  return info;
+}
+
+collision_info_t find_polygon_capsule_collision_array(const vec_array_t *shape,
+  capsule_t capsule) {
+  if (!aabb_overlap(capsule_bounds(capsule), aabb_of_vec_array(shape))) {
+    return (collision_info_t) {false, VEC_ZERO};
+  }
+  projectable_t polygon = {shape, polygon_array_is_convex(shape)};
+  collision_info_t info = capsule_polygon_collision(capsule, polygon, NULL,
+    polygon_array_centroid(shape));
+  info.axis = vec_negate(info.axis);
+  return info;
+}
+
+/**
+ * Returns whether a pair of polygons with a given number of vertices between
+ * them should be tested with GJK rather than the separating axis test,
+ * according to the selected narrow phase.
+ * GJK also requires both polygons to be convex, which callers must check.
+ */
+bool use_gjk(size_t vertices) {
+  switch (narrow_phase) {
+    case NARROW_PHASE_SAT:
+      return false;
+    case NARROW_PHASE_GJK:
+      return true;
+    default:
+      return vertices >= GJK_MIN_VERTICES;
+  }
 }
 
+/**
+ * Runs GJK and EPA on two shapes (see gjk_intersect_array()) and stores the result
+ * in info, with the axis pointing from the first centroid towards the second.
+ * If axis_cache is not NULL, it is set to the separating or penetration axis.
+ * Returns false if GJK could not decide, in which case the separating axis
+ * test should be used instead.
+ */
+bool gjk_collision(const vec_array_t *shape1, vector_t centroid1,
+  const vec_array_t *shape2, vector_t centroid2, vector_t *axis_cache,
+  collision_info_t *info) {
+  vector_t axis;
+  bool collided = gjk_intersect_array(shape1, shape2, &axis);
+  if (axis.x == 0 && axis.y == 0) {
+    return false;
+  }
+  if (axis_cache != NULL) {
+    *axis_cache = axis;
+  }
+  if (!collided) {
+    *info = (collision_info_t) {false, VEC_ZERO};
+  }
+  else {
+    *info = (collision_info_t) {true, orient_axis(axis, centroid1, centroid2)};
+  }
+  return true;
+}
+
+/**
+ * One of two colliding shapes, for describing how they overlap:
+ * a polygon, or if radius is positive, a capsule whose segment runs from
+ * center - half_axis to center + half_axis (a circle if half_axis is zero).
+ */
+typedef struct contact_shape {
+  projectable_t polygon;
+  vector_t center;
+  double radius;
+  vector_t half_axis;
+} contact_shape_t;
+
+/**
+ * Returns whether a contact shape is a capsule with a segment of some length.
+ */
+bool is_capsule(contact_shape_t shape) {
+  return shape.radius > 0 && (shape.half_axis.x != 0 || shape.half_axis.y != 0);
+}
+
+/**
+ * Gets the capsule a round contact shape describes.
+ */
+capsule_t contact_capsule(contact_shape_t shape) {
+  return (capsule_t) {
+    vec_subtract(shape.center, shape.half_axis),
+    vec_add(shape.center, shape.half_axis),
+    shape.radius
+  };
+}
+
+/**
+ * Finds the point on a round contact shape's segment that reaches furthest
+ * in a direction. A capsule lying flat across the direction touches along its
+ * length, so its middle is used.
+ */
+vector_t contact_core(contact_shape_t shape, vector_t direction) {
+  double along = vec_dot(shape.half_axis, direction);
+  double length = sqrt(vec_dot(shape.half_axis, shape.half_axis));
+  if (fabs(along) <= CAPSULE_FLAT_TOLERANCE * length) {
+    return shape.center;
+  }
+  return along > 0
+    ? vec_add(shape.center, shape.half_axis)
+    : vec_subtract(shape.center, shape.half_axis);
+}
+
+/**
+ * An edge of a polygon, along with its vertex furthest in some direction.
+ */
+typedef struct contact_edge {
+  vector_t start;
+  vector_t end;
+  vector_t deepest;
+} contact_edge_t;
+
+/**
+ * Projects a polygon, circle, or capsule onto a unit axis,
+ * like project_shape().
+ */
+vector_t project_contact_shape(contact_shape_t shape, vector_t axis) {
+  if (shape.radius > 0) {
+    double projected_center = vec_dot(axis, shape.center);
+    double extent = fabs(vec_dot(axis, shape.half_axis)) + shape.radius;
+    return (vector_t) {projected_center - extent, projected_center + extent};
+  }
+  return project_shape(shape.polygon, axis);
+}
+
+/**
+ * Finds the edge of a polygon that faces a direction most squarely:
+ * whichever edge next to the vertex furthest in that direction is closest
+ * to perpendicular to it.
+ */
+contact_edge_t facing_edge(const vec_array_t *shape, vector_t direction) {
+  const vector_t *points = vec_array_data(shape);
+  size_t size = vec_array_size(shape);
+  size_t deepest = 0;
+  double max_projection = -INFINITY;
+  for (size_t i = 0; i < size; i++) {
+    double projection = vec_dot(direction, points[i]);
+    if (projection > max_projection) {
+      deepest = i;
+      max_projection = projection;
+    }
+  }
+
+  vector_t vertex = points[deepest];
+  vector_t previous = points[(deepest + size - 1) % size];
+  vector_t next = points[(deepest + 1) % size];
+  vector_t to_previous = vec_subtract(vertex, previous);
+  vector_t to_next = vec_subtract(next, vertex);
+  // compare |cos| of each edge's angle to the direction without square roots
+  double previous_dot = vec_dot(to_previous, direction);
+  double next_dot = vec_dot(to_next, direction);
+  if (previous_dot * previous_dot * vec_dot(to_next, to_next)
+      <= next_dot * next_dot * vec_dot(to_previous, to_previous)) {
+    return (contact_edge_t) {previous, vertex, vertex};
+  }
+  return (contact_edge_t) {vertex, next, vertex};
+}
+
+/**
+ * Clips a segment of up to two points, keeping the part where the projection
+ * onto direction is at least offset. Returns the number of points kept.
+ */
+size_t clip_segment(vector_t *points, size_t count, vector_t direction,
+  double offset) {
+  assert(count == 2);
+  double distance1 = vec_dot(direction, points[0]) - offset;
+  double distance2 = vec_dot(direction, points[1]) - offset;
+  vector_t clipped[2];
+  size_t kept = 0;
+  if (distance1 >= 0) {
+    clipped[kept++] = points[0];
+  }
+  if (distance2 >= 0) {
+    clipped[kept++] = points[1];
+  }
+  if (distance1 * distance2 < 0) {
+    double fraction = distance1 / (distance1 - distance2);
+    clipped[kept++] = vec_add(points[0],
+      vec_multiply(fraction, vec_subtract(points[1], points[0])));
+  }
+  for (size_t i = 0; i < kept; i++) {
+    points[i] = clipped[i];
+  }
+  return kept;
+}
+
+/**
+ * Finds where two colliding polygons touch. The edge facing the collision
+ * axis most squarely is the reference edge, and the other polygon's facing
+ * edge is clipped to the reference edge's extent. The clipped points that
+ * are past the reference edge are the contacts.
+ */
+void polygon_contacts(const vec_array_t *shape1, const vec_array_t *shape2,
+  vector_t axis, contact_manifold_t *manifold) {
+  contact_edge_t edge1 = facing_edge(shape1, axis);
+  contact_edge_t edge2 = facing_edge(shape2, vec_negate(axis));
+  vector_t direction1 = vec_subtract(edge1.end, edge1.start);
+  vector_t direction2 = vec_subtract(edge2.end, edge2.start);
+  double dot1 = vec_dot(direction1, axis);
+  double dot2 = vec_dot(direction2, axis);
+
+  contact_edge_t reference = edge1;
+  contact_edge_t incident = edge2;
+  // points from the reference polygon towards the incident polygon
+  vector_t normal = axis;
+  if (dot1 * dot1 * vec_dot(direction2, direction2)
+      > dot2 * dot2 * vec_dot(direction1, direction1)) {
+    reference = edge2;
+    incident = edge1;
+    normal = vec_negate(axis);
+  }
+
+  vector_t along = vec_subtract(reference.end, reference.start);
+  double length = sqrt(vec_dot(along, along));
+  vector_t points[] = {incident.start, incident.end};
+  size_t count = 2;
+  if (length > 0) {
+    along = vec_multiply(1 / length, along);
+    count = clip_segment(points, count, along, vec_dot(along, reference.start));
+    if (count == 2) {
+      count = clip_segment(points, count, vec_negate(along),
+        -vec_dot(along, reference.end));
+    }
+  }
+
+  double face = vec_dot(normal, reference.deepest);
+  manifold->contact_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    double depth = face - vec_dot(normal, points[i]);
+    if (depth >= 0) {
+      manifold->contacts[manifold->contact_count++] =
+        vec_add(points[i], vec_multiply(depth / 2, normal));
+    }
+  }
+  if (manifold->contact_count == 0) {
+    // the edges barely overlap, so use the incident polygon's deepest vertex
+    manifold->contacts[0] = incident.deepest;
+    manifold->contact_count = 1;
+  }
+}
+
+/**
+ * Describes how two colliding shapes overlap, given the collision axis
+ * pointing from the first shape towards the second.
+ */
+void fill_manifold(contact_shape_t shape1, contact_shape_t shape2,
+  vector_t axis, contact_manifold_t *manifold) {
+  vector_t projection1 = project_contact_shape(shape1, axis);
+  vector_t projection2 = project_contact_shape(shape2, axis);
+  manifold->depth = fmax(projection1.y - projection2.x, 0);
+
+  if (shape1.radius > 0) {
+    manifold->contacts[0] = vec_add(contact_core(shape1, axis),
+      vec_multiply(shape1.radius - manifold->depth / 2, axis));
+    manifold->contact_count = 1;
+  }
+  else if (shape2.radius > 0) {
+    manifold->contacts[0] = vec_subtract(contact_core(shape2, vec_negate(axis)),
+      vec_multiply(shape2.radius - manifold->depth / 2, axis));
+    manifold->contact_count = 1;
+  }
+  else {
+    polygon_contacts(shape1.polygon.points, shape2.polygon.points, axis,
+      manifold);
+  }
+}
 
 collision_info_t find_collision(list_t *shape1, list_t *shape2) {
+  return find_collision_manifold(shape1, shape2, NULL);
+}
+
+collision_info_t find_collision_manifold(list_t *shape1, list_t *shape2,
+  contact_manifold_t *manifold) {
+  vec_array_t *array1 = vec_array_from_list(shape1);
+  vec_array_t *array2 = vec_array_from_list(shape2);
+  collision_info_t info = find_collision_manifold_array(array1, array2, manifold);
+  vec_array_free(array1);
+  vec_array_free(array2);
+  return info;
+}
+
+collision_info_t find_collision_array(const vec_array_t *shape1,
+  const vec_array_t *shape2) {
+  return find_collision_manifold_array(shape1, shape2, NULL);
+}
+
+collision_info_t find_collision_manifold_array(const vec_array_t *shape1,
+  const vec_array_t *shape2, contact_manifold_t *manifold) {
   if (!bounding_box_intersect(shape1, shape2)) {
     return (collision_info_t) {false, VEC_ZERO};
   }
-  return all_projections_overlapping(shape1, shape2);
+  projectable_t polygon1 = {shape1, polygon_array_is_convex(shape1)};
+  projectable_t polygon2 = {shape2, polygon_array_is_convex(shape2)};
+  vector_t centroid1 = polygon_array_centroid(shape1);
+  vector_t centroid2 = polygon_array_centroid(shape2);
+  collision_info_t info;
+  if (!use_gjk(vec_array_size(shape1) + vec_array_size(shape2))
+      || !polygon1.convex || !polygon2.convex
+      || !gjk_collision(shape1, centroid1, shape2, centroid2, NULL, &info)) {
+    info = separating_axis_collision(
+      polygon1, NULL, centroid1,
+      polygon2, NULL, centroid2,
+      NULL
+    );
+  }
+  if (info.collided && manifold != NULL) {
+    contact_shape_t contact_shape1 = {
+      .polygon = polygon1, .center = VEC_ZERO, .radius = 0, .half_axis = VEC_ZERO
+    };
+    contact_shape_t contact_shape2 = {
+      .polygon = polygon2, .center = VEC_ZERO, .radius = 0, .half_axis = VEC_ZERO
+    };
+    fill_manifold(contact_shape1, contact_shape2, info.axis, manifold);
+  }
+  return info;
+}
+
+collision_info_t find_body_collision(body_t *body1, body_t *body2) {
+  return find_body_collision_manifold(body1, body2, NULL, NULL);
+}
+
+collision_info_t find_body_collision_cached(body_t *body1, body_t *body2,
+  vector_t *axis_cache) {
+  return find_body_collision_manifold(body1, body2, axis_cache, NULL);
+}
+
+/**
+ * A body prepared for narrow phase tests, with everything the tests read
+ * from it gathered once, so that it can be tested against many other bodies.
+ * The shape and normals are borrowed from the body, so nothing is allocated,
+ * and the result is only valid until the body next moves.
+ */
+typedef struct collision_body {
+  contact_shape_t shape;
+  const vector_t *normals;
+} collision_body_t;
+
+/**
+ * Prepares a body for narrow phase tests.
+ */
+collision_body_t prepare_collision_body(body_t *body) {
+  if (body_is_circle(body)) {
+    return (collision_body_t) {
+      .shape = {
+        .polygon = {NULL, false},
+        .center = body_get_centroid(body),
+        .radius = body_get_radius(body),
+        .half_axis = VEC_ZERO
+      },
+      .normals = NULL
+    };
+  }
+  return (collision_body_t) {
+    .shape = {
+      .polygon = {body_peek_shape(body), body_is_convex(body)},
+      .center = body_get_centroid(body),
+      .radius = 0,
+      .half_axis = VEC_ZERO
+    },
+    .normals = body_get_edge_normals(body)
+  };
+}
+
+/**
+ * Prepares one convex part of a compound body (see body_set_parts())
+ * for narrow phase tests, oriented by the part's own centroid.
+ */
+collision_body_t prepare_collision_part(body_t *body, size_t index) {
+  const vec_array_t *points = body_peek_part(body, index);
+  return (collision_body_t) {
+    .shape = {
+      .polygon = {points, true},
+      .center = polygon_array_centroid(points),
+      .radius = 0,
+      .half_axis = VEC_ZERO
+    },
+    .normals = body_get_part_normals(body, index)
+  };
+}
+
+/**
+ * Prepares one capsule of a compound body for narrow phase tests.
+ */
+collision_body_t prepare_collision_capsule(capsule_t capsule) {
+  vector_t middle = vec_multiply(0.5, vec_add(capsule.start, capsule.end));
+  return (collision_body_t) {
+    .shape = {
+      .polygon = {NULL, false},
+      .center = middle,
+      .radius = capsule.radius,
+      .half_axis = vec_subtract(capsule.end, middle)
+    },
+    .normals = NULL
+  };
+}
+
+/**
+ * Computes the collision between two prepared bodies whose bounding boxes
+ * overlap, like find_body_collision_manifold().
+ */
+collision_info_t prepared_body_collision(collision_body_t *body1,
+  collision_body_t *body2, vector_t *axis_cache, contact_manifold_t *manifold) {
+  contact_shape_t shape1 = body1->shape;
+  contact_shape_t shape2 = body2->shape;
+  bool is_circle1 = shape1.radius > 0;
+  bool is_circle2 = shape2.radius > 0;
+  projectable_t polygon1 = shape1.polygon;
+  projectable_t polygon2 = shape2.polygon;
+  collision_info_t info;
+  if (is_capsule(shape1) || is_capsule(shape2)) {
+    if (is_circle1 && is_circle2) {
+      info = find_capsule_collision(contact_capsule(shape1),
+        contact_capsule(shape2));
+    }
+    else {
+      collision_body_t *capsule = is_circle1 ? body1 : body2;
+      collision_body_t *polygon = is_circle1 ? body2 : body1;
+      info = capsule_polygon_collision(contact_capsule(capsule->shape),
+        polygon->shape.polygon, polygon->normals, polygon->shape.center);
+      if (!is_circle1) {
+        info.axis = vec_negate(info.axis);
+      }
+    }
+  }
+  else if (is_circle1 && is_circle2) {
+    info = find_circle_collision(shape1.center, shape1.radius,
+      shape2.center, shape2.radius);
+  }
+  else if (is_circle1 || is_circle2) {
+    collision_body_t *circle = is_circle1 ? body1 : body2;
+    collision_body_t *polygon = is_circle1 ? body2 : body1;
+    info = circle_polygon_collision(circle->shape.center, circle->shape.radius,
+      polygon->shape.polygon, polygon->normals, polygon->shape.center,
+      axis_cache);
+    if (!is_circle1) {
+      info.axis = vec_negate(info.axis);
+    }
+  }
+  else if (cached_axis_separates(polygon1, polygon2, axis_cache)) {
+    info = (collision_info_t) {false, VEC_ZERO};
+  }
+  else if (!use_gjk(vec_array_size(polygon1.points)
+        + vec_array_size(polygon2.points))
+      || !polygon1.convex || !polygon2.convex
+      || !gjk_collision(polygon1.points, shape1.center,
+        polygon2.points, shape2.center, axis_cache, &info)) {
+    info = separating_axis_collision(
+      polygon1, body1->normals, shape1.center,
+      polygon2, body2->normals, shape2.center,
+      axis_cache
+    );
+  }
+
+  if (info.collided && manifold != NULL) {
+    fill_manifold(shape1, shape2, info.axis, manifold);
+  }
+  return info;
+}
+
+/**
+ * A function called on a pair of pieces of two bodies by for_each_piece_pair().
+ */
+typedef void (*piece_pair_func_t)(collision_body_t *piece1,
+  collision_body_t *piece2, void *aux);
+
+/**
+ * Counts the pieces of a body: the parts and capsules of a compound body,
+ * or just the whole body otherwise.
+ */
+size_t piece_count(body_t *body) {
+  if (!body_is_compound(body)) {
+    return 1;
+  }
+  return body_get_part_count(body) + body_get_capsule_count(body);
+}
+
+/**
+ * Computes the bounding box of one of a body's pieces.
+ */
+aabb_t piece_bounds(body_t *body, size_t i) {
+  if (!body_is_compound(body)) {
+    return body_get_bounds(body);
+  }
+  size_t part_count = body_get_part_count(body);
+  return i < part_count
+    ? aabb_of_vec_array(body_peek_part(body, i))
+    : capsule_bounds(body_get_capsules(body)[i - part_count]);
+}
+
+/**
+ * Prepares one of a body's pieces for narrow phase tests.
+ */
+collision_body_t prepare_piece(body_t *body, size_t i) {
+  if (!body_is_compound(body)) {
+    return prepare_collision_body(body);
+  }
+  size_t part_count = body_get_part_count(body);
+  return i < part_count
+    ? prepare_collision_part(body, i)
+    : prepare_collision_capsule(body_get_capsules(body)[i - part_count]);
+}
+
+/**
+ * Calls a function on each pair of pieces of two bodies whose bounding boxes
+ * overlap, where the pieces of a compound body are its parts and capsules,
+ * and the only piece of any other body is the whole body.
+ * The first body's boxes are swept by a displacement before testing them.
+ */
+void for_each_piece_pair(body_t *body1, vector_t displacement, body_t *body2,
+  piece_pair_func_t func, void *aux) {
+  size_t count1 = piece_count(body1);
+  size_t count2 = piece_count(body2);
+  for (size_t i = 0; i < count1; i++) {
+    aabb_t start = piece_bounds(body1, i);
+    aabb_t end = {
+      vec_add(start.min, displacement),
+      vec_add(start.max, displacement)
+    };
+    aabb_t bounds1 = aabb_union(start, end);
+    if (!aabb_overlap(bounds1, body_get_bounds(body2))) {
+      continue;
+    }
+
+    collision_body_t piece1 = prepare_piece(body1, i);
+    for (size_t j = 0; j < count2; j++) {
+      if (!aabb_overlap(bounds1, piece_bounds(body2, j))) {
+        continue;
+      }
+      collision_body_t piece2 = prepare_piece(body2, j);
+      func(&piece1, &piece2, aux);
+    }
+  }
+}
+
+/**
+ * The deepest collision found so far between the pieces of two bodies.
+ */
+typedef struct deepest_collision {
+  collision_info_t info;
+  contact_manifold_t manifold;
+} deepest_collision_t;
+
+/**
+ * Keeps the collision between two pieces if it is deeper than the deepest
+ * one so far.
+ */
+void deeper_piece_collision(collision_body_t *piece1, collision_body_t *piece2,
+  void *aux) {
+  deepest_collision_t *deepest = aux;
+  contact_manifold_t manifold;
+  collision_info_t info = prepared_body_collision(piece1, piece2, NULL, &manifold);
+  if (info.collided
+      && (!deepest->info.collided || manifold.depth > deepest->manifold.depth)) {
+    deepest->info = info;
+    deepest->manifold = manifold;
+  }
+}
+
+collision_info_t find_body_collision_manifold(body_t *body1, body_t *body2,
+  vector_t *axis_cache, contact_manifold_t *manifold) {
+  if (!aabb_overlap(body_get_bounds(body1), body_get_bounds(body2))) {
+    return (collision_info_t) {false, VEC_ZERO};
+  }
+  if (body_is_compound(body1) || body_is_compound(body2)) {
+    // the axis cache holds one axis, so it cannot serve several pieces
+    deepest_collision_t deepest = {.info = {false, VEC_ZERO}};
+    for_each_piece_pair(body1, VEC_ZERO, body2, deeper_piece_collision,
+      &deepest);
+    if (deepest.info.collided && manifold != NULL) {
+      *manifold = deepest.manifold;
+    }
+    return deepest.info;
+  }
+  collision_body_t prepared1 = prepare_collision_body(body1);
+  collision_body_t prepared2 = prepare_collision_body(body2);
+  return prepared_body_collision(&prepared1, &prepared2, axis_cache, manifold);
+}
+
+void find_collisions_batch(body_t *query, body_t **candidates, size_t count,
+  collision_info_t *results) {
+  if (body_is_compound(query)) {
+    for (size_t i = 0; i < count; i++) {
+      results[i] = find_body_collision(query, candidates[i]);
+    }
+    return;
+  }
+  aabb_t bounds = body_get_bounds(query);
+  collision_body_t prepared = prepare_collision_body(query);
+  for (size_t i = 0; i < count; i++) {
+    if (!aabb_overlap(bounds, body_get_bounds(candidates[i]))) {
+      results[i] = (collision_info_t) {false, VEC_ZERO};
+      continue;
+    }
+    if (body_is_compound(candidates[i])) {
+      results[i] = find_body_collision(query, candidates[i]);
+      continue;
+    }
+    collision_body_t candidate = prepare_collision_body(candidates[i]);
+    results[i] = prepared_body_collision(&prepared, &candidate, NULL, NULL);
+  }
+}
+
+/**
+ * Sweeps one shape by a displacement past another, tracking on each axis
+ * when their projections start and stop overlapping, as fractions of the
+ * displacement. The shapes touch while their projections overlap on every
+ * axis, so they first touch at the latest start if it comes before the
+ * earliest stop. Updates enter, exit, and enter_axis (pointing from shape1
+ * towards shape2), and returns false as soon as an axis shows the shapes
+ * never touch.
+ */
+bool axes_sweep(projectable_t shape1, vector_t displacement, projectable_t shape2,
+  const vector_t *axes, size_t count, double *enter, double *exit,
+  vector_t *enter_axis) {
+  for (size_t i = 0; i < count; i++) {
+    vector_t projection1 = project_shape(shape1, axes[i]);
+    vector_t projection2 = project_shape(shape2, axes[i]);
+    double speed = vec_dot(axes[i], displacement);
+    if (speed == 0) {
+      if (projection1.y < projection2.x || projection2.y < projection1.x) {
+        return false;
+      }
+      continue;
+    }
+
+    double axis_enter, axis_exit;
+    if (speed > 0) {
+      axis_enter = (projection2.x - projection1.y) / speed;
+      axis_exit = (projection2.y - projection1.x) / speed;
+    }
+    else {
+      axis_enter = (projection2.y - projection1.x) / speed;
+      axis_exit = (projection2.x - projection1.y) / speed;
+    }
+    if (axis_enter > *enter) {
+      *enter = axis_enter;
+      *enter_axis = speed > 0 ? axes[i] : vec_negate(axes[i]);
+    }
+    if (axis_exit < *exit) {
+      *exit = axis_exit;
+    }
+    if (*enter > *exit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Finds the fraction of a displacement after which a point moving along it
+ * first comes within a distance of a center, or INFINITY if it never does
+ * or is already that close.
+ */
+double ray_circle_time(vector_t start, vector_t displacement, vector_t center,
+  double radius) {
+  vector_t offset = vec_subtract(start, center);
+  double a = vec_dot(displacement, displacement);
+  double b = vec_dot(offset, displacement);
+  double c = vec_dot(offset, offset) - radius * radius;
+  double discriminant = b * b - a * c;
+  if (c < 0 || b >= 0 || discriminant < 0) {
+    return INFINITY;
+  }
+  return (-b - sqrt(discriminant)) / a;
+}
+
+/**
+ * Sweeps a circle by a displacement towards a convex polygon, given the unit
+ * normals of the polygon's edges and its centroid.
+ * The circle first touches the polygon where its center first comes within
+ * its radius of an edge or a vertex.
+ */
+impact_info_t circle_polygon_impact(vector_t center, double radius,
+  vector_t displacement, const vec_array_t *shape, const vector_t *normals,
+  vector_t centroid) {
+  impact_info_t impact = {false, INFINITY, VEC_ZERO};
+  const vector_t *points = vec_array_data(shape);
+  size_t size = vec_array_size(shape);
+  for (size_t i = 0; i < size; i++) {
+    vector_t vertex = points[i];
+    vector_t edge = vec_subtract(points[(i + 1) % size], vertex);
+    // the normals point inwards on counterclockwise polygons
+    vector_t normal = normals[i];
+    if (vec_dot(normal, vec_subtract(vertex, centroid)) < 0) {
+      normal = vec_negate(normal);
+    }
+
+    double speed = vec_dot(normal, displacement);
+    if (speed < 0) {
+      double distance = vec_dot(normal, vec_subtract(center, vertex));
+      double time = (radius - distance) / speed;
+      vector_t touch = vec_add(center, vec_multiply(time, displacement));
+      double along = vec_dot(vec_subtract(touch, vertex), edge);
+      if (time >= 0 && time < impact.time
+          && along >= 0 && along <= vec_dot(edge, edge)) {
+        impact = (impact_info_t) {true, time, vec_negate(normal)};
+      }
+    }
+
+    double time = ray_circle_time(center, displacement, vertex, radius);
+    if (time < impact.time) {
+      vector_t touch = vec_add(center, vec_multiply(time, displacement));
+      impact = (impact_info_t) {
+        true,
+        time,
+        vec_multiply(1 / radius, vec_subtract(vertex, touch))
+      };
+    }
+  }
+  return impact;
+}
+
+/**
+ * Sweeps a point by a displacement towards a capsule. The point first touches
+ * the capsule where it first comes within the radius of either end
+ * or of either side of the segment.
+ * The returned axis points from the point towards the capsule.
+ */
+impact_info_t ray_capsule_impact(vector_t start, vector_t displacement,
+  capsule_t capsule) {
+  impact_info_t impact = {false, INFINITY, VEC_ZERO};
+  vector_t ends[] = {capsule.start, capsule.end};
+  for (size_t i = 0; i < 2; i++) {
+    double time = ray_circle_time(start, displacement, ends[i], capsule.radius);
+    if (time < impact.time) {
+      vector_t touch = vec_add(start, vec_multiply(time, displacement));
+      impact = (impact_info_t) {
+        true,
+        time,
+        vec_multiply(1 / capsule.radius, vec_subtract(ends[i], touch))
+      };
+    }
+  }
+
+  vector_t along = vec_subtract(capsule.end, capsule.start);
+  double length_squared = vec_dot(along, along);
+  if (length_squared == 0) {
+    return impact;
+  }
+  double length = sqrt(length_squared);
+  vector_t normal = {-along.y / length, along.x / length};
+  for (size_t i = 0; i < 2; i++) {
+    vector_t side = i == 0 ? normal : vec_negate(normal);
+    double distance = vec_dot(side, vec_subtract(start, capsule.start));
+    double speed = vec_dot(side, displacement);
+    if (speed >= 0 || distance < capsule.radius) {
+      continue;
+    }
+    double time = (capsule.radius - distance) / speed;
+    vector_t touch = vec_add(start, vec_multiply(time, displacement));
+    double fraction = vec_dot(vec_subtract(touch, capsule.start), along)
+      / length_squared;
+    if (time < impact.time && fraction >= 0 && fraction <= 1) {
+      impact = (impact_info_t) {true, time, vec_negate(side)};
+    }
+  }
+  return impact;
+}
+
+/**
+ * Keeps an impact if it comes before the earliest one so far.
+ */
+void keep_earlier_impact(impact_info_t *earliest, impact_info_t impact) {
+  if (impact.time < earliest->time) {
+    *earliest = impact;
+  }
+}
+
+/**
+ * Sweeps a capsule by a displacement towards another. Segments that do not
+ * touch are closest at an end of one of them, so the capsules first touch
+ * where an end of one, grown by both radii, first touches the other's segment.
+ */
+impact_info_t capsules_impact(capsule_t moving, vector_t displacement,
+  capsule_t fixed) {
+  impact_info_t impact = {false, INFINITY, VEC_ZERO};
+  double radius = moving.radius + fixed.radius;
+  capsule_t grown_moving = {moving.start, moving.end, radius};
+  capsule_t grown_fixed = {fixed.start, fixed.end, radius};
+  vector_t moving_ends[] = {moving.start, moving.end};
+  vector_t fixed_ends[] = {fixed.start, fixed.end};
+  for (size_t i = 0; i < 2; i++) {
+    keep_earlier_impact(&impact,
+      ray_capsule_impact(moving_ends[i], displacement, grown_fixed));
+    impact_info_t reverse =
+      ray_capsule_impact(fixed_ends[i], vec_negate(displacement), grown_moving);
+    reverse.axis = vec_negate(reverse.axis);
+    keep_earlier_impact(&impact, reverse);
+  }
+  return impact;
+}
+
+/**
+ * Sweeps a capsule by a displacement towards a convex polygon, given the unit
+ * normals of the polygon's edges and its centroid. They first touch where an
+ * end of the capsule first touches the polygon or a vertex of the polygon
+ * first touches the capsule.
+ * The returned axis points from the capsule towards the polygon.
+ */
+impact_info_t capsule_polygon_impact(capsule_t capsule, vector_t displacement,
+  const vec_array_t *shape, const vector_t *normals, vector_t centroid) {
+  impact_info_t impact = {false, INFINITY, VEC_ZERO};
+  vector_t ends[] = {capsule.start, capsule.end};
+  for (size_t i = 0; i < 2; i++) {
+    keep_earlier_impact(&impact, circle_polygon_impact(ends[i], capsule.radius,
+      displacement, shape, normals, centroid));
+  }
+  const vector_t *points = vec_array_data(shape);
+  for (size_t i = 0; i < vec_array_size(shape); i++) {
+    impact_info_t reverse = ray_capsule_impact(points[i],
+      vec_negate(displacement), capsule);
+    reverse.axis = vec_negate(reverse.axis);
+    keep_earlier_impact(&impact, reverse);
+  }
+  return impact;
+}
+
+/**
+ * Sweeps one prepared convex polygon, circle, or capsule by a displacement
+ * towards another, like find_time_of_impact(), given that they do not touch at the
+ * start. Returns a time of INFINITY if they never touch.
+ */
+impact_info_t prepared_time_of_impact(collision_body_t *moving,
+  vector_t displacement, collision_body_t *fixed) {
+  impact_info_t miss = {false, INFINITY, VEC_ZERO};
+  contact_shape_t shape1 = moving->shape;
+  contact_shape_t shape2 = fixed->shape;
+  bool is_circle1 = shape1.radius > 0;
+  bool is_circle2 = shape2.radius > 0;
+  impact_info_t impact;
+  if (is_capsule(shape1) || is_capsule(shape2)) {
+    if (is_circle1 && is_circle2) {
+      impact = capsules_impact(contact_capsule(shape1), displacement,
+        contact_capsule(shape2));
+    }
+    else {
+      // a polygon moving towards a capsule is a capsule moving the other way
+      collision_body_t *capsule = is_circle1 ? moving : fixed;
+      collision_body_t *polygon = is_circle1 ? fixed : moving;
+      impact = capsule_polygon_impact(contact_capsule(capsule->shape),
+        is_circle1 ? displacement : vec_negate(displacement),
+        polygon->shape.polygon.points, polygon->normals, polygon->shape.center);
+      if (!is_circle1) {
+        impact.axis = vec_negate(impact.axis);
+      }
+    }
+  }
+  else if (is_circle1 && is_circle2) {
+    double time = ray_circle_time(shape1.center, displacement,
+      shape2.center, shape1.radius + shape2.radius);
+    impact = (impact_info_t) {time != INFINITY, time, VEC_ZERO};
+    if (impact.hit) {
+      vector_t touch = vec_add(shape1.center, vec_multiply(time, displacement));
+      vector_t offset = vec_subtract(shape2.center, touch);
+      impact.axis = vec_multiply(1 / sqrt(vec_dot(offset, offset)), offset);
+    }
+  }
+  else if (is_circle1 || is_circle2) {
+    // a polygon moving towards a circle is a circle moving the other way
+    collision_body_t *circle = is_circle1 ? moving : fixed;
+    collision_body_t *polygon = is_circle1 ? fixed : moving;
+    impact = circle_polygon_impact(circle->shape.center, circle->shape.radius,
+      is_circle1 ? displacement : vec_negate(displacement),
+      polygon->shape.polygon.points, polygon->normals, polygon->shape.center);
+    if (!is_circle1) {
+      impact.axis = vec_negate(impact.axis);
+    }
+  }
+  else {
+    projectable_t polygon1 = shape1.polygon;
+    projectable_t polygon2 = shape2.polygon;
+    double enter = -INFINITY;
+    double exit = INFINITY;
+    vector_t axis = VEC_ZERO;
+    bool touches = axes_sweep(polygon1, displacement, polygon2,
+        moving->normals, vec_array_size(polygon1.points), &enter, &exit, &axis)
+      && axes_sweep(polygon1, displacement, polygon2,
+        fixed->normals, vec_array_size(polygon2.points), &enter, &exit, &axis);
+    impact = (impact_info_t) {touches && enter >= 0, enter, axis};
+  }
+  return impact.hit ? impact : miss;
+}
+
+/**
+ * The earliest impact found so far between the pieces of two bodies,
+ * and how far the moving body moves.
+ */
+typedef struct earliest_impact {
+  impact_info_t impact;
+  vector_t displacement;
+} earliest_impact_t;
+
+/**
+ * Keeps the impact between two pieces if it comes before the earliest one
+ * so far.
+ */
+void earlier_piece_impact(collision_body_t *piece1, collision_body_t *piece2,
+  void *aux) {
+  earliest_impact_t *earliest = aux;
+  impact_info_t impact =
+    prepared_time_of_impact(piece1, earliest->displacement, piece2);
+  if (impact.time < earliest->impact.time) {
+    earliest->impact = impact;
+  }
+}
+
+impact_info_t find_time_of_impact(body_t *moving, vector_t displacement,
+  body_t *fixed) {
+  assert(body_is_circle(moving) || body_is_convex(moving)
+    || body_is_compound(moving));
+  assert(body_is_circle(fixed) || body_is_convex(fixed)
+    || body_is_compound(fixed));
+  impact_info_t miss = {false, 0, VEC_ZERO};
+  if (find_body_collision(moving, fixed).collided) {
+    return miss;
+  }
+  earliest_impact_t earliest = {{false, INFINITY, VEC_ZERO}, displacement};
+  for_each_piece_pair(moving, displacement, fixed, earlier_piece_impact,
+    &earliest);
+  if (!earliest.impact.hit || earliest.impact.time > 1) {
+    return miss;
+  }
+  return earliest.impact;
+}
+
+collision_stats_t collision_get_stats(void) {
+  return collision_stats;
+}
+
+void collision_reset_stats(void) {
+  collision_stats = (collision_stats_t) {0, 0};
+}
+
+void collision_set_narrow_phase(narrow_phase_kind_t kind) {
+  narrow_phase = kind;
 }
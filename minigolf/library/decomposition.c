@@ -0,0 +1,245 @@
+#include "decomposition.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * A convex piece of a decomposition, as indices into the polygon's vertices
+ * in counterclockwise order.
+ */
+typedef struct piece {
+    size_t *indices;
+    size_t count;
+} piece_t;
+
+/**
+ * Copies a polygon's vertices into an array in counterclockwise order.
+ */
+vector_t *counterclockwise_points(list_t *polygon) {
+    size_t length = list_size(polygon);
+    vector_t *points = malloc(length * sizeof(vector_t));
+    assert(points != NULL);
+    double twice_area = 0;
+    for (size_t i = 0; i < length; i++) {
+        vector_t *vertex = list_get(polygon, i);
+        vector_t *next = list_get(polygon, (i + 1) % length);
+        twice_area += vec_cross(*vertex, *next);
+    }
+    for (size_t i = 0; i < length; i++) {
+        size_t index = twice_area >= 0 ? i : length - 1 - i;
+        points[i] = *(vector_t *) list_get(polygon, index);
+    }
+    return points;
+}
+
+/**
+ * Returns how far c turns left of the line from a through b
+ * (positive for a left turn, 0 if the points are collinear).
+ */
+double turn(vector_t a, vector_t b, vector_t c) {
+    return vec_cross(vec_subtract(b, a), vec_subtract(c, b));
+}
+
+/**
+ * Returns whether two points are at exactly the same position.
+ */
+bool same_point(vector_t a, vector_t b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+/**
+ * Returns whether a point lies inside or on a counterclockwise triangle.
+ */
+bool in_triangle(vector_t point, vector_t a, vector_t b, vector_t c) {
+    return turn(a, b, point) >= 0 && turn(b, c, point) >= 0
+        && turn(c, a, point) >= 0;
+}
+
+/**
+ * Returns whether a vertex of the polygon that remains to be clipped is an
+ * ear: it turns left, and no other remaining vertex lies in its triangle.
+ */
+bool is_ear(vector_t *points, size_t *remaining, size_t count, size_t i) {
+    vector_t previous = points[remaining[(i + count - 1) % count]];
+    vector_t vertex = points[remaining[i]];
+    vector_t next = points[remaining[(i + 1) % count]];
+    if (turn(previous, vertex, next) <= 0) {
+        return false;
+    }
+    for (size_t j = 0; j < count; j++) {
+        vector_t other = points[remaining[j]];
+        if (same_point(other, previous) || same_point(other, vertex)
+            || same_point(other, next)) {
+            continue;
+        }
+        if (in_triangle(other, previous, vertex, next)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Triangulates a counterclockwise polygon by ear clipping,
+ * storing each triangle's vertex indices in pieces.
+ * Returns the number of triangles.
+ */
+size_t clip_ears(vector_t *points, size_t length, piece_t *pieces) {
+    size_t *remaining = malloc(length * sizeof(size_t));
+    assert(remaining != NULL);
+    for (size_t i = 0; i < length; i++) {
+        remaining[i] = i;
+    }
+    size_t count = length;
+    size_t triangles = 0;
+    size_t i = 0;
+    // vertices checked since the last clip, to detect polygons with no ears
+    size_t checked = 0;
+    while (count >= 3) {
+        vector_t previous = points[remaining[(i + count - 1) % count]];
+        vector_t vertex = points[remaining[i]];
+        vector_t next = points[remaining[(i + 1) % count]];
+        bool collinear = turn(previous, vertex, next) == 0;
+        if (collinear || is_ear(points, remaining, count, i)) {
+            if (!collinear) {
+                piece_t *triangle = &pieces[triangles++];
+                triangle->indices = malloc(3 * sizeof(size_t));
+                assert(triangle->indices != NULL);
+                triangle->indices[0] = remaining[(i + count - 1) % count];
+                triangle->indices[1] = remaining[i];
+                triangle->indices[2] = remaining[(i + 1) % count];
+                triangle->count = 3;
+            }
+            for (size_t j = i; j + 1 < count; j++) {
+                remaining[j] = remaining[j + 1];
+            }
+            count--;
+            if (i == count) {
+                i = 0;
+            }
+            checked = 0;
+        }
+        else {
+            i = (i + 1) % count;
+            checked++;
+            // a simple polygon always has an ear, so its edges must cross
+            assert(checked <= count);
+        }
+    }
+    free(remaining);
+    return triangles;
+}
+
+/**
+ * Returns whether a piece is convex, allowing collinear vertices.
+ */
+bool piece_is_convex(vector_t *points, size_t *indices, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        vector_t previous = points[indices[(i + count - 1) % count]];
+        vector_t vertex = points[indices[i]];
+        vector_t next = points[indices[(i + 1) % count]];
+        if (turn(previous, vertex, next) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Tries to merge two pieces across an edge they share. Returns whether they
+ * share an edge and the merged piece is convex, in which case piece1 becomes
+ * the merged piece.
+ */
+bool merge_pieces(vector_t *points, piece_t *piece1, piece_t *piece2) {
+    for (size_t i = 0; i < piece1->count; i++) {
+        size_t start = piece1->indices[i];
+        size_t end = piece1->indices[(i + 1) % piece1->count];
+        // neighbors list a shared edge in the opposite direction
+        for (size_t j = 0; j < piece2->count; j++) {
+            if (piece2->indices[j] != end
+                || piece2->indices[(j + 1) % piece2->count] != start) {
+                continue;
+            }
+
+            // walk piece1 from end back around to start, then piece2 from
+            // start around to just before end
+            size_t count = piece1->count + piece2->count - 2;
+            size_t *merged = malloc(count * sizeof(size_t));
+            assert(merged != NULL);
+            size_t k = 0;
+            for (size_t m = 0; m < piece1->count; m++) {
+                merged[k++] = piece1->indices[(i + 1 + m) % piece1->count];
+            }
+            for (size_t m = 2; m < piece2->count; m++) {
+                merged[k++] = piece2->indices[(j + m) % piece2->count];
+            }
+            if (!piece_is_convex(points, merged, count)) {
+                free(merged);
+                return false;
+            }
+            free(piece1->indices);
+            piece1->indices = merged;
+            piece1->count = count;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Makes a list of vertices from a piece.
+ */
+list_t *piece_polygon(vector_t *points, piece_t *piece) {
+    list_t *polygon = list_init(piece->count, free);
+    for (size_t i = 0; i < piece->count; i++) {
+        vector_t *vertex = malloc(sizeof(vector_t));
+        assert(vertex != NULL);
+        *vertex = points[piece->indices[i]];
+        list_add(polygon, vertex);
+    }
+    return polygon;
+}
+
+/**
+ * Triangulates a polygon and, if merge is true, merges the triangles
+ * into convex pieces, returning them as a list of polygons.
+ */
+list_t *decompose(list_t *polygon, bool merge) {
+    size_t length = list_size(polygon);
+    assert(length >= 3);
+    vector_t *points = counterclockwise_points(polygon);
+    piece_t *pieces = malloc((length - 2) * sizeof(piece_t));
+    assert(pieces != NULL);
+    size_t count = clip_ears(points, length, pieces);
+
+    bool merged = merge;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < count && !merged; i++) {
+            for (size_t j = i + 1; j < count && !merged; j++) {
+                if (merge_pieces(points, &pieces[i], &pieces[j])) {
+                    free(pieces[j].indices);
+                    pieces[j] = pieces[--count];
+                    merged = true;
+                }
+            }
+        }
+    }
+
+    list_t *polygons = list_init(count, (free_func_t) list_free);
+    for (size_t i = 0; i < count; i++) {
+        list_add(polygons, piece_polygon(points, &pieces[i]));
+        free(pieces[i].indices);
+    }
+    free(pieces);
+    free(points);
+    return polygons;
+}
+
+list_t *polygon_triangulate(list_t *polygon) {
+    return decompose(polygon, false);
+}
+
+list_t *polygon_decompose(list_t *polygon) {
+    return decompose(polygon, true);
+}
@@ -14,7 +14,7 @@ force_aux_t *force_init(list_t *bodies, double constant) {
     aux->body_list = bodies;
     aux->constant = constant;
     aux->collision_handler = NULL;
-    aux->is_collision_handled = false;
+    aux->cached_axis = VEC_ZERO;
     aux->extra_aux = NULL;
     aux->freer = NULL;
     return aux;
@@ -28,12 +28,12 @@ collision_handler_t force_get_collision_handler(force_aux_t *aux) {
   return aux->collision_handler;
 }
 
-void force_set_is_collision_handled(force_aux_t *aux, bool is_collision_handled) {
-  aux->is_collision_handled = is_collision_handled;
+void force_set_cached_axis(force_aux_t *aux, vector_t axis) {
+  aux->cached_axis = axis;
 }
 
-bool force_get_is_collision_handled(force_aux_t *aux) {
-  return aux->is_collision_handled;
+vector_t force_get_cached_axis(force_aux_t *aux) {
+  return aux->cached_axis;
 }
 
 void force_set_extra_aux(force_aux_t *aux, void *extra_aux) {
@@ -42,13 +42,8 @@ void create_drag(scene_t *scene, double gamma, body_t *body) {
 }
 
 void create_destructive_collision(scene_t *scene, body_t *body1, body_t *body2) {
-    list_t *bodies = list_init(2, null_free);
-    list_add(bodies, body1);
-    list_add(bodies, body2);
-
-    force_aux_t *aux = force_init(bodies, 1);
-    scene_add_bodies_force_creator(scene, destructive_collision, (void *) aux,
-        bodies, (free_func_t)force_free);
+    scene_add_contact_handler(scene, body1, body2, CONTACT_BEGIN,
+        destructive_collision, NULL, NULL);
 }
 
 void create_collision(
@@ -59,18 +54,13 @@ void create_collision(
     void *aux,
     free_func_t freer
 ) {
-  list_t *bodies = list_init(2, null_free);
-
-  list_add(bodies, body1);
-  list_add(bodies, body2);
-
-  force_aux_t *new_aux = force_init(bodies, 1);
+  force_aux_t *new_aux = force_init(NULL, 1);
   force_set_collision_handler(new_aux, handler);
   force_set_extra_aux(new_aux, aux);
   force_set_freer(new_aux, freer);
 
-  scene_add_bodies_force_creator(scene, collision, new_aux, bodies,
-    (free_func_t) force_free);
+  scene_add_contact_handler(scene, body1, body2, CONTACT_BEGIN, collision,
+    new_aux, (free_func_t) force_free);
 }
 
 void physics_collision_handler(body_t *body1, body_t *body2, vector_t axis, void *aux) {
@@ -108,9 +98,33 @@ void create_physics_collision(
     body_t *body1,
     body_t *body2
 ) {
-  force_aux_t *aux = force_init(NULL, elasticity);
-  create_collision(scene, body1, body2, physics_collision_handler, aux,
-    (free_func_t) force_free);
+  scene_add_physics_contact(scene, body1, body2, elasticity);
+}
+
+void register_collision(
+    scene_t *scene,
+    size_t type1,
+    size_t type2,
+    collision_handler_t handler,
+    void *aux,
+    free_func_t freer
+) {
+  force_aux_t *new_aux = force_init(NULL, 1);
+  force_set_collision_handler(new_aux, handler);
+  force_set_extra_aux(new_aux, aux);
+  force_set_freer(new_aux, freer);
+
+  scene_register_collision_handler(scene, type1, type2, CONTACT_BEGIN,
+    collision, new_aux, (free_func_t) force_free);
+}
+
+void register_physics_collision(
+    scene_t *scene,
+    double elasticity,
+    size_t type1,
+    size_t type2
+) {
+  scene_register_physics_contact(scene, type1, type2, elasticity);
 }
 
 void create_friction_collision(
@@ -131,17 +145,28 @@ void create_friction_collision(
 }
 
 
+/**
+ * Computes the collision between two bodies, starting from the axis that
+ * separated them (or overlapped least) the last time this force ran.
+ */
+collision_info_t find_cached_collision(force_aux_t *aux, body_t *body1,
+  body_t *body2) {
+  vector_t axis = force_get_cached_axis(aux);
+  collision_info_t info = find_body_collision_cached(body1, body2, &axis);
+  force_set_cached_axis(aux, axis);
+  return info;
+}
+
 void friction_collision(void *aux) {
   body_t *body = force_get_body(aux, 0);
-  list_t *body_shape = body_get_shape(body);
   body_t *ground = force_get_body(aux, 1);
-  list_t *ground_shape = body_get_shape(ground);
 
   vector_t velocity = body_get_velocity(body);
   if (fabs(velocity.x) < BALL_EPSILON && fabs(velocity.y) < BALL_EPSILON) {
     body_set_velocity(body, VEC_ZERO);
   }
-  else if (find_collision(body_shape, ground_shape).collided) {
+  else if (body_can_collide(body, ground)
+    && find_cached_collision(aux, body, ground).collided) {
     double mass = body_get_mass(body);
     double coefficient = force_get_constant(aux);
     vector_t velocity = body_get_velocity(body);
@@ -151,9 +176,6 @@ void friction_collision(void *aux) {
       friction_unit_vec);
     body_add_force(body, friction_force);
   }
-
-  list_free(body_shape);
-  list_free(ground_shape);
 }
 
 // newtonian gravity force creator
@@ -191,39 +213,14 @@ void drag(void *aux) {
     body_add_force(body, vec_multiply(-gamma, body_get_velocity(body)));
 }
 
-void destructive_collision(void *aux) {
-    body_t *body1 = force_get_body(aux, 0);
-    body_t *body2 = force_get_body(aux, 1);
-
-    list_t *shape1 = body_get_shape(body1);
-    list_t *shape2 = body_get_shape(body2);
-
-    if (find_collision(shape1, shape2).collided) {
-        body_remove(body1);
-        body_remove(body2);
-    }
-
-    list_free(shape1);
-    list_free(shape2);
+void destructive_collision(body_t *body1, body_t *body2, vector_t axis,
+  const contact_manifold_t *manifold, void *aux) {
+    body_remove(body1);
+    body_remove(body2);
 }
 
-void collision(void *aux) {
-    body_t *body1 = force_get_body(aux, 0);
-    body_t *body2 = force_get_body(aux, 1);
-
-    list_t *shape1 = body_get_shape(body1);
-    list_t *shape2 = body_get_shape(body2);
+void collision(body_t *body1, body_t *body2, vector_t axis,
+  const contact_manifold_t *manifold, void *aux) {
     collision_handler_t handler = force_get_collision_handler(aux);
-    bool is_collision_handled = force_get_is_collision_handled(aux);
-    void *extra_aux = force_get_extra_aux(aux);
-    collision_info_t info = find_collision(shape1, shape2);
-
-    if (info.collided && !is_collision_handled) {
-        handler(body1, body2, info.axis, extra_aux);
-        force_set_is_collision_handled(aux, true);
-    } else if (!find_collision(shape1, shape2).collided) {
-        force_set_is_collision_handled(aux, false);
-    }
-    list_free(shape1);
-    list_free(shape2);
+    handler(body1, body2, axis, force_get_extra_aux(aux));
 }
@@ -0,0 +1,243 @@
+#include "gjk.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+// extra iterations allowed beyond the number of vertices of the difference
+const size_t GJK_EXTRA_ITERATIONS = 8;
+// EPA stops once expanding the closest edge gains less than this distance
+const double EPA_TOLERANCE = 1e-9;
+// EPA gives up (so the caller falls back to the separating axis test)
+// after adding this many points, which bounds the polytope's size
+#define EPA_MAX_ITERATIONS 256
+
+/**
+ * One of the shapes, with the vertex where the last support search ended,
+ * since consecutive searches in nearby directions end at nearby vertices.
+ */
+typedef struct support_shape {
+    const vector_t *points;
+    size_t size;
+    size_t last;
+} support_shape_t;
+
+/**
+ * Finds the vertex of a convex polygon furthest along a direction
+ * by walking from the last such vertex towards increasing projections.
+ */
+vector_t support_vertex(support_shape_t *support, vector_t direction) {
+    size_t best = support->last;
+    double best_projection =
+        vec_dot(support->points[best], direction);
+    // on a convex polygon the projections rise to one peak, so walk uphill
+    size_t steps[] = {1, support->size - 1};
+    for (size_t s = 0; s < 2; s++) {
+        bool moved = false;
+        while (true) {
+            size_t next = (best + steps[s]) % support->size;
+            double projection =
+                vec_dot(support->points[next], direction);
+            if (projection <= best_projection) {
+                break;
+            }
+            best = next;
+            best_projection = projection;
+            moved = true;
+        }
+        if (moved) {
+            break;
+        }
+    }
+    support->last = best;
+    return support->points[best];
+}
+
+/**
+ * Finds the point of the Minkowski difference shape1 - shape2
+ * furthest along a direction.
+ */
+vector_t support_difference(support_shape_t *support1, support_shape_t *support2,
+    vector_t direction) {
+
+    return vec_subtract(support_vertex(support1, direction),
+        support_vertex(support2, vec_negate(direction)));
+}
+
+/**
+ * Returns the perpendicular of an edge that points towards a point.
+ */
+vector_t perpendicular_towards(vector_t edge, vector_t towards) {
+    vector_t perpendicular = {-edge.y, edge.x};
+    if (vec_dot(perpendicular, towards) < 0) {
+        return vec_negate(perpendicular);
+    }
+    return perpendicular;
+}
+
+/**
+ * Updates a GJK simplex whose last point was just added, keeping the
+ * part closest to the origin and picking the next search direction.
+ * Returns true if the simplex contains the origin.
+ * Sets direction to VEC_ZERO if the origin lies on the simplex's boundary.
+ */
+bool update_simplex(vector_t *simplex, size_t *count, vector_t *direction) {
+    vector_t a = simplex[*count - 1];
+    vector_t to_origin = vec_negate(a);
+    if (*count == 2) {
+        vector_t ab = vec_subtract(simplex[0], a);
+        if (vec_dot(ab, to_origin) > 0) {
+            *direction = perpendicular_towards(ab, to_origin);
+            if (vec_dot(*direction, to_origin) == 0) {
+                *direction = VEC_ZERO;
+            }
+        }
+        else {
+            simplex[0] = a;
+            *count = 1;
+            *direction = to_origin;
+        }
+        return false;
+    }
+
+    vector_t b = simplex[1];
+    vector_t c = simplex[0];
+    vector_t ab = vec_subtract(b, a);
+    vector_t ac = vec_subtract(c, a);
+    vector_t ab_outward = perpendicular_towards(ab, vec_negate(ac));
+    vector_t ac_outward = perpendicular_towards(ac, vec_negate(ab));
+    double ab_distance = vec_dot(ab_outward, to_origin);
+    double ac_distance = vec_dot(ac_outward, to_origin);
+    if (ab_distance > 0) {
+        simplex[0] = b;
+        simplex[1] = a;
+        *count = 2;
+        *direction = ab_outward;
+        return false;
+    }
+    if (ac_distance > 0) {
+        simplex[1] = a;
+        *count = 2;
+        *direction = ac_outward;
+        return false;
+    }
+    if (ab_distance == 0 || ac_distance == 0) {
+        *direction = VEC_ZERO;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Expands a triangle containing the origin inside the Minkowski difference
+ * until it reaches the difference's edge closest to the origin.
+ * Returns the unit outward normal of that edge, or VEC_ZERO on failure,
+ * including when it does not converge within EPA_MAX_ITERATIONS.
+ */
+vector_t expand_polytope(support_shape_t *support1, support_shape_t *support2,
+    vector_t *simplex, size_t max_iterations) {
+
+    if (max_iterations > EPA_MAX_ITERATIONS) {
+        max_iterations = EPA_MAX_ITERATIONS;
+    }
+    // the triangle plus one point per iteration
+    vector_t polytope[EPA_MAX_ITERATIONS + 3];
+    // keep the polytope counterclockwise so edge normals point outward
+    polytope[0] = simplex[0];
+    if (vec_cross(vec_subtract(simplex[1], simplex[0]),
+            vec_subtract(simplex[2], simplex[0])) > 0) {
+        polytope[1] = simplex[1];
+        polytope[2] = simplex[2];
+    }
+    else {
+        polytope[1] = simplex[2];
+        polytope[2] = simplex[1];
+    }
+    size_t count = 3;
+
+    vector_t normal = VEC_ZERO;
+    for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+        size_t closest = 0;
+        double closest_distance = INFINITY;
+        vector_t closest_normal = VEC_ZERO;
+        for (size_t i = 0; i < count; i++) {
+            vector_t edge = vec_subtract(polytope[(i + 1) % count], polytope[i]);
+            double length = sqrt(vec_dot(edge, edge));
+            if (length == 0) {
+                continue;
+            }
+            vector_t outward = {edge.y / length, -edge.x / length};
+            double distance = vec_dot(outward, polytope[i]);
+            if (distance < closest_distance) {
+                closest = i;
+                closest_distance = distance;
+                closest_normal = outward;
+            }
+        }
+        if (closest_distance == INFINITY) {
+            break;
+        }
+
+        vector_t point = support_difference(support1, support2, closest_normal);
+        if (vec_dot(point, closest_normal) - closest_distance < EPA_TOLERANCE) {
+            normal = closest_normal;
+            break;
+        }
+        // insert the new point between the ends of the closest edge
+        for (size_t i = count; i > closest + 1; i--) {
+            polytope[i] = polytope[i - 1];
+        }
+        polytope[closest + 1] = point;
+        count++;
+    }
+    return normal;
+}
+
+bool gjk_intersect(list_t *shape1, list_t *shape2, vector_t *axis) {
+    vec_array_t *array1 = vec_array_from_list(shape1);
+    vec_array_t *array2 = vec_array_from_list(shape2);
+    bool intersect = gjk_intersect_array(array1, array2, axis);
+    vec_array_free(array1);
+    vec_array_free(array2);
+    return intersect;
+}
+
+bool gjk_intersect_array(const vec_array_t *shape1, const vec_array_t *shape2,
+    vector_t *axis) {
+
+    support_shape_t support1 = {vec_array_data(shape1), vec_array_size(shape1), 0};
+    support_shape_t support2 = {vec_array_data(shape2), vec_array_size(shape2), 0};
+    assert(support1.size > 0 && support2.size > 0);
+    size_t max_iterations = support1.size + support2.size + GJK_EXTRA_ITERATIONS;
+
+    vector_t direction = vec_subtract(support2.points[0], support1.points[0]);
+    if (direction.x == 0 && direction.y == 0) {
+        direction = (vector_t) {1, 0};
+    }
+    vector_t simplex[3];
+    simplex[0] = support_difference(&support1, &support2, direction);
+    size_t count = 1;
+    direction = vec_negate(simplex[0]);
+
+    for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+        if (direction.x == 0 && direction.y == 0) {
+            // the origin is on the boundary, so the shapes only touch
+            break;
+        }
+        vector_t point = support_difference(&support1, &support2, direction);
+        if (vec_dot(point, direction) < 0) {
+            // nothing in the difference reaches past the origin along direction
+            double length = sqrt(vec_dot(direction, direction));
+            *axis = vec_multiply(1 / length, direction);
+            return false;
+        }
+        simplex[count++] = point;
+        if (update_simplex(simplex, &count, &direction)) {
+            // the difference is shape1 - shape2, so pushing the origin out
+            // through its closest edge means moving shape2 along that normal
+            *axis = expand_polytope(&support1, &support2, simplex, max_iterations);
+            return true;
+        }
+    }
+    *axis = VEC_ZERO;
+    return true;
+}
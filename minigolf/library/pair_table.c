@@ -0,0 +1,148 @@
+#include "pair_table.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// the table grows once more than 1 / MAX_LOAD_FACTOR of its slots are in use
+const size_t MAX_LOAD_FACTOR = 2;
+const size_t TABLE_GROWTH_FACTOR = 2;
+
+typedef struct pair_entry {
+    // key1 is the smaller pointer; a NULL key1 marks an empty slot
+    void *key1;
+    void *key2;
+    void *value;
+} pair_entry_t;
+
+typedef struct pair_table {
+    pair_entry_t *entries;
+    size_t capacity;
+    size_t size;
+    free_func_t freer;
+} pair_table_t;
+
+/**
+ * Orders a pair of keys so that (a, b) and (b, a) are stored identically.
+ */
+void order_pair_keys(void **key1, void **key2) {
+    if ((uintptr_t) *key1 > (uintptr_t) *key2) {
+        void *temp = *key1;
+        *key1 = *key2;
+        *key2 = temp;
+    }
+}
+
+/**
+ * Computes the slot a pair of (already ordered) keys would like to occupy.
+ */
+size_t pair_home_slot(pair_table_t *table, void *key1, void *key2) {
+    uint64_t hash = (uint64_t) (uintptr_t) key1 * 0x9E3779B97F4A7C15ULL;
+    hash ^= (uint64_t) (uintptr_t) key2 * 0xC2B2AE3D27D4EB4FULL;
+    hash ^= hash >> 32;
+    return (size_t) hash & (table->capacity - 1);
+}
+
+/**
+ * Finds the slot holding a pair of (already ordered) keys,
+ * or the empty slot where it would be inserted.
+ */
+size_t pair_find_slot(pair_table_t *table, void *key1, void *key2) {
+    size_t slot = pair_home_slot(table, key1, key2);
+    while (table->entries[slot].key1 != NULL
+           && (table->entries[slot].key1 != key1 || table->entries[slot].key2 != key2)) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    return slot;
+}
+
+void allocate_pair_entries(pair_table_t *table, size_t capacity) {
+    table->entries = calloc(capacity, sizeof(pair_entry_t));
+    assert(table->entries != NULL);
+    table->capacity = capacity;
+}
+
+void resize_pair_table(pair_table_t *table) {
+    pair_entry_t *old_entries = table->entries;
+    size_t old_capacity = table->capacity;
+    allocate_pair_entries(table, TABLE_GROWTH_FACTOR * old_capacity);
+    for (size_t i = 0; i < old_capacity; i++) {
+        pair_entry_t entry = old_entries[i];
+        if (entry.key1 != NULL) {
+            table->entries[pair_find_slot(table, entry.key1, entry.key2)] = entry;
+        }
+    }
+    free(old_entries);
+}
+
+pair_table_t *pair_table_init(size_t initial_size, free_func_t freer) {
+    pair_table_t *table = malloc(sizeof(pair_table_t));
+    assert(table != NULL);
+
+    // round the capacity up to a power of 2 so slots can be found with a mask
+    size_t capacity = 1;
+    while (capacity < MAX_LOAD_FACTOR * initial_size) {
+        capacity *= 2;
+    }
+    allocate_pair_entries(table, capacity);
+    table->size = 0;
+    table->freer = freer == NULL ? null_free : freer;
+    return table;
+}
+
+void pair_table_free(pair_table_t *table) {
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->entries[i].key1 != NULL) {
+            table->freer(table->entries[i].value);
+        }
+    }
+    free(table->entries);
+    free(table);
+}
+
+size_t pair_table_size(pair_table_t *table) {
+    return table->size;
+}
+
+void *pair_table_get(pair_table_t *table, void *key1, void *key2) {
+    order_pair_keys(&key1, &key2);
+    return table->entries[pair_find_slot(table, key1, key2)].value;
+}
+
+void pair_table_put(pair_table_t *table, void *key1, void *key2, void *value) {
+    assert(key1 != NULL && key2 != NULL && value != NULL);
+    if (MAX_LOAD_FACTOR * (table->size + 1) > table->capacity) {
+        resize_pair_table(table);
+    }
+
+    order_pair_keys(&key1, &key2);
+    size_t slot = pair_find_slot(table, key1, key2);
+    assert(table->entries[slot].key1 == NULL);
+    table->entries[slot] = (pair_entry_t) {key1, key2, value};
+    table->size++;
+}
+
+void *pair_table_remove(pair_table_t *table, void *key1, void *key2) {
+    order_pair_keys(&key1, &key2);
+    size_t mask = table->capacity - 1;
+    size_t hole = pair_find_slot(table, key1, key2);
+    void *value = table->entries[hole].value;
+    if (value == NULL) {
+        return NULL;
+    }
+
+    // shift later entries of the probe sequence back so lookups never stop
+    // early at the slot we just emptied
+    size_t slot = (hole + 1) & mask;
+    while (table->entries[slot].key1 != NULL) {
+        pair_entry_t entry = table->entries[slot];
+        size_t home = pair_home_slot(table, entry.key1, entry.key2);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            table->entries[hole] = entry;
+            hole = slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    table->entries[hole] = (pair_entry_t) {NULL, NULL, NULL};
+    table->size--;
+    return value;
+}
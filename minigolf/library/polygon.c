@@ -1,4 +1,5 @@
 #include "polygon.h"
+#include <assert.h>
 #include <math.h>
 #include <stdlib.h>
 #include "list.h"
@@ -9,94 +10,270 @@
 const double RADIUS_RATIO = 0.200811 / 0.525731;
 const double AREA_FACTOR = 2;
 const double CENTROID_FACTOR = 6;
+const size_t BINARY_PROJECTION_MIN_VERTICES = 64;
 
 vector_t *get_vector_from_polygon(list_t *polygon, size_t i) {
     return (vector_t *)list_get(polygon, i);
 }
 
-double polygon_area(list_t *polygon) {
+/**
+ * Reads the ith vertex of a polygon stored in some container,
+ * so that the list and array functions can share one loop.
+ */
+typedef vector_t (*vertex_getter_t)(const void *polygon, size_t i);
+
+vector_t list_polygon_vertex(const void *polygon, size_t i) {
+    return *get_vector_from_polygon((list_t *) polygon, i);
+}
+
+vector_t array_polygon_vertex(const void *polygon, size_t i) {
+    return ((const vector_t *) polygon)[i];
+}
+
+double polygon_vertices_area(const void *polygon, size_t length,
+    vertex_getter_t get) {
+
     double area = 0;
-    size_t num_vertices = list_size(polygon);
-    if (num_vertices > 2) {
-        size_t i = 0;
-        for (i = 0; i < num_vertices - 1; i++) {
-            area += (get_vector_from_polygon(polygon, i + 1)->x +
-                     get_vector_from_polygon(polygon, i)->x) *
-                    (get_vector_from_polygon(polygon, i + 1)->y -
-                     get_vector_from_polygon(polygon, i)->y);
+    for (size_t i = 0; i < length; i++) {
+        area += vec_cross(get(polygon, i), get(polygon, (i + 1) % length));
+    }
+    return fabs(area) / AREA_FACTOR;
+}
+
+vector_t polygon_vertices_centroid(const void *polygon, size_t length,
+    vertex_getter_t get) {
+
+    // the sums have the sign of the polygon's orientation, which cancels out
+    double area = 0;
+    vector_t sum = VEC_ZERO;
+    for (size_t i = 0; i < length; i++) {
+        vector_t vertex = get(polygon, i);
+        vector_t next = get(polygon, (i + 1) % length);
+        double cross = vec_cross(vertex, next);
+        area += cross;
+        sum = vec_add(sum, vec_multiply(cross, vec_add(vertex, next)));
+    }
+    return vec_multiply(AREA_FACTOR / (CENTROID_FACTOR * area), sum);
+}
+
+bool polygon_vertices_is_convex(const void *polygon, size_t length,
+    vertex_getter_t get) {
+
+    bool has_left_turn = false;
+    bool has_right_turn = false;
+    for (size_t i = 0; i < length; i++) {
+        vector_t next = get(polygon, (i + 1) % length);
+        double turn = vec_cross(vec_subtract(next, get(polygon, i)),
+            vec_subtract(get(polygon, (i + 2) % length), next));
+        if (turn > 0) {
+            has_left_turn = true;
+        }
+        else if (turn < 0) {
+            has_right_turn = true;
         }
-        area += (get_vector_from_polygon(polygon, 0)->x +
-                 get_vector_from_polygon(polygon, i)->x) *
-                (get_vector_from_polygon(polygon, 0)->y -
-                 get_vector_from_polygon(polygon, i)->y);
     }
-    return 1 / AREA_FACTOR * fabs(area);
+    return !(has_left_turn && has_right_turn);
 }
 
-vector_t polygon_centroid(list_t *polygon) {
-    size_t length = list_size(polygon);
+void polygon_vertices_edge_normals(const void *polygon, size_t length,
+    vertex_getter_t get, vector_t *normals) {
+
+    for (size_t i = 0; i < length; i++) {
+        vector_t edge = vec_subtract(get(polygon, (i + 1) % length),
+            get(polygon, i));
+        double magnitude = sqrt(vec_dot(edge, edge));
+        normals[i] = (vector_t) {-edge.y / magnitude, edge.x / magnitude};
+    }
+}
+
+vector_t polygon_vertices_project(const void *polygon, size_t length,
+    vertex_getter_t get, vector_t axis) {
 
-    double area = polygon_area(polygon);
-
-    double c_x = 0;
-    double c_y = 0;
-
-    size_t i = 0;
-    for (i = 0; i < length - 1; i++) {
-        double x_i = get_vector_from_polygon(polygon, i)->x;
-        double x_next_i = get_vector_from_polygon(polygon, i + 1)->x;
-        double y_i = get_vector_from_polygon(polygon, i)->y;
-        double y_next_i = get_vector_from_polygon(polygon, i + 1)->y;
-
-        c_x += 1 / (CENTROID_FACTOR * area) * (x_i + x_next_i) * (x_i * y_next_i - x_next_i * y_i);
-        c_y += 1 / (CENTROID_FACTOR * area) * (y_i + y_next_i) * (x_i * y_next_i - x_next_i * y_i);
-    }
-    // account for the edge between the last and first vertex in the polygon list
-    c_x +=
-        1 / (CENTROID_FACTOR * area) *
-        (get_vector_from_polygon(polygon, i)->x +
-         get_vector_from_polygon(polygon, 0)->x) *
-        (get_vector_from_polygon(polygon, i)->x * get_vector_from_polygon(polygon, 0)->y -
-         get_vector_from_polygon(polygon, 0)->x *
-             get_vector_from_polygon(polygon, length - 1)->y);
-    c_y +=
-        1 / (CENTROID_FACTOR * area) *
-        (get_vector_from_polygon(polygon, i)->y +
-         get_vector_from_polygon(polygon, 0)->y) *
-        (get_vector_from_polygon(polygon, i)->x * get_vector_from_polygon(polygon, 0)->y -
-         get_vector_from_polygon(polygon, 0)->x *
-             get_vector_from_polygon(polygon, length - 1)->y);
-
-    vector_t centroid = {c_x, c_y};
-    return centroid;
+    assert(length > 0);
+    double min_projection = vec_dot(axis, get(polygon, 0));
+    double max_projection = min_projection;
+    for (size_t i = 1; i < length; i++) {
+        double projection = vec_dot(axis, get(polygon, i));
+        min_projection = fmin(min_projection, projection);
+        max_projection = fmax(max_projection, projection);
+    }
+    return (vector_t) {min_projection, max_projection};
+}
+
+// The list functions and the polygon_array_* functions of the same name
+// share the loops above, reading the vertices in place.
+
+double polygon_area(list_t *polygon) {
+    return polygon_vertices_area(polygon, list_size(polygon),
+        list_polygon_vertex);
+}
+
+vector_t polygon_centroid(list_t *polygon) {
+    return polygon_vertices_centroid(polygon, list_size(polygon),
+        list_polygon_vertex);
 }
 
 void polygon_translate(list_t *polygon, vector_t translation) {
     size_t length = list_size(polygon);
-
     for (size_t i = 0; i < length; i++) {
         vector_t *vertex = get_vector_from_polygon(polygon, i);
-        vector_t new_vec = vec_add(*vertex, translation);
-        vertex->x = new_vec.x;
-        vertex->y = new_vec.y;
+        *vertex = vec_add(*vertex, translation);
     }
 }
 
 void polygon_rotate(list_t *polygon, double angle, vector_t point) {
     size_t length = list_size(polygon);
-
-    // translate each vertex so that the point of rotation is at the origin,
-    // rotate, and then undo the translation
-    vector_t translation_vec = vec_negate(point);
     for (size_t i = 0; i < length; i++) {
         vector_t *vertex = get_vector_from_polygon(polygon, i);
-        vector_t new_vec = vec_add(*vertex, translation_vec);
-        new_vec = vec_rotate(new_vec, angle);
-        new_vec = vec_add(new_vec, point);
+        *vertex = vec_add(vec_rotate(vec_subtract(*vertex, point), angle),
+            point);
+    }
+}
+
+bool polygon_is_convex(list_t *polygon) {
+    return polygon_vertices_is_convex(polygon, list_size(polygon),
+        list_polygon_vertex);
+}
+
+void polygon_edge_normals(list_t *polygon, vector_t *normals) {
+    polygon_vertices_edge_normals(polygon, list_size(polygon),
+        list_polygon_vertex, normals);
+}
+
+void polygon_copy_vertices(list_t *polygon, vector_t *vertices) {
+    size_t length = list_size(polygon);
+    for (size_t i = 0; i < length; i++) {
+        vertices[i] = *get_vector_from_polygon(polygon, i);
+    }
+}
+
+vector_t polygon_project(list_t *polygon, vector_t axis) {
+    return polygon_vertices_project(polygon, list_size(polygon),
+        list_polygon_vertex, axis);
+}
+
+/**
+ * Returns 1 if a convex polygon is counterclockwise, -1 if it is clockwise,
+ * or 0 if all of its vertices are collinear.
+ * Only looks as far as the first turn, which is usually the first vertex.
+ */
+int convex_winding(const void *polygon, size_t length, vertex_getter_t get) {
+    for (size_t i = 0; i < length; i++) {
+        vector_t vertex = get(polygon, i);
+        vector_t next = get(polygon, (i + 1) % length);
+        vector_t after = get(polygon, (i + 2) % length);
+        double turn = vec_cross(vec_subtract(next, vertex),
+            vec_subtract(after, next));
+        if (turn != 0) {
+            return turn > 0 ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Gets the ith vertex of a polygon in counterclockwise order,
+ * given the polygon's winding from convex_winding().
+ */
+vector_t counterclockwise_vertex(const void *polygon, size_t length,
+    vertex_getter_t get, int winding, size_t i) {
+
+    size_t index = winding > 0 ? i % length : (length - i % length) % length;
+    return get(polygon, index);
+}
+
+/**
+ * Returns whether direction a comes before direction b,
+ * measuring angles counterclockwise from reference in [0, 2 pi).
+ */
+bool angle_before(vector_t reference, vector_t a, vector_t b) {
+    double cross_a = vec_cross(reference, a);
+    double cross_b = vec_cross(reference, b);
+    bool a_in_second_half =
+        cross_a < 0 || (cross_a == 0 && vec_dot(reference, a) < 0);
+    bool b_in_second_half =
+        cross_b < 0 || (cross_b == 0 && vec_dot(reference, b) < 0);
+    if (a_in_second_half != b_in_second_half) {
+        return b_in_second_half;
+    }
+    return vec_cross(a, b) > 0;
+}
 
-        vertex->x = new_vec.x;
-        vertex->y = new_vec.y;
+/**
+ * Finds the first edge of a polygon, in counterclockwise order, at or after
+ * edge *index that has a nonzero length, and sets *index to it.
+ * Sets *index to length if every edge from *index on has zero length.
+ */
+vector_t next_nonzero_edge(const void *polygon, size_t length,
+    vertex_getter_t get, int winding, size_t *index) {
+
+    for (; *index < length; (*index)++) {
+        vector_t edge = vec_subtract(
+            counterclockwise_vertex(polygon, length, get, winding, *index + 1),
+            counterclockwise_vertex(polygon, length, get, winding, *index));
+        if (edge.x != 0 || edge.y != 0) {
+            return edge;
+        }
     }
+    return VEC_ZERO;
+}
+
+/**
+ * Finds the largest projection of a convex polygon onto an axis.
+ * Walking counterclockwise, the edges turn steadily from the first edge,
+ * and the furthest vertex starts the first edge that has turned past the
+ * axis rotated a quarter turn counterclockwise (the edges before it head
+ * along the axis, and the edges after it head back), so that edge is found
+ * by binary search on the edges' angles from the first edge.
+ * An edge of length zero has no angle, so it is searched as if it had
+ * the angle of the next edge that does.
+ */
+double max_convex_projection(const void *polygon, size_t length,
+    vertex_getter_t get, int winding, vector_t axis) {
+
+    size_t first = 0;
+    vector_t first_edge =
+        next_nonzero_edge(polygon, length, get, winding, &first);
+    vector_t target = {-axis.y, axis.x};
+
+    size_t low = 0;
+    size_t high = length;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        size_t next = middle;
+        vector_t edge = next_nonzero_edge(polygon, length, get, winding, &next);
+        if (next < length && angle_before(first_edge, edge, target)) {
+            // the edges from middle to next all come before the target
+            low = next + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    // if every edge comes before the target, the edges wrap around to vertex 0
+    return vec_dot(axis,
+        counterclockwise_vertex(polygon, length, get, winding, low));
+}
+
+vector_t polygon_vertices_project_convex(const void *polygon, size_t length,
+    vertex_getter_t get, vector_t axis) {
+
+    if (length < BINARY_PROJECTION_MIN_VERTICES) {
+        return polygon_vertices_project(polygon, length, get, axis);
+    }
+    int winding = convex_winding(polygon, length, get);
+    if (winding == 0) {
+        return polygon_vertices_project(polygon, length, get, axis);
+    }
+    return (vector_t) {
+        -max_convex_projection(polygon, length, get, winding, vec_negate(axis)),
+        max_convex_projection(polygon, length, get, winding, axis)
+    };
+}
+
+vector_t polygon_project_convex(list_t *polygon, vector_t axis) {
+    return polygon_vertices_project_convex(polygon, list_size(polygon),
+        list_polygon_vertex, axis);
 }
 
 list_t *star_init(double radius, size_t num_points) {
@@ -122,3 +299,81 @@ list_t *star_init(double radius, size_t num_points) {
     }
     return points;
 }
+
+double polygon_array_area(const vec_array_t *polygon) {
+    return polygon_vertices_area(vec_array_data(polygon),
+        vec_array_size(polygon), array_polygon_vertex);
+}
+
+vector_t polygon_array_centroid(const vec_array_t *polygon) {
+    return polygon_vertices_centroid(vec_array_data(polygon),
+        vec_array_size(polygon), array_polygon_vertex);
+}
+
+void polygon_array_translate(vec_array_t *polygon, vector_t translation) {
+    size_t length = vec_array_size(polygon);
+    for (size_t i = 0; i < length; i++) {
+        vec_array_set(polygon, i,
+            vec_add(vec_array_get(polygon, i), translation));
+    }
+}
+
+void polygon_array_rotate(vec_array_t *polygon, double angle, vector_t point) {
+    size_t length = vec_array_size(polygon);
+    for (size_t i = 0; i < length; i++) {
+        vector_t offset = vec_subtract(vec_array_get(polygon, i), point);
+        vec_array_set(polygon, i, vec_add(vec_rotate(offset, angle), point));
+    }
+}
+
+void polygon_array_transform(const vec_array_t *polygon, double angle,
+    vector_t position, vec_array_t *result) {
+    size_t length = vec_array_size(polygon);
+    assert(vec_array_size(result) == length);
+    const vector_t *points = vec_array_data(polygon);
+    double cos_angle = cos(angle);
+    double sin_angle = sin(angle);
+    for (size_t i = 0; i < length; i++) {
+        vector_t rotated = {
+            points[i].x * cos_angle - points[i].y * sin_angle,
+            points[i].x * sin_angle + points[i].y * cos_angle
+        };
+        vec_array_set(result, i, vec_add(position, rotated));
+    }
+}
+
+bool polygon_array_is_convex(const vec_array_t *polygon) {
+    return polygon_vertices_is_convex(vec_array_data(polygon),
+        vec_array_size(polygon), array_polygon_vertex);
+}
+
+void polygon_array_edge_normals(const vec_array_t *polygon, vector_t *normals) {
+    polygon_vertices_edge_normals(vec_array_data(polygon),
+        vec_array_size(polygon), array_polygon_vertex, normals);
+}
+
+vector_t polygon_array_project(const vec_array_t *polygon, vector_t axis) {
+    return polygon_vertices_project(vec_array_data(polygon),
+        vec_array_size(polygon), array_polygon_vertex, axis);
+}
+
+vector_t polygon_array_project_convex(const vec_array_t *polygon,
+    vector_t axis) {
+
+    return polygon_vertices_project_convex(vec_array_data(polygon),
+        vec_array_size(polygon), array_polygon_vertex, axis);
+}
+
+vec_array_t *star_array_init(double radius, size_t num_points) {
+    vec_array_t *points = vec_array_init(2 * num_points);
+    vector_t vertex = {0, radius};
+    vec_array_add(points, vertex);
+    for (size_t i = 0; i < 2 * num_points - 1; i++) {
+        vertex = vec_rotate(vertex, M_PI / num_points);
+        // switch off between building outer and inner points of the star
+        vertex = vec_multiply(i % 2 == 1 ? RADIUS_RATIO : 1 / RADIUS_RATIO,
+            vertex);
+        vec_array_add(points, vertex);
+    }
+    return points;
+}
@@ -1,25 +1,169 @@
 #include "forces.h"
 #include "scene.h"
 #include "force_aux.h"
+#include "pair_table.h"
+#include "collision.h"
+#include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 
+/**
+ * A handler registered with scene_add_contact_handler(), or with
+ * scene_register_collision_handler() if body1 is NULL.
+ * body1, or else the body of type type1, is the body passed to the handler
+ * first, which the handler's axis points away from.
+ */
+typedef struct contact_listener {
+    contact_event_kind_t kind;
+    contact_handler_t handler;
+    body_t *body1;
+    size_t type1;
+    void *aux;
+    free_func_t freer;
+} contact_listener_t;
+
+/**
+ * The state of a pair of bodies with contact handlers or a physics contact,
+ * or whose types have either and are touching.
+ * touching is whether they collided the last time they were checked,
+ * which was on tick last_tick if so, and normal is the axis they collided on
+ * and depth how far they overlapped along it.
+ * tracked is whether the pair is in the scene's list of touching contacts,
+ * and registered is whether the contact was added for this pair of bodies
+ * rather than created for their types, so it is kept once they separate.
+ */
+typedef struct contact {
+    body_t *body1;
+    body_t *body2;
+    list_t *listeners;
+    // the axis to try first, see find_body_collision_cached()
+    vector_t axis_cache;
+    vector_t normal;
+    double depth;
+    bool touching;
+    bool tracked;
+    bool registered;
+    size_t last_tick;
+    // whether the solver keeps the bodies apart,
+    // see scene_add_physics_contact()
+    bool solid;
+    double elasticity;
+    // the total normal impulse the solver applied to the contact last,
+    // which warm starts it on the next tick it is touching
+    double normal_impulse;
+    // the inverse of the bodies' combined inverse masses and the relative
+    // normal velocity the solver aims for this tick
+    double normal_mass;
+    double target_velocity;
+} contact_t;
+
+/**
+ * What happens when bodies of two collision types touch: the handlers
+ * registered between the types, or NULL if there are none, and whether
+ * the solver keeps them apart (see scene_register_physics_contact()).
+ */
+typedef struct type_pair {
+    list_t *listeners;
+    bool solid;
+    double elasticity;
+} type_pair_t;
+
+/**
+ * A body overlapping a sensor, found by the sensor stage on tick last_tick.
+ */
+typedef struct sensor_overlap {
+    body_t *sensor;
+    body_t *body;
+    size_t last_tick;
+} sensor_overlap_t;
+
 typedef struct scene {
+    // the bodies in the order they were added, as handles into the store
+    // that holds the state integrated every tick
     list_t *body_list;
+    body_store_t *bodies;
+    // where each body swept under continuous collisions started this tick,
+    // indexed like body_list
+    vector_t *sweep_starts;
+    size_t sweep_capacity;
     list_t *force_list;
     list_t *force_bodies_list;
     list_t *aux_list;
     list_t *free_list;
+    // every contact, and a map from each pair of bodies to its contact
+    list_t *contact_list;
+    pair_table_t *contacts;
+    // the contacts that may still be touching, to find the ones that ended
+    list_t *touching_contacts;
+    // a type_count by type_count table of what happens between each pair
+    // of collision types; only the entries for type1 <= type2 are used
+    type_pair_t *type_pairs;
+    size_t type_count;
+    // the solid contacts being solved this tick
+    list_t *solver_contacts;
+    // every body overlapping a sensor, and a map from each pair to its overlap
+    list_t *sensor_overlaps;
+    pair_table_t *sensor_pairs;
+    // sensor events not yet taken by scene_poll_sensor_event(), oldest first
+    list_t *sensor_events;
+    broad_phase_t *broad_phase;
+    // whether the broad phase has the bounds the bodies moved to this tick,
+    // which continuous collisions bring about before their first query
+    bool broad_phase_current;
+    double cell_size;
+    size_t ticks;
+    bool continuous;
 } scene_t;
 
 const size_t INITIAL = 10;
+// most impacts a body is stopped at in one tick under continuous collisions
+const size_t MAX_IMPACTS_PER_TICK = 4;
+// how far past the time of impact a body is stopped, as a distance,
+// so that the narrow phase sees the bodies touching
+const double IMPACT_SLOP = 1e-6;
+// passes the contact solver makes over the solid contacts each tick
+const size_t SOLVER_ITERATIONS = 8;
+// slowest approach along the normal that solid contacts bounce from, so that
+// bodies resting under gravity settle instead of bouncing forever
+const double RESTITUTION_THRESHOLD = 1;
+// overlap left between bodies by positional correction, so that their
+// contact persists instead of ending and beginning again
+const double CORRECTION_SLOP = 0.01;
+
+void contact_listener_free(contact_listener_t *listener) {
+    listener->freer(listener->aux);
+    free(listener);
+}
+
+void contact_free(contact_t *contact) {
+    list_free(contact->listeners);
+    free(contact);
+}
 
 scene_t *scene_init(void) {
     scene_t *scene = malloc(sizeof(scene_t));
     scene->body_list = list_init(INITIAL, (free_func_t)body_free);
+    scene->bodies = body_store_init(INITIAL);
+    scene->sweep_starts = NULL;
+    scene->sweep_capacity = 0;
     scene->force_list = list_init(INITIAL, (free_func_t)null_free);
     scene->force_bodies_list = list_init(INITIAL, (free_func_t)list_free);
     scene->aux_list = list_init(INITIAL, (free_func_t)null_free);
     scene->free_list = list_init(INITIAL, (free_func_t)null_free);
+    scene->contact_list = list_init(INITIAL, (free_func_t)contact_free);
+    scene->contacts = pair_table_init(INITIAL, (free_func_t)null_free);
+    scene->touching_contacts = list_init(INITIAL, (free_func_t)null_free);
+    scene->type_pairs = NULL;
+    scene->type_count = 0;
+    scene->solver_contacts = list_init(INITIAL, (free_func_t)null_free);
+    scene->sensor_overlaps = list_init(INITIAL, free);
+    scene->sensor_pairs = pair_table_init(INITIAL, (free_func_t)null_free);
+    scene->sensor_events = list_init(INITIAL, free);
+    scene->broad_phase = broad_phase_init(BROAD_PHASE_SPATIAL_HASH);
+    scene->cell_size = 0;
+    scene->ticks = 0;
+    scene->continuous = false;
+    scene->broad_phase_current = false;
     return scene;
 }
 
@@ -31,8 +175,24 @@ void scene_free(scene_t *scene) {
     list_free(scene->aux_list);
     list_free(scene->force_list);
     list_free(scene->body_list);
+    body_store_free(scene->bodies);
+    free(scene->sweep_starts);
     list_free(scene->force_bodies_list); //problem child
     list_free(scene->free_list);
+    list_free(scene->contact_list);
+    pair_table_free(scene->contacts);
+    list_free(scene->touching_contacts);
+    for (size_t i = 0; i < scene->type_count * scene->type_count; i++) {
+        if (scene->type_pairs[i].listeners != NULL) {
+            list_free(scene->type_pairs[i].listeners);
+        }
+    }
+    free(scene->type_pairs);
+    list_free(scene->solver_contacts);
+    list_free(scene->sensor_overlaps);
+    pair_table_free(scene->sensor_pairs);
+    list_free(scene->sensor_events);
+    broad_phase_free(scene->broad_phase);
     free(scene);
 }
 
@@ -46,6 +206,8 @@ body_t *scene_get_body(scene_t *scene, size_t index) {
 
 void scene_add_body(scene_t *scene, body_t *body) {
     list_add(scene->body_list, body);
+    body_store_add(scene->bodies, body);
+    broad_phase_add(scene->broad_phase, body);
 }
 
 /**
@@ -79,17 +241,798 @@ void scene_add_bodies_force_creator(scene_t *scene, force_creator_t forcer,
     list_add(scene->free_list, freer);
 }
 
+/**
+ * Adds a contact between two bodies to a scene, which has no handlers yet.
+ */
+contact_t *contact_init(scene_t *scene, body_t *body1, body_t *body2,
+    vector_t axis_cache) {
+
+    contact_t *contact = malloc(sizeof(contact_t));
+    assert(contact != NULL);
+    contact->body1 = body1;
+    contact->body2 = body2;
+    contact->listeners = list_init(0, (free_func_t)contact_listener_free);
+    contact->axis_cache = axis_cache;
+    contact->normal = VEC_ZERO;
+    contact->depth = 0;
+    contact->touching = false;
+    contact->tracked = false;
+    contact->registered = false;
+    contact->last_tick = 0;
+    contact->solid = false;
+    contact->elasticity = 0;
+    contact->normal_impulse = 0;
+    contact->normal_mass = 0;
+    contact->target_velocity = 0;
+    list_add(scene->contact_list, contact);
+    pair_table_put(scene->contacts, body1, body2, contact);
+    return contact;
+}
+
+contact_listener_t *contact_listener_init(contact_event_kind_t kind,
+    contact_handler_t handler, body_t *body1, size_t type1, void *aux,
+    free_func_t freer) {
+
+    contact_listener_t *listener = malloc(sizeof(contact_listener_t));
+    assert(listener != NULL);
+    listener->kind = kind;
+    listener->handler = handler;
+    listener->body1 = body1;
+    listener->type1 = type1;
+    listener->aux = aux;
+    listener->freer = freer == NULL ? null_free : freer;
+    return listener;
+}
+
+/**
+ * Gets the contact between two bodies, adding it if there is none,
+ * and marks it as registered for them.
+ */
+contact_t *get_registered_contact(scene_t *scene, body_t *body1,
+    body_t *body2) {
+
+    contact_t *contact = pair_table_get(scene->contacts, body1, body2);
+    if (contact == NULL) {
+        contact = contact_init(scene, body1, body2, VEC_ZERO);
+    }
+    contact->registered = true;
+    return contact;
+}
+
+void scene_add_contact_handler(scene_t *scene, body_t *body1, body_t *body2,
+    contact_event_kind_t kind, contact_handler_t handler, void *aux,
+    free_func_t freer) {
+
+    contact_t *contact = get_registered_contact(scene, body1, body2);
+    list_add(contact->listeners,
+        contact_listener_init(kind, handler, body1, 0, aux, freer));
+}
+
+void scene_add_physics_contact(scene_t *scene, body_t *body1, body_t *body2,
+    double elasticity) {
+
+    contact_t *contact = get_registered_contact(scene, body1, body2);
+    contact->solid = true;
+    contact->elasticity = elasticity;
+}
+
+/**
+ * Gets what happens between two collision types,
+ * or NULL if nothing was registered between them.
+ */
+type_pair_t *get_type_pair(scene_t *scene, size_t type1, size_t type2) {
+    size_t low = type1 < type2 ? type1 : type2;
+    size_t high = type1 < type2 ? type2 : type1;
+    if (high >= scene->type_count) {
+        return NULL;
+    }
+    type_pair_t *pair = &scene->type_pairs[low * scene->type_count + high];
+    return pair->listeners != NULL || pair->solid ? pair : NULL;
+}
+
+/**
+ * Gets the entry for two collision types, growing the table to fit them.
+ */
+type_pair_t *add_type_pair(scene_t *scene, size_t type1, size_t type2) {
+    size_t low = type1 < type2 ? type1 : type2;
+    size_t high = type1 < type2 ? type2 : type1;
+    if (high >= scene->type_count) {
+        size_t count = high + 1;
+        type_pair_t *table = calloc(count * count, sizeof(type_pair_t));
+        assert(table != NULL);
+        for (size_t i = 0; i < scene->type_count; i++) {
+            for (size_t j = i; j < scene->type_count; j++) {
+                table[i * count + j] =
+                    scene->type_pairs[i * scene->type_count + j];
+            }
+        }
+        free(scene->type_pairs);
+        scene->type_pairs = table;
+        scene->type_count = count;
+    }
+    return &scene->type_pairs[low * scene->type_count + high];
+}
+
+void scene_register_collision_handler(scene_t *scene, size_t type1,
+    size_t type2, contact_event_kind_t kind, contact_handler_t handler,
+    void *aux, free_func_t freer) {
+
+    type_pair_t *pair = add_type_pair(scene, type1, type2);
+    if (pair->listeners == NULL) {
+        pair->listeners = list_init(1, (free_func_t)contact_listener_free);
+    }
+    list_add(pair->listeners,
+        contact_listener_init(kind, handler, NULL, type1, aux, freer));
+}
+
+void scene_register_physics_contact(scene_t *scene, size_t type1,
+    size_t type2, double elasticity) {
+
+    type_pair_t *pair = add_type_pair(scene, type1, type2);
+    pair->solid = true;
+    pair->elasticity = elasticity;
+}
+
+bool scene_bodies_touching(scene_t *scene, body_t *body1, body_t *body2) {
+    contact_t *contact = pair_table_get(scene->contacts, body1, body2);
+    return contact != NULL && contact->touching;
+}
+
+void scene_set_broad_phase(scene_t *scene, broad_phase_kind_t kind) {
+    broad_phase_free(scene->broad_phase);
+    scene->broad_phase = broad_phase_init(kind);
+    broad_phase_set_cell_size(scene->broad_phase, scene->cell_size);
+    for (size_t i = 0; i < list_size(scene->body_list); i++) {
+        broad_phase_add(scene->broad_phase, list_get(scene->body_list, i));
+    }
+}
+
+void scene_set_grid_cell_size(scene_t *scene, double cell_size) {
+    scene->cell_size = cell_size;
+    broad_phase_set_cell_size(scene->broad_phase, cell_size);
+}
+
+void scene_set_continuous_collisions(scene_t *scene, bool enabled) {
+    scene->continuous = enabled;
+}
+
+/**
+ * Calls each of a list of handlers that is for an event, flipping the axis
+ * for handlers that take the contact's bodies in the other order.
+ */
+void notify_listeners(list_t *listeners, contact_t *contact,
+    contact_event_kind_t kind, vector_t axis,
+    const contact_manifold_t *manifold) {
+
+    for (size_t i = 0; i < list_size(listeners); i++) {
+        contact_listener_t *listener = list_get(listeners, i);
+        if (listener->kind != kind) {
+            continue;
+        }
+        bool forward = listener->body1 != NULL
+            ? listener->body1 == contact->body1
+            : listener->type1 == body_get_collision_type(contact->body1);
+        if (forward) {
+            listener->handler(contact->body1, contact->body2, axis, manifold,
+                listener->aux);
+        }
+        else {
+            listener->handler(contact->body2, contact->body1, vec_negate(axis),
+                manifold, listener->aux);
+        }
+    }
+}
+
+/**
+ * Calls the handlers of a contact and of its bodies' types for an event.
+ */
+void dispatch_contact(scene_t *scene, contact_t *contact,
+    contact_event_kind_t kind, vector_t axis,
+    const contact_manifold_t *manifold) {
+
+    notify_listeners(contact->listeners, contact, kind, axis, manifold);
+    type_pair_t *pair = get_type_pair(scene,
+        body_get_collision_type(contact->body1),
+        body_get_collision_type(contact->body2));
+    if (pair != NULL && pair->listeners != NULL) {
+        notify_listeners(pair->listeners, contact, kind, axis, manifold);
+    }
+}
+
+/**
+ * Removes and frees a contact that is not in the list of touching contacts.
+ */
+void remove_contact(scene_t *scene, contact_t *contact) {
+    pair_table_remove(scene->contacts, contact->body1, contact->body2);
+    for (size_t i = 0; i < list_size(scene->contact_list); i++) {
+        if (list_get(scene->contact_list, i) == contact) {
+            list_remove(scene->contact_list, i);
+            break;
+        }
+    }
+    contact_free(contact);
+}
+
+/**
+ * Runs the narrow phase on two bodies if they have a contact or something
+ * registered between their types, and calls the handlers for whether
+ * the contact began, persisted, or ended.
+ * Bodies with only type registrations get a contact when they begin touching,
+ * which is solid if their types are.
+ * Returns the bodies' contact, or NULL if they have none.
+ */
+contact_t *update_contact(scene_t *scene, body_t *body1, body_t *body2) {
+    if (!body_can_collide(body1, body2)
+        || body_is_sensor(body1) || body_is_sensor(body2)) {
+        return NULL;
+    }
+    contact_t *contact = pair_table_get(scene->contacts, body1, body2);
+    vector_t new_cache = VEC_ZERO;
+    vector_t *axis_cache = &new_cache;
+    if (contact != NULL) {
+        body1 = contact->body1;
+        body2 = contact->body2;
+        axis_cache = &contact->axis_cache;
+    }
+    type_pair_t *pair = get_type_pair(scene, body_get_collision_type(body1),
+        body_get_collision_type(body2));
+    if (contact == NULL && pair == NULL) {
+        return NULL;
+    }
+
+    contact_manifold_t manifold;
+    collision_info_t info =
+        find_body_collision_manifold(body1, body2, axis_cache, &manifold);
+    if (contact == NULL) {
+        if (!info.collided) {
+            return NULL;
+        }
+        contact = contact_init(scene, body1, body2, new_cache);
+        contact->solid = pair->solid;
+        contact->elasticity = pair->elasticity;
+    }
+    else if (!contact->solid && pair != NULL && pair->solid) {
+        contact->solid = true;
+        contact->elasticity = pair->elasticity;
+    }
+    if (info.collided) {
+        bool began = !contact->touching;
+        if (began) {
+            contact->normal_impulse = 0;
+        }
+        contact->touching = true;
+        contact->normal = info.axis;
+        contact->depth = manifold.depth;
+        contact->last_tick = scene->ticks;
+        if (!contact->tracked) {
+            contact->tracked = true;
+            list_add(scene->touching_contacts, contact);
+        }
+        dispatch_contact(scene, contact,
+            began ? CONTACT_BEGIN : CONTACT_PERSIST, info.axis, &manifold);
+    }
+    else if (contact->touching) {
+        contact->touching = false;
+        dispatch_contact(scene, contact, CONTACT_END, contact->normal, NULL);
+    }
+    return contact;
+}
+
+/**
+ * Ends the contacts that were touching but whose bodies' bounding boxes
+ * no longer overlap, so the collision stage did not check them this tick,
+ * and stops tracking the contacts that are no longer touching.
+ * Contacts that were only created for their bodies' types are removed.
+ */
+void end_contacts(scene_t *scene) {
+    list_t *touching = scene->touching_contacts;
+    for (size_t i = 0; i < list_size(touching); i++) {
+        contact_t *contact = list_get(touching, i);
+        if (contact->touching && contact->last_tick == scene->ticks) {
+            continue;
+        }
+        if (contact->touching) {
+            contact->touching = false;
+            dispatch_contact(scene, contact, CONTACT_END, contact->normal,
+                NULL);
+        }
+        contact->tracked = false;
+        list_remove(touching, i);
+        i--;
+        if (!contact->registered) {
+            remove_contact(scene, contact);
+        }
+    }
+}
+
+/**
+ * Called by the broad phase on each pair of bodies whose bounding boxes
+ * overlap. Updates the bodies' contact, if they have one.
+ */
+void update_overlapping_pair(body_t *body1, body_t *body2, void *aux) {
+    update_contact(aux, body1, body2);
+}
+
+/**
+ * Updates the contacts between bodies that may be touching,
+ * then ends each contact that was not checked this tick.
+ */
+void run_collision_stage(scene_t *scene) {
+    scene->ticks++;
+    if (pair_table_size(scene->contacts) == 0 && scene->type_count == 0) {
+        return;
+    }
+    broad_phase_find_pairs(scene->broad_phase, scene->body_list,
+        update_overlapping_pair, scene);
+    end_contacts(scene);
+}
+
+/**
+ * Applies an impulse along a contact's normal, pushing body2 away from body1
+ * and body1 away from body2.
+ */
+void apply_normal_impulse(contact_t *contact, double impulse) {
+    vector_t pushed = vec_multiply(impulse, contact->normal);
+    body_add_impulse(contact->body1, vec_negate(pushed));
+    body_add_impulse(contact->body2, pushed);
+}
+
+/**
+ * Gets how fast a contact's bodies will be separating along its normal
+ * after a tick with the impulses and forces applied to them so far.
+ */
+double normal_velocity(contact_t *contact, double dt) {
+    vector_t relative = vec_subtract(body_get_next_velocity(contact->body2, dt),
+        body_get_next_velocity(contact->body1, dt));
+    return vec_dot(relative, contact->normal);
+}
+
+/**
+ * Sets up a solid contact for solving: its effective mass and the velocity
+ * to aim for, bouncing if the bodies approach faster than
+ * RESTITUTION_THRESHOLD. Returns false if neither body can move.
+ */
+bool prepare_contact(contact_t *contact, double dt) {
+    double inverse_masses = 1 / body_get_mass(contact->body1)
+        + 1 / body_get_mass(contact->body2);
+    if (inverse_masses == 0) {
+        return false;
+    }
+    contact->normal_mass = 1 / inverse_masses;
+    double velocity = normal_velocity(contact, dt);
+    contact->target_velocity = velocity < -RESTITUTION_THRESHOLD
+        ? -contact->elasticity * velocity
+        : 0;
+    return true;
+}
+
+/**
+ * Moves a contact's total normal impulse towards the one that gives it its
+ * target velocity, applying the difference.
+ * The total is clamped so that it only ever pushes the bodies apart.
+ */
+void solve_contact(contact_t *contact, double dt) {
+    double impulse = contact->normal_mass
+        * (contact->target_velocity - normal_velocity(contact, dt));
+    double total = fmax(contact->normal_impulse + impulse, 0);
+    apply_normal_impulse(contact, total - contact->normal_impulse);
+    contact->normal_impulse = total;
+}
+
+/**
+ * Queues corrections that push two overlapping bodies apart along the
+ * collision axis, leaving them overlapping by CORRECTION_SLOP.
+ * Each body moves in proportion to its inverse mass, so walls stay put.
+ */
+void correct_positions(body_t *body1, body_t *body2, vector_t axis,
+    double depth) {
+
+    double inverse_mass1 = 1 / body_get_mass(body1);
+    double inverse_mass2 = 1 / body_get_mass(body2);
+    double inverse_masses = inverse_mass1 + inverse_mass2;
+    if (inverse_masses == 0 || depth <= CORRECTION_SLOP) {
+        return;
+    }
+    vector_t correction =
+        vec_multiply((depth - CORRECTION_SLOP) / inverse_masses, axis);
+    body_add_correction(body1, vec_multiply(-inverse_mass1, correction));
+    body_add_correction(body2, vec_multiply(inverse_mass2, correction));
+}
+
+/**
+ * Solves every solid contact touching this tick together with sequential
+ * impulses: each contact is warm started with the impulse it ended last tick
+ * with, then SOLVER_ITERATIONS passes each correct one contact's velocity,
+ * so contacts sharing a body, as in a stack, settle together.
+ * Then queues corrections to push the bodies out of each other.
+ */
+void solve_contacts(scene_t *scene, double dt) {
+    list_t *solving = scene->solver_contacts;
+    list_t *touching = scene->touching_contacts;
+    for (size_t i = 0; i < list_size(touching); i++) {
+        contact_t *contact = list_get(touching, i);
+        if (contact->touching && contact->solid
+            && prepare_contact(contact, dt)) {
+            list_add(solving, contact);
+        }
+    }
+    // the targets are set before warm starting, from the velocities
+    // the bodies arrived with
+    for (size_t i = 0; i < list_size(solving); i++) {
+        contact_t *contact = list_get(solving, i);
+        apply_normal_impulse(contact, contact->normal_impulse);
+    }
+    for (size_t iteration = 0; iteration < SOLVER_ITERATIONS; iteration++) {
+        for (size_t i = 0; i < list_size(solving); i++) {
+            solve_contact(list_get(solving, i), dt);
+        }
+    }
+    while (list_size(solving) > 0) {
+        contact_t *contact = list_remove(solving, list_size(solving) - 1);
+        correct_positions(contact->body1, contact->body2, contact->normal,
+            contact->depth);
+    }
+}
+
+/**
+ * Removes and frees every contact involving a body, along with its handlers.
+ */
+void remove_contacts(scene_t *scene, body_t *body) {
+    for (size_t i = 0; i < list_size(scene->contact_list); i++) {
+        contact_t *contact = list_get(scene->contact_list, i);
+        if (contact->body1 != body && contact->body2 != body) {
+            continue;
+        }
+        pair_table_remove(scene->contacts, contact->body1, contact->body2);
+        if (contact->tracked) {
+            list_t *touching = scene->touching_contacts;
+            for (size_t j = 0; j < list_size(touching); j++) {
+                if (list_get(touching, j) == contact) {
+                    list_remove(touching, j);
+                    break;
+                }
+            }
+        }
+        list_remove(scene->contact_list, i);
+        contact_free(contact);
+        i--;
+    }
+}
+
+/**
+ * Returns whether continuous collision detection applies to a body:
+ * whether it can move and can be swept (see find_time_of_impact()).
+ */
+bool is_sweepable(body_t *body) {
+    return body_get_mass(body) != INFINITY && !body_is_sensor(body)
+        && (body_is_circle(body) || body_is_convex(body)
+            || body_is_compound(body));
+}
+
+/**
+ * Sweeps a body towards the other of a pair of bodies, if it is one of them
+ * and the other has mass INFINITY, keeping the other body as the hit body
+ * if it is hit first.
+ */
+void sweep_towards_pair(body_t *body, vector_t displacement, body_t *body1,
+    body_t *body2, body_t **hit, impact_info_t *first) {
+
+    body_t *other = body1 == body ? body2 : body1;
+    if ((body1 != body && body2 != body) || other == *hit
+        || !body_can_collide(body, other)
+        || body_get_mass(other) != INFINITY || body_is_sensor(other)
+        || !(body_is_circle(other) || body_is_convex(other)
+            || body_is_compound(other))) {
+        return;
+    }
+    impact_info_t impact = find_time_of_impact(body, displacement, other);
+    if (impact.hit && (*hit == NULL || impact.time < first->time)) {
+        *hit = other;
+        *first = impact;
+    }
+}
+
+/**
+ * The state of a find_first_impact() search, passed to sweep_towards_body().
+ */
+typedef struct impact_search {
+    scene_t *scene;
+    body_t *body;
+    vector_t displacement;
+    body_t *hit;
+    impact_info_t *first;
+} impact_search_t;
+
+/**
+ * Called by the broad phase on each body near a swept body's path.
+ * Sweeps the body towards it if they have a contact
+ * or their types are registered with each other.
+ */
+void sweep_towards_body(body_t *other, void *aux) {
+    impact_search_t *search = aux;
+    body_t *body = search->body;
+    if (other == body
+        || (pair_table_get(search->scene->contacts, body, other) == NULL
+            && get_type_pair(search->scene, body_get_collision_type(body),
+                body_get_collision_type(other)) == NULL)) {
+        return;
+    }
+    sweep_towards_pair(body, search->displacement, body, other, &search->hit,
+        search->first);
+}
+
+/**
+ * Finds the first body with mass INFINITY that a body has a contact with,
+ * or whose type is registered with its type, and would hit
+ * while moving by a displacement, or returns NULL.
+ * Only the bodies the broad phase finds in the box the body sweeps through
+ * are checked, so the cost does not grow with the number of bodies.
+ * The first search of a tick brings the broad phase up to date,
+ * since bodies with mass INFINITY may have moved since the collision stage.
+ */
+body_t *find_first_impact(scene_t *scene, body_t *body, vector_t displacement,
+    impact_info_t *first) {
+
+    if (!scene->broad_phase_current) {
+        broad_phase_update(scene->broad_phase, scene->body_list);
+        scene->broad_phase_current = true;
+    }
+    aabb_t bounds = body_get_bounds(body);
+    aabb_t end_bounds = {
+        vec_add(bounds.min, displacement),
+        vec_add(bounds.max, displacement)
+    };
+    impact_search_t search = {scene, body, displacement, NULL, first};
+    broad_phase_query(scene->broad_phase, aabb_union(bounds, end_bounds),
+        sweep_towards_body, &search);
+    return search.hit;
+}
+
+/**
+ * Records where each body that continuous collisions apply to starts
+ * the tick, so tick_continuous() can sweep it after body_store_tick().
+ */
+void record_sweep_starts(scene_t *scene) {
+    size_t size = list_size(scene->body_list);
+    if (size > scene->sweep_capacity) {
+        scene->sweep_starts =
+            realloc(scene->sweep_starts, size * sizeof(vector_t));
+        assert(scene->sweep_starts != NULL);
+        scene->sweep_capacity = size;
+    }
+    for (size_t i = 0; i < size; i++) {
+        body_t *body = list_get(scene->body_list, i);
+        if (is_sweepable(body)) {
+            scene->sweep_starts[i] = body_get_centroid(body);
+        }
+    }
+}
+
+/**
+ * Finishes ticking a body that body_tick() moved from start: if it moved
+ * further than its own width or height, sweeps it along its path and stops it
+ * at the first body with mass INFINITY it would hit. Their contact is updated
+ * there and, if it is solid, the body bounces off right away.
+ * Then the body is ticked for the rest of the time.
+ */
+void tick_continuous(scene_t *scene, body_t *body, vector_t start, double dt) {
+    for (size_t impacts = 0; impacts < MAX_IMPACTS_PER_TICK; impacts++) {
+        vector_t end = body_get_centroid(body);
+        vector_t displacement = vec_subtract(end, start);
+        aabb_t bounds = body_get_bounds(body);
+        double size = fmin(bounds.max.x - bounds.min.x,
+            bounds.max.y - bounds.min.y);
+        double distance = sqrt(vec_dot(displacement, displacement));
+        if (distance <= size) {
+            return;
+        }
+
+        body_set_centroid(body, start);
+        impact_info_t impact;
+        body_t *hit = find_first_impact(scene, body, displacement, &impact);
+        if (hit == NULL) {
+            body_set_centroid(body, end);
+            return;
+        }
+        double time = fmin(impact.time + IMPACT_SLOP / distance, 1);
+        start = vec_add(start, vec_multiply(time, displacement));
+        body_set_centroid(body, start);
+        // the contact is now tracked,
+        // so the collision stage will end it when the bodies separate
+        contact_t *contact = update_contact(scene, body, hit);
+        if (contact != NULL && contact->touching && contact->solid) {
+            // body_tick() already used this tick's impulses and forces
+            contact->normal_impulse = 0;
+            prepare_contact(contact, 0);
+            solve_contact(contact, 0);
+        }
+        dt *= 1 - time;
+        body_tick(body, dt);
+    }
+}
+
+/**
+ * Returns whether a circle overlaps a bounding box.
+ */
+bool circle_overlaps_bounds(vector_t center, double radius, aabb_t bounds) {
+    vector_t closest = {
+        fmin(fmax(center.x, bounds.min.x), bounds.max.x),
+        fmin(fmax(center.y, bounds.min.y), bounds.max.y)
+    };
+    vector_t offset = vec_subtract(center, closest);
+    return vec_dot(offset, offset) < radius * radius;
+}
+
+/**
+ * Returns whether a body overlaps a sensor, using only their bounding boxes
+ * and, if either is a circle, its radius.
+ */
+bool overlaps_sensor(body_t *sensor, body_t *body) {
+    if (!body_can_collide(sensor, body)) {
+        return false;
+    }
+    aabb_t sensor_bounds = body_get_bounds(sensor);
+    aabb_t body_bounds = body_get_bounds(body);
+    if (!aabb_overlap(sensor_bounds, body_bounds)) {
+        return false;
+    }
+    if (body_is_circle(sensor) && body_is_circle(body)) {
+        double radii = body_get_radius(sensor) + body_get_radius(body);
+        vector_t offset = vec_subtract(body_get_centroid(body),
+            body_get_centroid(sensor));
+        return vec_dot(offset, offset) < radii * radii;
+    }
+    if (body_is_circle(sensor)) {
+        return circle_overlaps_bounds(body_get_centroid(sensor),
+            body_get_radius(sensor), body_bounds);
+    }
+    if (body_is_circle(body)) {
+        return circle_overlaps_bounds(body_get_centroid(body),
+            body_get_radius(body), sensor_bounds);
+    }
+    return true;
+}
+
+/**
+ * Adds an event to the end of a scene's sensor event queue.
+ */
+void queue_sensor_event(scene_t *scene, sensor_event_kind_t kind,
+    body_t *sensor, body_t *body) {
+
+    sensor_event_t *event = malloc(sizeof(sensor_event_t));
+    assert(event != NULL);
+    *event = (sensor_event_t) {kind, sensor, body};
+    list_add(scene->sensor_events, event);
+}
+
+/**
+ * A sensor being checked by the sensor stage.
+ */
+typedef struct sensor_query {
+    scene_t *scene;
+    body_t *sensor;
+} sensor_query_t;
+
+/**
+ * Called by the broad phase on each body whose bounding box overlaps
+ * a sensor's. Records the overlap if the sensor reports the body,
+ * queuing an enter event if the overlap is new.
+ */
+void record_sensor_overlap(body_t *body, void *aux) {
+    sensor_query_t *query = aux;
+    scene_t *scene = query->scene;
+    body_t *sensor = query->sensor;
+    if (body_is_sensor(body) || body_get_mass(body) == INFINITY
+        || !overlaps_sensor(sensor, body)) {
+        return;
+    }
+    sensor_overlap_t *overlap = pair_table_get(scene->sensor_pairs, sensor, body);
+    if (overlap == NULL) {
+        overlap = malloc(sizeof(sensor_overlap_t));
+        assert(overlap != NULL);
+        *overlap = (sensor_overlap_t) {sensor, body, scene->ticks};
+        list_add(scene->sensor_overlaps, overlap);
+        pair_table_put(scene->sensor_pairs, sensor, body, overlap);
+        queue_sensor_event(scene, SENSOR_ENTER, sensor, body);
+    }
+    overlap->last_tick = scene->ticks;
+}
+
+/**
+ * Finds the moving bodies overlapping each sensor, queuing an enter event
+ * for each overlap that is new and an exit event for each that has ended.
+ * Each sensor only checks the bodies the broad phase finds in its bounds,
+ * after the broad phase is brought up to date with where the bodies moved.
+ */
+void run_sensor_stage(scene_t *scene) {
+    bool updated = false;
+    for (size_t i = 0; i < list_size(scene->body_list); i++) {
+        body_t *sensor = list_get(scene->body_list, i);
+        if (!body_is_sensor(sensor)) {
+            continue;
+        }
+        if (!updated) {
+            broad_phase_update(scene->broad_phase, scene->body_list);
+            updated = true;
+        }
+        sensor_query_t query = {scene, sensor};
+        broad_phase_query(scene->broad_phase, body_get_bounds(sensor),
+            record_sensor_overlap, &query);
+    }
+
+    for (size_t i = 0; i < list_size(scene->sensor_overlaps); i++) {
+        sensor_overlap_t *overlap = list_get(scene->sensor_overlaps, i);
+        if (overlap->last_tick == scene->ticks) {
+            continue;
+        }
+        queue_sensor_event(scene, SENSOR_EXIT, overlap->sensor, overlap->body);
+        pair_table_remove(scene->sensor_pairs, overlap->sensor, overlap->body);
+        free(list_remove(scene->sensor_overlaps, i));
+        i--;
+    }
+}
+
+/**
+ * Forgets every overlap and drops every queued sensor event involving a body.
+ */
+void remove_sensor_overlaps(scene_t *scene, body_t *body) {
+    for (size_t i = 0; i < list_size(scene->sensor_overlaps); i++) {
+        sensor_overlap_t *overlap = list_get(scene->sensor_overlaps, i);
+        if (overlap->sensor == body || overlap->body == body) {
+            pair_table_remove(scene->sensor_pairs, overlap->sensor,
+                overlap->body);
+            free(list_remove(scene->sensor_overlaps, i));
+            i--;
+        }
+    }
+    for (size_t i = 0; i < list_size(scene->sensor_events); i++) {
+        sensor_event_t *event = list_get(scene->sensor_events, i);
+        if (event->sensor == body || event->body == body) {
+            free(list_remove(scene->sensor_events, i));
+            i--;
+        }
+    }
+}
+
+bool scene_poll_sensor_event(scene_t *scene, sensor_event_t *event) {
+    if (list_size(scene->sensor_events) == 0) {
+        return false;
+    }
+    sensor_event_t *oldest = list_remove(scene->sensor_events, 0);
+    *event = *oldest;
+    free(oldest);
+    return true;
+}
 
 void scene_tick(scene_t *scene, double dt) {
+    run_collision_stage(scene);
+
     for (size_t i = 0; i < list_size(scene->force_list); i++) {
         force_creator_t forcer = list_get(scene->force_list, i);
         void *aux = list_get(scene->aux_list, i);
         forcer(aux);
     }
 
-    for (size_t i = 0; i < list_size(scene->body_list); i++) {
+    solve_contacts(scene, dt);
+    // push apart the bodies the collisions found overlapping
+    body_store_apply_corrections(scene->bodies);
+
+    if (scene->continuous) {
+        record_sweep_starts(scene);
+    }
+    body_store_tick(scene->bodies, dt);
+    scene->broad_phase_current = false;
+
+    // sweep_starts is indexed by where the bodies were before any were removed,
+    // and has no entries for bodies the collision handlers add during the loop
+    size_t swept = list_size(scene->body_list);
+    for (size_t i = 0, start = 0; i < list_size(scene->body_list);
+        i++, start++) {
+
         body_t *body = list_get(scene->body_list, i);
-        body_tick(body, dt);
+        if (scene->continuous && start < swept && is_sweepable(body)) {
+            tick_continuous(scene, body, scene->sweep_starts[start], dt);
+        }
         if (body_is_removed(body)) {
             for (size_t j = 0; j < list_size(scene->force_bodies_list); j++) {
                 for (size_t k = 0; k < list_size(list_get(scene->force_bodies_list, j)); k++) {
@@ -108,6 +1051,9 @@ void scene_tick(scene_t *scene, double dt) {
                     }
                 }
             }
+            remove_contacts(scene, body);
+            remove_sensor_overlaps(scene, body);
+            broad_phase_remove(scene->broad_phase, body);
             body_t *body = list_remove(scene->body_list, i);
             body_free(body);
             i--;
@@ -115,4 +1061,5 @@ void scene_tick(scene_t *scene, double dt) {
     }
 
 
+    run_sensor_stage(scene);
 }
@@ -9,6 +9,7 @@ const char WINDOW_TITLE[] = "CS 3";
 const int WINDOW_WIDTH = 1000;
 const int WINDOW_HEIGHT = 500;
 const double MS_PER_S = 1e3;
+const size_t CAPSULE_CAP_POINTS = 8;
 
 /**
  * The coordinate at the center of the screen.
@@ -53,6 +54,14 @@ clock_t last_clock = 0;
 
 TTF_Font *font;
 
+/**
+ * The on-screen coordinates of the polygon being drawn,
+ * kept between frames to avoid reallocating them for every polygon.
+ */
+int16_t *x_pixels = NULL;
+int16_t *y_pixels = NULL;
+size_t pixels_capacity = 0;
+
 typedef struct sdl_music {
     Uint32 wav_length;
     Uint8 *wav_buffer;
@@ -199,33 +208,84 @@ void sdl_clear(void) {
     SDL_RenderClear(renderer);
 }
 
-void sdl_draw_polygon(list_t *points, rgb_color_t color) {
+/**
+ * Makes room for the on-screen coordinates of a polygon's vertices.
+ */
+void reserve_pixels(size_t n) {
+    if (n > pixels_capacity) {
+        x_pixels = realloc(x_pixels, sizeof(*x_pixels) * n);
+        y_pixels = realloc(y_pixels, sizeof(*y_pixels) * n);
+        assert(x_pixels != NULL);
+        assert(y_pixels != NULL);
+        pixels_capacity = n;
+    }
+}
+
+/**
+ * Fills the polygon whose on-screen coordinates are the first n pixels.
+ */
+void fill_pixels(size_t n, rgb_color_t color) {
     // Check parameters
-    size_t n = list_size(points);
     assert(n >= 3);
     assert(0 <= color.r && color.r <= 1);
     assert(0 <= color.g && color.g <= 1);
     assert(0 <= color.b && color.b <= 1);
 
+    // Draw polygon with the given color
+    filledPolygonRGBA(renderer, x_pixels, y_pixels, n, color.r * 255, color.g * 255,
+                      color.b * 255, 255);
+}
+
+void sdl_draw_polygon(list_t *points, rgb_color_t color) {
+    size_t n = list_size(points);
+    reserve_pixels(n);
     vector_t window_center = get_window_center();
 
     // Convert each vertex to a point on screen
-    int16_t *x_points = malloc(sizeof(*x_points) * n),
-            *y_points = malloc(sizeof(*y_points) * n);
-    assert(x_points != NULL);
-    assert(y_points != NULL);
     for (size_t i = 0; i < n; i++) {
         vector_t *vertex = list_get(points, i);
         vector_t pixel = get_window_position(*vertex, window_center);
-        x_points[i] = pixel.x;
-        y_points[i] = pixel.y;
+        x_pixels[i] = pixel.x;
+        y_pixels[i] = pixel.y;
     }
+    fill_pixels(n, color);
+}
 
-    // Draw polygon with the given color
-    filledPolygonRGBA(renderer, x_points, y_points, n, color.r * 255, color.g * 255,
-                      color.b * 255, 255);
-    free(x_points);
-    free(y_points);
+void sdl_draw_polygon_array(const vec_array_t *points, rgb_color_t color) {
+    size_t n = vec_array_size(points);
+    const vector_t *vertices = vec_array_data(points);
+    reserve_pixels(n);
+    vector_t window_center = get_window_center();
+
+    // Convert each vertex to a point on screen
+    for (size_t i = 0; i < n; i++) {
+        vector_t pixel = get_window_position(vertices[i], window_center);
+        x_pixels[i] = pixel.x;
+        y_pixels[i] = pixel.y;
+    }
+    fill_pixels(n, color);
+}
+
+void sdl_draw_shape(const vec_array_t *points, vector_t position, double angle,
+    rgb_color_t color) {
+    size_t n = vec_array_size(points);
+    const vector_t *vertices = vec_array_data(points);
+    reserve_pixels(n);
+    vector_t window_center = get_window_center();
+    double cos_angle = cos(angle);
+    double sin_angle = sin(angle);
+
+    // Place each vertex in the scene, then convert it to a point on screen
+    for (size_t i = 0; i < n; i++) {
+        vector_t vertex = {
+            position.x + vertices[i].x * cos_angle - vertices[i].y * sin_angle,
+            position.y + vertices[i].x * sin_angle + vertices[i].y * cos_angle
+        };
+        vector_t pixel = get_window_position(vertex, window_center);
+        x_pixels[i] = pixel.x;
+        y_pixels[i] = pixel.y;
+    }
+    fill_pixels(n, color);
 }
 
 void sdl_show(void) {
@@ -250,9 +310,22 @@ void sdl_draw_scene(scene_t *scene) {
     size_t body_count = scene_bodies(scene);
     for (size_t i = 0; i < body_count; i++) {
         body_t *body = scene_get_body(scene, i);
-        list_t *shape = body_get_shape(body);
-        sdl_draw_polygon(shape, body_get_color(body));
-        list_free(shape);
+        if (body_is_compound(body)) {
+            for (size_t j = 0; j < body_get_part_count(body); j++) {
+                sdl_draw_polygon_array(body_peek_part(body, j),
+                    body_get_color(body));
+            }
+            const capsule_t *capsules = body_get_capsules(body);
+            for (size_t j = 0; j < body_get_capsule_count(body); j++) {
+                list_t *polygon = capsule_polygon(capsules[j], CAPSULE_CAP_POINTS);
+                sdl_draw_polygon(polygon, body_get_color(body));
+                list_free(polygon);
+            }
+            continue;
+        }
+        // drawing from the local shape leaves shared shapes uncopied
+        sdl_draw_shape(body_peek_local_shape(body), body_get_centroid(body),
+            body_get_rotation(body), body_get_color(body));
     }
 }
 
@@ -0,0 +1,162 @@
+#include "shape.h"
+#include "list.h"
+#include "polygon.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * The constructor a memoized shape came from, which, with its parameters,
+ * identifies the shape in the library.
+ */
+typedef enum {
+    SHAPE_CUSTOM,
+    SHAPE_CIRCLE,
+    SHAPE_STAR,
+    SHAPE_RECTANGLE
+} shape_kind_t;
+
+typedef struct shape {
+    vec_array_t *points;
+    aabb_t bounds;
+    bool convex;
+    size_t ref_count;
+    shape_kind_t kind;
+    double size1;
+    double size2;
+} shape_t;
+
+/**
+ * The memoized shapes that are still referenced, or NULL if there are none.
+ * The library does not hold references, so a shape leaves it when freed.
+ */
+list_t *shape_library = NULL;
+
+shape_t *shape_init(vec_array_t *points) {
+    shape_t *shape = malloc(sizeof(shape_t));
+    assert(shape != NULL);
+    shape->points = points;
+    shape->bounds = aabb_of_vec_array(points);
+    shape->convex = polygon_array_is_convex(points);
+    shape->ref_count = 1;
+    shape->kind = SHAPE_CUSTOM;
+    shape->size1 = 0;
+    shape->size2 = 0;
+    return shape;
+}
+
+/**
+ * Finds a memoized shape and takes a reference to it.
+ *
+ * @return the shape, or NULL if it is not in the library
+ */
+shape_t *shape_library_find(shape_kind_t kind, double size1, double size2) {
+    for (size_t i = 0; shape_library != NULL && i < list_size(shape_library); i++) {
+        shape_t *shape = list_get(shape_library, i);
+        if (shape->kind == kind && shape->size1 == size1 && shape->size2 == size2) {
+            return shape_retain(shape);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Adds a newly made shape to the library.
+ */
+shape_t *shape_library_add(shape_t *shape, shape_kind_t kind, double size1,
+    double size2) {
+
+    shape->kind = kind;
+    shape->size1 = size1;
+    shape->size2 = size2;
+    if (shape_library == NULL) {
+        shape_library = list_init(1, null_free);
+    }
+    list_add(shape_library, shape);
+    return shape;
+}
+
+/**
+ * Removes a shape that is being freed from the library.
+ */
+void shape_library_remove(shape_t *shape) {
+    for (size_t i = 0; i < list_size(shape_library); i++) {
+        if (list_get(shape_library, i) == shape) {
+            list_remove(shape_library, i);
+            break;
+        }
+    }
+    if (list_size(shape_library) == 0) {
+        list_free(shape_library);
+        shape_library = NULL;
+    }
+}
+
+shape_t *shape_circle(double radius, size_t num_points) {
+    shape_t *circle = shape_library_find(SHAPE_CIRCLE, radius, num_points);
+    if (circle != NULL) {
+        return circle;
+    }
+    vec_array_t *points = vec_array_init(num_points);
+    double arc_angle = 2 * M_PI / num_points;
+    for (size_t i = 0; i < num_points; i++) {
+        vec_array_add(points,
+            (vector_t) {radius * cos(i * arc_angle), radius * sin(i * arc_angle)});
+    }
+    return shape_library_add(shape_init(points), SHAPE_CIRCLE, radius, num_points);
+}
+
+shape_t *shape_star(double radius, size_t num_points) {
+    shape_t *star = shape_library_find(SHAPE_STAR, radius, num_points);
+    if (star != NULL) {
+        return star;
+    }
+    vec_array_t *points = star_array_init(radius, num_points);
+    return shape_library_add(shape_init(points), SHAPE_STAR, radius, num_points);
+}
+
+shape_t *shape_rectangle(double width, double height) {
+    shape_t *rectangle = shape_library_find(SHAPE_RECTANGLE, width, height);
+    if (rectangle != NULL) {
+        return rectangle;
+    }
+    vec_array_t *points = vec_array_init(4);
+    vec_array_add(points, (vector_t) {width / 2, height / 2});
+    vec_array_add(points, (vector_t) {-width / 2, height / 2});
+    vec_array_add(points, (vector_t) {-width / 2, -height / 2});
+    vec_array_add(points, (vector_t) {width / 2, -height / 2});
+    return shape_library_add(shape_init(points), SHAPE_RECTANGLE, width, height);
+}
+
+shape_t *shape_retain(shape_t *shape) {
+    shape->ref_count++;
+    return shape;
+}
+
+void shape_release(shape_t *shape) {
+    assert(shape->ref_count > 0);
+    shape->ref_count--;
+    if (shape->ref_count == 0) {
+        if (shape->kind != SHAPE_CUSTOM) {
+            shape_library_remove(shape);
+        }
+        vec_array_free(shape->points);
+        free(shape);
+    }
+}
+
+size_t shape_get_ref_count(const shape_t *shape) {
+    return shape->ref_count;
+}
+
+const vec_array_t *shape_get_points(const shape_t *shape) {
+    return shape->points;
+}
+
+aabb_t shape_get_bounds(const shape_t *shape) {
+    return shape->bounds;
+}
+
+bool shape_is_convex(const shape_t *shape) {
+    return shape->convex;
+}
@@ -0,0 +1,211 @@
+#include "simd.h"
+#include <assert.h>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#endif
+
+// the kernels load vector_ts straight into registers as pairs of doubles
+_Static_assert(sizeof(vector_t) == 2 * sizeof(double), "vector_t is padded");
+
+simd_level_t simd_level = SIMD_SCALAR;
+bool simd_level_chosen = false;
+
+bool simd_supported(simd_level_t level) {
+    switch (level) {
+        case SIMD_SCALAR:
+            return true;
+#ifdef SIMD_X86
+        case SIMD_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case SIMD_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+simd_level_t simd_get_level(void) {
+    if (!simd_level_chosen) {
+        simd_level = simd_supported(SIMD_AVX2) ? SIMD_AVX2
+            : simd_supported(SIMD_SSE2) ? SIMD_SSE2
+            : SIMD_SCALAR;
+        simd_level_chosen = true;
+    }
+    return simd_level;
+}
+
+void simd_set_level(simd_level_t level) {
+    assert(simd_supported(level));
+    simd_level = level;
+    simd_level_chosen = true;
+}
+
+/**
+ * Projects points onto an axis one at a time, widening a {min, max} range.
+ */
+vector_t project_scalar(const vector_t *points, size_t count, vector_t axis,
+    vector_t range) {
+    for (size_t i = 0; i < count; i++) {
+        double projection = points[i].x * axis.x + points[i].y * axis.y;
+        range.x = fmin(range.x, projection);
+        range.y = fmax(range.y, projection);
+    }
+    return range;
+}
+
+/**
+ * Widens a bounding box to contain points, one at a time.
+ */
+void bounds_scalar(const vector_t *points, size_t count, vector_t *min,
+    vector_t *max) {
+    for (size_t i = 0; i < count; i++) {
+        min->x = fmin(min->x, points[i].x);
+        min->y = fmin(min->y, points[i].y);
+        max->x = fmax(max->x, points[i].x);
+        max->y = fmax(max->y, points[i].y);
+    }
+}
+
+#ifdef SIMD_X86
+
+/**
+ * Projects pairs of points with SSE2: each register holds one point,
+ * so two points are shuffled into a register of xs and one of ys,
+ * and both are projected with one multiply-add.
+ */
+__attribute__((target("sse2")))
+vector_t project_sse2(const vector_t *points, size_t count, vector_t axis) {
+    __m128d axis_x = _mm_set1_pd(axis.x);
+    __m128d axis_y = _mm_set1_pd(axis.y);
+    __m128d min = _mm_set1_pd(INFINITY);
+    __m128d max = _mm_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d point1 = _mm_loadu_pd(&points[i].x);
+        __m128d point2 = _mm_loadu_pd(&points[i + 1].x);
+        __m128d xs = _mm_unpacklo_pd(point1, point2);
+        __m128d ys = _mm_unpackhi_pd(point1, point2);
+        __m128d projections =
+            _mm_add_pd(_mm_mul_pd(xs, axis_x), _mm_mul_pd(ys, axis_y));
+        min = _mm_min_pd(min, projections);
+        max = _mm_max_pd(max, projections);
+    }
+    double mins[2], maxes[2];
+    _mm_storeu_pd(mins, min);
+    _mm_storeu_pd(maxes, max);
+    vector_t range = {fmin(mins[0], mins[1]), fmax(maxes[0], maxes[1])};
+    return project_scalar(points + i, count - i, axis, range);
+}
+
+/**
+ * Finds bounds with SSE2, where each register holds one point,
+ * so a single min and max update both coordinates.
+ */
+__attribute__((target("sse2")))
+void bounds_sse2(const vector_t *points, size_t count, vector_t *min,
+    vector_t *max) {
+    __m128d low = _mm_set1_pd(INFINITY);
+    __m128d high = _mm_set1_pd(-INFINITY);
+    for (size_t i = 0; i < count; i++) {
+        __m128d point = _mm_loadu_pd(&points[i].x);
+        low = _mm_min_pd(low, point);
+        high = _mm_max_pd(high, point);
+    }
+    _mm_storeu_pd(&min->x, low);
+    _mm_storeu_pd(&max->x, high);
+}
+
+/**
+ * Projects four points at a time with AVX2, shuffling two registers of
+ * {x, y, x, y} into one of xs and one of ys like project_sse2().
+ */
+__attribute__((target("avx2")))
+vector_t project_avx2(const vector_t *points, size_t count, vector_t axis) {
+    __m256d axis_x = _mm256_set1_pd(axis.x);
+    __m256d axis_y = _mm256_set1_pd(axis.y);
+    __m256d min = _mm256_set1_pd(INFINITY);
+    __m256d max = _mm256_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d points1 = _mm256_loadu_pd(&points[i].x);
+        __m256d points2 = _mm256_loadu_pd(&points[i + 2].x);
+        __m256d xs = _mm256_unpacklo_pd(points1, points2);
+        __m256d ys = _mm256_unpackhi_pd(points1, points2);
+        __m256d projections = _mm256_add_pd(_mm256_mul_pd(xs, axis_x),
+            _mm256_mul_pd(ys, axis_y));
+        min = _mm256_min_pd(min, projections);
+        max = _mm256_max_pd(max, projections);
+    }
+    __m128d min2 = _mm_min_pd(_mm256_castpd256_pd128(min),
+        _mm256_extractf128_pd(min, 1));
+    __m128d max2 = _mm_max_pd(_mm256_castpd256_pd128(max),
+        _mm256_extractf128_pd(max, 1));
+    double mins[2], maxes[2];
+    _mm_storeu_pd(mins, min2);
+    _mm_storeu_pd(maxes, max2);
+    vector_t range = {fmin(mins[0], mins[1]), fmax(maxes[0], maxes[1])};
+    return project_scalar(points + i, count - i, axis, range);
+}
+
+/**
+ * Finds bounds with AVX2, two points per register.
+ */
+__attribute__((target("avx2")))
+void bounds_avx2(const vector_t *points, size_t count, vector_t *min,
+    vector_t *max) {
+    __m256d low = _mm256_set1_pd(INFINITY);
+    __m256d high = _mm256_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m256d pair = _mm256_loadu_pd(&points[i].x);
+        low = _mm256_min_pd(low, pair);
+        high = _mm256_max_pd(high, pair);
+    }
+    _mm_storeu_pd(&min->x, _mm_min_pd(_mm256_castpd256_pd128(low),
+        _mm256_extractf128_pd(low, 1)));
+    _mm_storeu_pd(&max->x, _mm_max_pd(_mm256_castpd256_pd128(high),
+        _mm256_extractf128_pd(high, 1)));
+    bounds_scalar(points + i, count - i, min, max);
+}
+
+#endif // #ifdef SIMD_X86
+
+vector_t simd_project(const vector_t *points, size_t count, vector_t axis) {
+    assert(count > 0);
+    switch (simd_get_level()) {
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            return project_avx2(points, count, axis);
+        case SIMD_SSE2:
+            return project_sse2(points, count, axis);
+#endif
+        default:
+            return project_scalar(points, count, axis,
+                (vector_t) {INFINITY, -INFINITY});
+    }
+}
+
+void simd_bounds(const vector_t *points, size_t count, vector_t *min,
+    vector_t *max) {
+    assert(count > 0);
+    switch (simd_get_level()) {
+#ifdef SIMD_X86
+        case SIMD_AVX2:
+            bounds_avx2(points, count, min, max);
+            return;
+        case SIMD_SSE2:
+            bounds_sse2(points, count, min, max);
+            return;
+#endif
+        default:
+            *min = (vector_t) {INFINITY, INFINITY};
+            *max = (vector_t) {-INFINITY, -INFINITY};
+            bounds_scalar(points, count, min, max);
+    }
+}
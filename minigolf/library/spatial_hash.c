@@ -0,0 +1,408 @@
+#include "spatial_hash.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// bodies touching more cells than this are compared against every body instead
+const double MAX_CELLS_PER_BODY = 64;
+// automatic cells are this many times wider than the median body
+const double CELL_SIZE_FACTOR = 2;
+const size_t GRID_GROWTH_FACTOR = 2;
+
+typedef struct cell_entry {
+    int64_t x;
+    int64_t y;
+    size_t body;
+} cell_entry_t;
+
+typedef struct spatial_hash {
+    double cell_size;
+    // scratch arrays, kept between searches to avoid reallocating every tick
+    aabb_t *bounds;
+    size_t bounds_capacity;
+    double *extents;
+    cell_entry_t *entries;
+    size_t entries_capacity;
+    cell_entry_t *sorted;
+    size_t sorted_capacity;
+    size_t *bucket_starts;
+    size_t buckets_capacity;
+    size_t *large;
+    // the grid built by the last search, kept for spatial_hash_query():
+    // the bodies searched (NULL once removed), their cell size and bucket mask,
+    // and whether any cells were built
+    body_t **bodies;
+    size_t count;
+    size_t large_count;
+    double used_cell_size;
+    size_t mask;
+    bool has_grid;
+    // the bodies added since the last search, which are not in the grid
+    list_t *added;
+} spatial_hash_t;
+
+/**
+ * Grows a scratch array so it can hold at least needed elements.
+ */
+void *ensure_grid_capacity(void *array, size_t *capacity, size_t needed, size_t size) {
+    if (needed <= *capacity) {
+        return array;
+    }
+    size_t new_capacity = *capacity == 0 ? needed : *capacity;
+    while (new_capacity < needed) {
+        new_capacity *= GRID_GROWTH_FACTOR;
+    }
+    array = realloc(array, new_capacity * size);
+    assert(array != NULL);
+    *capacity = new_capacity;
+    return array;
+}
+
+/**
+ * Partially sorts values so that values[k] is the kth smallest (quickselect).
+ */
+double select_kth(double *values, size_t count, size_t k) {
+    size_t low = 0;
+    size_t high = count - 1;
+    while (low < high) {
+        // Lomuto partition around the middle value
+        size_t middle = low + (high - low) / 2;
+        double pivot = values[middle];
+        values[middle] = values[high];
+        values[high] = pivot;
+        size_t store = low;
+        for (size_t i = low; i < high; i++) {
+            if (values[i] < pivot) {
+                double temp = values[i];
+                values[i] = values[store];
+                values[store] = temp;
+                store++;
+            }
+        }
+        values[high] = values[store];
+        values[store] = pivot;
+
+        if (k == store) {
+            break;
+        }
+        else if (k < store) {
+            high = store - 1;
+        }
+        else {
+            low = store + 1;
+        }
+    }
+    return values[k];
+}
+
+/**
+ * Picks a cell width from the median width of the bodies' bounding boxes.
+ */
+double automatic_cell_size(spatial_hash_t *hash, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        aabb_t box = hash->bounds[i];
+        double width = box.max.x - box.min.x;
+        double height = box.max.y - box.min.y;
+        hash->extents[i] = width > height ? width : height;
+    }
+    double median = select_kth(hash->extents, count, count / 2);
+    if (!(median > 0) || !isfinite(median)) {
+        return 1;
+    }
+    return CELL_SIZE_FACTOR * median;
+}
+
+size_t cell_hash(int64_t x, int64_t y, size_t mask) {
+    uint64_t hash = (uint64_t) x * 0x9E3779B97F4A7C15ULL;
+    hash ^= (uint64_t) y * 0xC2B2AE3D27D4EB4FULL;
+    hash ^= hash >> 29;
+    return (size_t) hash & mask;
+}
+
+spatial_hash_t *spatial_hash_init(double cell_size) {
+    spatial_hash_t *hash = malloc(sizeof(spatial_hash_t));
+    assert(hash != NULL);
+
+    hash->cell_size = cell_size;
+    hash->bounds = NULL;
+    hash->bounds_capacity = 0;
+    hash->extents = NULL;
+    hash->entries = NULL;
+    hash->entries_capacity = 0;
+    hash->sorted = NULL;
+    hash->sorted_capacity = 0;
+    hash->bucket_starts = NULL;
+    hash->buckets_capacity = 0;
+    hash->large = NULL;
+    hash->bodies = NULL;
+    hash->count = 0;
+    hash->large_count = 0;
+    hash->used_cell_size = 1;
+    hash->mask = 0;
+    hash->has_grid = false;
+    hash->added = list_init(1, null_free);
+    return hash;
+}
+
+void spatial_hash_free(spatial_hash_t *hash) {
+    free(hash->bounds);
+    free(hash->extents);
+    free(hash->entries);
+    free(hash->sorted);
+    free(hash->bucket_starts);
+    free(hash->large);
+    free(hash->bodies);
+    list_free(hash->added);
+    free(hash);
+}
+
+void spatial_hash_set_cell_size(spatial_hash_t *hash, double cell_size) {
+    assert(cell_size >= 0);
+    hash->cell_size = cell_size;
+}
+
+void spatial_hash_add(spatial_hash_t *hash, body_t *body) {
+    list_add(hash->added, body);
+}
+
+void spatial_hash_remove(spatial_hash_t *hash, body_t *body) {
+    for (size_t i = 0; i < hash->count; i++) {
+        if (hash->bodies[i] == body) {
+            hash->bodies[i] = NULL;
+        }
+    }
+    for (size_t i = 0; i < list_size(hash->added); i++) {
+        if (list_get(hash->added, i) == body) {
+            list_remove(hash->added, i);
+            break;
+        }
+    }
+}
+
+void spatial_hash_update(spatial_hash_t *hash, list_t *bodies) {
+    size_t count = list_size(bodies);
+    // the per-body arrays all share bounds_capacity
+    size_t capacity = hash->bounds_capacity;
+    hash->extents = ensure_grid_capacity(hash->extents, &capacity, count, sizeof(double));
+    capacity = hash->bounds_capacity;
+    hash->large = ensure_grid_capacity(hash->large, &capacity, count, sizeof(size_t));
+    capacity = hash->bounds_capacity;
+    hash->bodies = ensure_grid_capacity(hash->bodies, &capacity, count,
+        sizeof(body_t *));
+    hash->bounds = ensure_grid_capacity(hash->bounds, &hash->bounds_capacity, count,
+        sizeof(aabb_t));
+
+    for (size_t i = 0; i < count; i++) {
+        hash->bodies[i] = list_get(bodies, i);
+        hash->bounds[i] = body_get_bounds(hash->bodies[i]);
+    }
+    hash->count = count;
+    hash->has_grid = false;
+    // the bodies added before this search are in the grid now
+    while (list_size(hash->added) > 0) {
+        list_remove(hash->added, list_size(hash->added) - 1);
+    }
+    if (count < 2) {
+        return;
+    }
+
+    double cell_size = hash->cell_size > 0
+        ? hash->cell_size
+        : automatic_cell_size(hash, count);
+
+    // count the cells each body touches, setting aside the oversized ones
+    size_t large_count = 0;
+    size_t entry_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        aabb_t box = hash->bounds[i];
+        double columns = floor(box.max.x / cell_size) - floor(box.min.x / cell_size) + 1;
+        double rows = floor(box.max.y / cell_size) - floor(box.min.y / cell_size) + 1;
+        if (!(columns * rows <= MAX_CELLS_PER_BODY)) {
+            hash->large[large_count++] = i;
+        }
+        else {
+            entry_count += (size_t) (columns * rows);
+        }
+    }
+
+    hash->entries = ensure_grid_capacity(hash->entries, &hash->entries_capacity,
+        entry_count, sizeof(cell_entry_t));
+    hash->sorted = ensure_grid_capacity(hash->sorted, &hash->sorted_capacity,
+        entry_count, sizeof(cell_entry_t));
+
+    size_t next_large = 0;
+    size_t entry = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (next_large < large_count && hash->large[next_large] == i) {
+            next_large++;
+            continue;
+        }
+        aabb_t box = hash->bounds[i];
+        int64_t x_max = (int64_t) floor(box.max.x / cell_size);
+        int64_t y_max = (int64_t) floor(box.max.y / cell_size);
+        for (int64_t x = (int64_t) floor(box.min.x / cell_size); x <= x_max; x++) {
+            for (int64_t y = (int64_t) floor(box.min.y / cell_size); y <= y_max; y++) {
+                hash->entries[entry++] = (cell_entry_t) {x, y, i};
+            }
+        }
+    }
+
+    // counting sort the entries into buckets so each cell's bodies are adjacent
+    size_t bucket_count = 1;
+    while (bucket_count < entry_count) {
+        bucket_count *= 2;
+    }
+    size_t mask = bucket_count - 1;
+    hash->large_count = large_count;
+    hash->used_cell_size = cell_size;
+    hash->mask = mask;
+    hash->has_grid = true;
+    hash->bucket_starts = ensure_grid_capacity(hash->bucket_starts,
+        &hash->buckets_capacity, bucket_count + 1, sizeof(size_t));
+    size_t *starts = hash->bucket_starts;
+    for (size_t b = 0; b <= bucket_count; b++) {
+        starts[b] = 0;
+    }
+    for (size_t e = 0; e < entry_count; e++) {
+        starts[cell_hash(hash->entries[e].x, hash->entries[e].y, mask) + 1]++;
+    }
+    for (size_t b = 0; b < bucket_count; b++) {
+        starts[b + 1] += starts[b];
+    }
+    for (size_t e = 0; e < entry_count; e++) {
+        size_t bucket = cell_hash(hash->entries[e].x, hash->entries[e].y, mask);
+        hash->sorted[starts[bucket]++] = hash->entries[e];
+    }
+}
+
+void spatial_hash_find_pairs(spatial_hash_t *hash, list_t *bodies,
+    pair_callback_t callback, void *aux) {
+
+    spatial_hash_update(hash, bodies);
+    if (!hash->has_grid) {
+        return;
+    }
+    size_t count = hash->count;
+    size_t large_count = hash->large_count;
+    double cell_size = hash->used_cell_size;
+    size_t bucket_count = hash->mask + 1;
+    size_t *starts = hash->bucket_starts;
+
+    // starts[b] now holds the end of bucket b, which is the start of bucket b + 1
+    size_t bucket_start = 0;
+    for (size_t b = 0; b < bucket_count; b++) {
+        size_t bucket_end = starts[b];
+        for (size_t e1 = bucket_start; e1 < bucket_end; e1++) {
+            cell_entry_t cell = hash->sorted[e1];
+            aabb_t box1 = hash->bounds[cell.body];
+            for (size_t e2 = e1 + 1; e2 < bucket_end; e2++) {
+                cell_entry_t other = hash->sorted[e2];
+                if (other.x != cell.x || other.y != cell.y) {
+                    continue;
+                }
+                aabb_t box2 = hash->bounds[other.body];
+                if (!body_can_collide(list_get(bodies, cell.body),
+                        list_get(bodies, other.body))
+                    || !aabb_overlap(box1, box2)) {
+                    continue;
+                }
+                // report the pair only from the cell holding the bottom left
+                // corner of the overlap, since both boxes are filed there
+                double corner_x = box1.min.x > box2.min.x ? box1.min.x : box2.min.x;
+                double corner_y = box1.min.y > box2.min.y ? box1.min.y : box2.min.y;
+                if ((int64_t) floor(corner_x / cell_size) == cell.x
+                    && (int64_t) floor(corner_y / cell_size) == cell.y) {
+                    callback(list_get(bodies, cell.body),
+                        list_get(bodies, other.body), aux);
+                }
+            }
+        }
+        bucket_start = bucket_end;
+    }
+
+    // oversized bodies are compared directly against all other bodies
+    size_t next_large = 0;
+    for (size_t l = 0; l < large_count; l++) {
+        size_t i = hash->large[l];
+        for (size_t j = 0; j < count; j++) {
+            // pairs of oversized bodies are reported once, from the first body
+            bool j_is_large = next_large < large_count && hash->large[next_large] == j;
+            if (j_is_large) {
+                next_large++;
+            }
+            if (j == i || (j_is_large && j < i)) {
+                continue;
+            }
+            body_t *body1 = list_get(bodies, i);
+            body_t *body2 = list_get(bodies, j);
+            if (body_can_collide(body1, body2)
+                && aabb_overlap(hash->bounds[i], hash->bounds[j])) {
+                callback(body1, body2, aux);
+            }
+        }
+        next_large = 0;
+    }
+}
+
+/**
+ * Reports a body of the last search if its bounds overlap a box.
+ */
+void query_grid_body(spatial_hash_t *hash, size_t index, aabb_t box,
+    body_callback_t callback, void *aux) {
+
+    if (hash->bodies[index] != NULL && aabb_overlap(hash->bounds[index], box)) {
+        callback(hash->bodies[index], aux);
+    }
+}
+
+void spatial_hash_query(spatial_hash_t *hash, aabb_t box, body_callback_t callback,
+    void *aux) {
+
+    // the callback may not add bodies, so the added list stays put
+    for (size_t i = 0; i < list_size(hash->added); i++) {
+        body_t *body = list_get(hash->added, i);
+        if (aabb_overlap(body_get_bounds(body), box)) {
+            callback(body, aux);
+        }
+    }
+
+    double cell_size = hash->used_cell_size;
+    double columns = floor(box.max.x / cell_size) - floor(box.min.x / cell_size) + 1;
+    double rows = floor(box.max.y / cell_size) - floor(box.min.y / cell_size) + 1;
+    if (!hash->has_grid || !(columns * rows <= MAX_CELLS_PER_BODY)) {
+        for (size_t i = 0; i < hash->count; i++) {
+            query_grid_body(hash, i, box, callback, aux);
+        }
+        return;
+    }
+
+    for (size_t l = 0; l < hash->large_count; l++) {
+        query_grid_body(hash, hash->large[l], box, callback, aux);
+    }
+    // starts[b] holds the end of bucket b, which is the start of bucket b + 1
+    size_t *starts = hash->bucket_starts;
+    int64_t x_max = (int64_t) floor(box.max.x / cell_size);
+    int64_t y_max = (int64_t) floor(box.max.y / cell_size);
+    for (int64_t x = (int64_t) floor(box.min.x / cell_size); x <= x_max; x++) {
+        for (int64_t y = (int64_t) floor(box.min.y / cell_size); y <= y_max; y++) {
+            size_t bucket = cell_hash(x, y, hash->mask);
+            size_t bucket_end = starts[bucket];
+            for (size_t e = bucket == 0 ? 0 : starts[bucket - 1]; e < bucket_end; e++) {
+                cell_entry_t cell = hash->sorted[e];
+                if (cell.x != x || cell.y != y) {
+                    continue;
+                }
+                // as in a search, report each body only from the cell holding
+                // the bottom left corner of its overlap with the box
+                aabb_t bounds = hash->bounds[cell.body];
+                double corner_x = bounds.min.x > box.min.x ? bounds.min.x : box.min.x;
+                double corner_y = bounds.min.y > box.min.y ? bounds.min.y : box.min.y;
+                if ((int64_t) floor(corner_x / cell_size) == x
+                    && (int64_t) floor(corner_y / cell_size) == y) {
+                    query_grid_body(hash, cell.body, box, callback, aux);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,230 @@
+#include "sweep_and_prune.h"
+#include <assert.h>
+#include <stdlib.h>
+
+const size_t SAP_INITIAL = 16;
+const size_t SAP_GROWTH_FACTOR = 2;
+
+/**
+ * A tracked body.
+ * active_index is the body's position in the sweep's active array.
+ */
+typedef struct sap_proxy {
+    body_t *body;
+    aabb_t box;
+    size_t active_index;
+} sap_proxy_t;
+
+/**
+ * The left (is_min) or right end of a proxy's x-extent.
+ */
+typedef struct sap_endpoint {
+    double value;
+    size_t proxy;
+    bool is_min;
+} sap_endpoint_t;
+
+typedef struct sweep_and_prune {
+    sap_proxy_t *proxies;
+    size_t proxy_count;
+    size_t proxy_capacity;
+    // holds 2 * proxy_count endpoints; the first sorted_count are sorted
+    // as of the last search, and the rest belong to bodies added since
+    sap_endpoint_t *endpoints;
+    size_t sorted_count;
+    // the widest x-extent among the proxies at the last search
+    double max_width;
+    // the proxies whose x-extents contain the sweep's current position
+    size_t *active;
+} sweep_and_prune_t;
+
+sweep_and_prune_t *sweep_and_prune_init(void) {
+    sweep_and_prune_t *sap = malloc(sizeof(sweep_and_prune_t));
+    assert(sap != NULL);
+    sap->proxy_count = 0;
+    sap->proxy_capacity = SAP_INITIAL;
+    sap->proxies = malloc(SAP_INITIAL * sizeof(sap_proxy_t));
+    sap->endpoints = malloc(2 * SAP_INITIAL * sizeof(sap_endpoint_t));
+    sap->active = malloc(SAP_INITIAL * sizeof(size_t));
+    assert(sap->proxies != NULL && sap->endpoints != NULL && sap->active != NULL);
+    sap->sorted_count = 0;
+    sap->max_width = 0;
+    return sap;
+}
+
+void sweep_and_prune_free(sweep_and_prune_t *sap) {
+    free(sap->proxies);
+    free(sap->endpoints);
+    free(sap->active);
+    free(sap);
+}
+
+void sweep_and_prune_add(sweep_and_prune_t *sap, body_t *body) {
+    if (sap->proxy_count == sap->proxy_capacity) {
+        sap->proxy_capacity *= SAP_GROWTH_FACTOR;
+        sap->proxies = realloc(sap->proxies, sap->proxy_capacity * sizeof(sap_proxy_t));
+        sap->endpoints = realloc(sap->endpoints,
+            2 * sap->proxy_capacity * sizeof(sap_endpoint_t));
+        sap->active = realloc(sap->active, sap->proxy_capacity * sizeof(size_t));
+        assert(sap->proxies != NULL && sap->endpoints != NULL && sap->active != NULL);
+    }
+
+    // new endpoints go at the end; the next search's insertion sort moves them
+    size_t proxy = sap->proxy_count;
+    aabb_t box = body_get_bounds(body);
+    sap->proxies[proxy] = (sap_proxy_t) {body, box, 0};
+    sap->endpoints[2 * proxy] = (sap_endpoint_t) {box.min.x, proxy, true};
+    sap->endpoints[2 * proxy + 1] = (sap_endpoint_t) {box.max.x, proxy, false};
+    sap->proxy_count++;
+}
+
+void sweep_and_prune_remove(sweep_and_prune_t *sap, body_t *body) {
+    size_t removed = 0;
+    while (removed < sap->proxy_count && sap->proxies[removed].body != body) {
+        removed++;
+    }
+    assert(removed < sap->proxy_count);
+
+    // move the last proxy into the removed proxy's slot,
+    // then drop the removed proxy's endpoints without disturbing the order
+    size_t last = sap->proxy_count - 1;
+    sap->proxies[removed] = sap->proxies[last];
+    size_t kept = 0;
+    size_t sorted_count = sap->sorted_count;
+    for (size_t i = 0; i < 2 * sap->proxy_count; i++) {
+        sap_endpoint_t endpoint = sap->endpoints[i];
+        if (endpoint.proxy == removed) {
+            if (i < sap->sorted_count) {
+                sorted_count--;
+            }
+            continue;
+        }
+        if (endpoint.proxy == last) {
+            endpoint.proxy = removed;
+        }
+        sap->endpoints[kept++] = endpoint;
+    }
+    sap->proxy_count--;
+    sap->sorted_count = sorted_count;
+}
+
+/**
+ * Returns whether endpoint1 belongs before endpoint2.
+ * At equal values, left ends come first so that touching boxes overlap.
+ */
+bool endpoint_before(sap_endpoint_t endpoint1, sap_endpoint_t endpoint2) {
+    if (endpoint1.value != endpoint2.value) {
+        return endpoint1.value < endpoint2.value;
+    }
+    return endpoint1.is_min && !endpoint2.is_min;
+}
+
+void sweep_and_prune_update(sweep_and_prune_t *sap) {
+    size_t proxy_count = sap->proxy_count;
+    size_t endpoint_count = 2 * proxy_count;
+
+    sap->max_width = 0;
+    for (size_t i = 0; i < proxy_count; i++) {
+        aabb_t box = body_get_bounds(sap->proxies[i].body);
+        sap->proxies[i].box = box;
+        if (box.max.x - box.min.x > sap->max_width) {
+            sap->max_width = box.max.x - box.min.x;
+        }
+    }
+    for (size_t i = 0; i < endpoint_count; i++) {
+        sap_endpoint_t *endpoint = &sap->endpoints[i];
+        aabb_t box = sap->proxies[endpoint->proxy].box;
+        endpoint->value = endpoint->is_min ? box.min.x : box.max.x;
+    }
+
+    // the endpoints were sorted last tick, so this is nearly linear
+    for (size_t i = 1; i < endpoint_count; i++) {
+        sap_endpoint_t endpoint = sap->endpoints[i];
+        size_t j = i;
+        while (j > 0 && endpoint_before(endpoint, sap->endpoints[j - 1])) {
+            sap->endpoints[j] = sap->endpoints[j - 1];
+            j--;
+        }
+        sap->endpoints[j] = endpoint;
+    }
+    sap->sorted_count = endpoint_count;
+}
+
+void sweep_and_prune_find_pairs(sweep_and_prune_t *sap, pair_callback_t callback,
+    void *aux) {
+
+    sweep_and_prune_update(sap);
+    // the callback may add bodies, so only sweep the ones present now
+    size_t endpoint_count = sap->sorted_count;
+
+    // every active proxy's x-extent contains the current left end,
+    // so only the y-extents still need to be compared
+    size_t active_count = 0;
+    for (size_t i = 0; i < endpoint_count; i++) {
+        sap_endpoint_t endpoint = sap->endpoints[i];
+        if (!endpoint.is_min) {
+            size_t index = sap->proxies[endpoint.proxy].active_index;
+            size_t moved = sap->active[--active_count];
+            sap->active[index] = moved;
+            sap->proxies[moved].active_index = index;
+            continue;
+        }
+
+        aabb_t box = sap->proxies[endpoint.proxy].box;
+        for (size_t a = 0; a < active_count; a++) {
+            sap_proxy_t other = sap->proxies[sap->active[a]];
+            if (body_can_collide(other.body, sap->proxies[endpoint.proxy].body)
+                && box.max.y >= other.box.min.y && other.box.max.y >= box.min.y) {
+                callback(other.body, sap->proxies[endpoint.proxy].body, aux);
+            }
+        }
+        sap->proxies[endpoint.proxy].active_index = active_count;
+        sap->active[active_count++] = endpoint.proxy;
+    }
+}
+
+/**
+ * Reports a proxy if its box overlaps a box.
+ */
+void query_proxy(sap_proxy_t proxy, aabb_t box, body_callback_t callback,
+    void *aux) {
+
+    if (aabb_overlap(proxy.box, box)) {
+        callback(proxy.body, aux);
+    }
+}
+
+void sweep_and_prune_query(sweep_and_prune_t *sap, aabb_t box,
+    body_callback_t callback, void *aux) {
+
+    // no box overlapping this one can start left of here,
+    // so binary search for the first sorted endpoint past it
+    double left = box.min.x - sap->max_width;
+    size_t low = 0;
+    size_t high = sap->sorted_count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (sap->endpoints[middle].value < left) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    for (size_t i = low; i < sap->sorted_count; i++) {
+        sap_endpoint_t endpoint = sap->endpoints[i];
+        if (endpoint.value > box.max.x) {
+            break;
+        }
+        if (endpoint.is_min) {
+            query_proxy(sap->proxies[endpoint.proxy], box, callback, aux);
+        }
+    }
+    // the bodies added since the last search are not sorted yet
+    for (size_t i = sap->sorted_count; i < 2 * sap->proxy_count; i++) {
+        sap_endpoint_t endpoint = sap->endpoints[i];
+        if (endpoint.is_min) {
+            query_proxy(sap->proxies[endpoint.proxy], box, callback, aux);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#include "vec_array.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+const size_t VEC_ARRAY_GROWTH = 2;
+
+typedef struct vec_array {
+    vector_t *items;
+    size_t length;
+    size_t alloc_size;
+} vec_array_t;
+
+vec_array_t *vec_array_init(size_t initial_size) {
+    if (initial_size == 0) {
+        initial_size = 1;
+    }
+    vec_array_t *array = malloc(sizeof(vec_array_t));
+    assert(array != NULL);
+    array->items = malloc(initial_size * sizeof(vector_t));
+    assert(array->items != NULL);
+    array->length = 0;
+    array->alloc_size = initial_size;
+    return array;
+}
+
+vec_array_t *vec_array_from_list(list_t *list) {
+    size_t size = list_size(list);
+    vec_array_t *array = vec_array_init(size);
+    for (size_t i = 0; i < size; i++) {
+        array->items[i] = *(vector_t *) list_get(list, i);
+    }
+    array->length = size;
+    return array;
+}
+
+vec_array_t *vec_array_copy(const vec_array_t *array) {
+    vec_array_t *copy = vec_array_init(array->length);
+    memcpy(copy->items, array->items, array->length * sizeof(vector_t));
+    copy->length = array->length;
+    return copy;
+}
+
+list_t *vec_array_to_list(const vec_array_t *array) {
+    list_t *list = list_init(array->length, free);
+    for (size_t i = 0; i < array->length; i++) {
+        vector_t *vertex = malloc(sizeof(vector_t));
+        assert(vertex != NULL);
+        *vertex = array->items[i];
+        list_add(list, vertex);
+    }
+    return list;
+}
+
+void vec_array_free(vec_array_t *array) {
+    free(array->items);
+    free(array);
+}
+
+size_t vec_array_size(const vec_array_t *array) {
+    return array->length;
+}
+
+vector_t vec_array_get(const vec_array_t *array, size_t index) {
+    assert(index < array->length);
+    return array->items[index];
+}
+
+void vec_array_set(vec_array_t *array, size_t index, vector_t value) {
+    assert(index < array->length);
+    array->items[index] = value;
+}
+
+void vec_array_add(vec_array_t *array, vector_t value) {
+    if (array->length >= array->alloc_size) {
+        size_t alloc_size = VEC_ARRAY_GROWTH * array->alloc_size;
+        vector_t *items = realloc(array->items, alloc_size * sizeof(vector_t));
+        assert(items != NULL);
+        array->items = items;
+        array->alloc_size = alloc_size;
+    }
+    array->items[array->length++] = value;
+}
+
+const vector_t *vec_array_data(const vec_array_t *array) {
+    return array->items;
+}
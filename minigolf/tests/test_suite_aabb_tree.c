@@ -0,0 +1,235 @@
+#include <assert.h>
+#include <stdlib.h>
+#include "aabb_tree.h"
+#include <math.h>
+#include "test_util.h"
+
+const size_t N_BODIES = 200;
+const double WORLD_SIZE = 100;
+const double MAX_SPEED = 2;
+const int N_STEPS = 20;
+
+list_t *make_square(double size) {
+    list_t *shape = list_init(4, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t) {0, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {size, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {size, size};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {0, size};
+    list_add(shape, v);
+    return shape;
+}
+
+double random_range(double max) {
+    return (double) rand() / RAND_MAX * max;
+}
+
+size_t get_index(body_t *body) {
+    return *(size_t *) body_get_info(body);
+}
+
+// Counts how many times each pair is reported in an N_BODIES x N_BODIES array
+void count_pair(body_t *body1, body_t *body2, void *aux) {
+    size_t *counts = aux;
+    size_t i = get_index(body1);
+    size_t j = get_index(body2);
+    assert(i != j);
+    counts[i * N_BODIES + j]++;
+    counts[j * N_BODIES + i]++;
+}
+
+// Checks that exactly the overlapping pairs of tracked bodies are reported
+void check_pairs(list_t *bodies, bool *tracked, aabb_tree_t *tree) {
+    size_t *counts = calloc(N_BODIES * N_BODIES, sizeof(size_t));
+    aabb_tree_find_pairs(tree, count_pair, counts);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        aabb_t box1 = body_get_bounds(list_get(bodies, i));
+        for (size_t j = 0; j < N_BODIES; j++) {
+            if (i == j) {
+                continue;
+            }
+            aabb_t box2 = body_get_bounds(list_get(bodies, j));
+            bool expected = tracked[i] && tracked[j] && aabb_overlap(box1, box2);
+            assert(counts[i * N_BODIES + j] == (expected ? 1 : 0));
+        }
+    }
+    free(counts);
+}
+
+// Counts how many times each body is reported in an N_BODIES array
+void count_body(body_t *body, void *aux) {
+    size_t *counts = aux;
+    counts[get_index(body)]++;
+}
+
+aabb_t random_box() {
+    vector_t min = {random_range(WORLD_SIZE), random_range(WORLD_SIZE)};
+    double size = random_range(WORLD_SIZE / 4);
+    return (aabb_t) {min, vec_add(min, (vector_t) {size, size})};
+}
+
+// Checks that a query reports exactly the tracked bodies overlapping a box
+void check_query(list_t *bodies, bool *tracked, aabb_tree_t *tree, aabb_t box) {
+    size_t *counts = calloc(N_BODIES, sizeof(size_t));
+    aabb_tree_query(tree, box, count_body, counts);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        bool expected = tracked[i]
+            && aabb_overlap(body_get_bounds(list_get(bodies, i)), box);
+        assert(counts[i] == (expected ? 1 : 0));
+    }
+    free(counts);
+}
+
+list_t *make_random_bodies() {
+    list_t *bodies = list_init(N_BODIES, (free_func_t) body_free);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        size_t *index = malloc(sizeof(*index));
+        *index = i;
+        // every fourth body is static
+        double mass = i % 4 == 0 ? INFINITY : 1;
+        body_t *body = body_init_with_info(make_square(1 + random_range(5)), mass,
+            (rgb_color_t) {0, 0, 0}, index, free);
+        body_set_centroid(body, (vector_t) {random_range(WORLD_SIZE),
+            random_range(WORLD_SIZE)});
+        if (mass != INFINITY) {
+            body_set_velocity(body, (vector_t) {random_range(2 * MAX_SPEED) - MAX_SPEED,
+                random_range(2 * MAX_SPEED) - MAX_SPEED});
+        }
+        list_add(bodies, body);
+    }
+    return bodies;
+}
+
+void test_aabb_tree_moving() {
+    list_t *bodies = make_random_bodies();
+    bool tracked[N_BODIES];
+    aabb_tree_t *tree = aabb_tree_init();
+    for (size_t i = 0; i < N_BODIES; i++) {
+        aabb_tree_add(tree, list_get(bodies, i));
+        tracked[i] = true;
+    }
+    for (int step = 0; step < N_STEPS; step++) {
+        check_pairs(bodies, tracked, tree);
+        for (size_t i = 0; i < N_BODIES; i++) {
+            body_tick(list_get(bodies, i), 1);
+        }
+    }
+    aabb_tree_free(tree);
+    list_free(bodies);
+}
+
+void test_aabb_tree_add_remove() {
+    list_t *bodies = make_random_bodies();
+    bool tracked[N_BODIES];
+    aabb_tree_t *tree = aabb_tree_init();
+    for (size_t i = 0; i < N_BODIES; i++) {
+        tracked[i] = i % 2 == 0;
+        if (tracked[i]) {
+            aabb_tree_add(tree, list_get(bodies, i));
+        }
+    }
+    check_pairs(bodies, tracked, tree);
+
+    // swap which half of the bodies is tracked, a few at a time
+    for (size_t i = 0; i < N_BODIES; i++) {
+        if (tracked[i]) {
+            aabb_tree_remove(tree, list_get(bodies, i));
+        }
+        else {
+            aabb_tree_add(tree, list_get(bodies, i));
+        }
+        tracked[i] = !tracked[i];
+        body_tick(list_get(bodies, i), 1);
+        if (i % 25 == 0) {
+            check_pairs(bodies, tracked, tree);
+        }
+    }
+    check_pairs(bodies, tracked, tree);
+    aabb_tree_free(tree);
+    list_free(bodies);
+}
+
+void test_aabb_tree_static_moved() {
+    list_t *bodies = make_random_bodies();
+    bool tracked[N_BODIES];
+    aabb_tree_t *tree = aabb_tree_init();
+    for (size_t i = 0; i < N_BODIES; i++) {
+        aabb_tree_add(tree, list_get(bodies, i));
+        tracked[i] = true;
+    }
+    // stays balanced
+    assert(aabb_tree_height(tree) <= 2 * log2(N_BODIES) + 2);
+    check_pairs(bodies, tracked, tree);
+
+    // static bodies can still be moved by hand
+    for (size_t i = 0; i < N_BODIES; i += 4) {
+        body_set_centroid(list_get(bodies, i), (vector_t) {random_range(WORLD_SIZE),
+            random_range(WORLD_SIZE)});
+        check_pairs(bodies, tracked, tree);
+    }
+    // and turned, which changes their boxes without moving their centroids
+    for (size_t i = 0; i < N_BODIES; i += 4) {
+        body_set_rotation(list_get(bodies, i), M_PI / 4);
+        check_pairs(bodies, tracked, tree);
+    }
+    assert(aabb_tree_height(tree) <= 2 * log2(N_BODIES) + 2);
+    aabb_tree_free(tree);
+    list_free(bodies);
+}
+
+void test_aabb_tree_query() {
+    list_t *bodies = make_random_bodies();
+    bool tracked[N_BODIES];
+    aabb_tree_t *tree = aabb_tree_init();
+    for (size_t i = 0; i < N_BODIES; i++) {
+        tracked[i] = i % 2 == 0;
+        if (tracked[i]) {
+            aabb_tree_add(tree, list_get(bodies, i));
+        }
+    }
+    check_pairs(bodies, tracked, tree);
+
+    // queries also see the bodies added and removed since the last search
+    for (size_t i = 0; i < N_BODIES; i++) {
+        if (tracked[i]) {
+            aabb_tree_remove(tree, list_get(bodies, i));
+        }
+        else {
+            aabb_tree_add(tree, list_get(bodies, i));
+        }
+        tracked[i] = !tracked[i];
+        if (i % 10 == 0) {
+            check_query(bodies, tracked, tree, random_box());
+        }
+        if (i % 50 == 0) {
+            check_pairs(bodies, tracked, tree);
+        }
+    }
+    check_query(bodies, tracked, tree,
+        (aabb_t) {{0, 0}, {WORLD_SIZE, WORLD_SIZE}});
+    aabb_tree_free(tree);
+    list_free(bodies);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_aabb_tree_moving)
+    DO_TEST(test_aabb_tree_add_remove)
+    DO_TEST(test_aabb_tree_static_moved)
+    DO_TEST(test_aabb_tree_query)
+
+    puts("aabb_tree_test PASS");
+}
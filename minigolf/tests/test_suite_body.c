@@ -241,6 +241,223 @@ void test_body_info_freer() {
     body_free(body);
 }
 
+void test_body_bounds() {
+    list_t *shape = list_init(3, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t) {+1, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {0, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {-1, 0};
+    list_add(shape, v);
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    aabb_t bounds = body_get_bounds(body);
+    assert(vec_isclose(bounds.min, (vector_t) {-1, 0}));
+    assert(vec_isclose(bounds.max, (vector_t) {+1, +1}));
+    body_set_centroid(body, (vector_t) {1, 2});
+    bounds = body_get_bounds(body);
+    assert(vec_isclose(bounds.min, (vector_t) {0, 5.0 / 3.0}));
+    assert(vec_isclose(bounds.max, (vector_t) {2, 8.0 / 3.0}));
+    body_set_rotation(body, M_PI / 2);
+    bounds = body_get_bounds(body);
+    assert(vec_isclose(bounds.min, (vector_t) {1.0 / 3.0, 1}));
+    assert(vec_isclose(bounds.max, (vector_t) {4.0 / 3.0, 3}));
+    body_tick(body, 1);
+    body_set_velocity(body, (vector_t) {+2, -1});
+    body_tick(body, 0.5);
+    bounds = body_get_bounds(body);
+    assert(vec_isclose(bounds.min, (vector_t) {4.0 / 3.0, 0.5}));
+    assert(vec_isclose(bounds.max, (vector_t) {7.0 / 3.0, 2.5}));
+
+    // the cached bounds should always match the bounds of the shape
+    shape = body_get_shape(body);
+    aabb_t expected = aabb_of_polygon(shape);
+    assert(vec_isclose(bounds.min, expected.min));
+    assert(vec_isclose(bounds.max, expected.max));
+    list_free(shape);
+
+    shape = list_init(2, free);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {5, 5};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {7, 4};
+    list_add(shape, v);
+    body_set_shape(body, shape);
+    bounds = body_get_bounds(body);
+    assert(vec_isclose(bounds.min, (vector_t) {5, 4}));
+    assert(vec_isclose(bounds.max, (vector_t) {7, 5}));
+    body_free(body);
+}
+
+void test_body_edge_normals() {
+    list_t *shape = list_init(4, free);
+    vector_t v[] = {{1, 1}, {2, 1}, {2, 2}, {1, 2}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *list_v = malloc(sizeof(*list_v));
+        *list_v = v[i];
+        list_add(shape, list_v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    vector_t *normals = body_get_edge_normals(body);
+    assert(vec_isclose(normals[0], (vector_t) {0, 1}));
+    assert(vec_isclose(normals[1], (vector_t) {-1, 0}));
+    assert(vec_isclose(normals[2], (vector_t) {0, -1}));
+    assert(vec_isclose(normals[3], (vector_t) {1, 0}));
+
+    // moving the body does not change its normals
+    body_set_centroid(body, (vector_t) {10, -10});
+    body_set_velocity(body, (vector_t) {3, 4});
+    body_tick(body, 1);
+    normals = body_get_edge_normals(body);
+    assert(vec_isclose(normals[0], (vector_t) {0, 1}));
+    assert(vec_isclose(normals[3], (vector_t) {1, 0}));
+
+    body_set_rotation(body, M_PI / 2);
+    normals = body_get_edge_normals(body);
+    assert(vec_isclose(normals[0], (vector_t) {-1, 0}));
+    assert(vec_isclose(normals[1], (vector_t) {0, -1}));
+    assert(vec_isclose(normals[2], (vector_t) {1, 0}));
+    assert(vec_isclose(normals[3], (vector_t) {0, 1}));
+    body_free(body);
+}
+
+void test_collision_filter() {
+    list_t *shape = list_init(3, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t) {+1, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {0, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {-1, 0};
+    list_add(shape, v);
+    body_t *body1 = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    body_t *body2 = body_init(body_get_shape(body1), 1, (rgb_color_t) {0, 0, 0});
+    // everything collides by default
+    assert(body_get_collision_category(body1) == 1);
+    assert(body_get_collision_mask(body1) == UINT32_MAX);
+    assert(body_can_collide(body1, body2));
+
+    // both bodies have to accept each other
+    body_set_collision_filter(body1, 1 << 1, 1 << 2);
+    assert(!body_can_collide(body1, body2));
+    body_set_collision_filter(body2, 1 << 2, 1 << 3);
+    assert(!body_can_collide(body1, body2));
+    body_set_collision_filter(body2, 1 << 2, 1 << 1);
+    assert(body_can_collide(body1, body2));
+    assert(body_can_collide(body2, body1));
+    body_set_collision_filter(body2, 0, 0);
+    assert(!body_can_collide(body1, body2));
+    body_free(body1);
+    body_free(body2);
+}
+
+void test_body_peek_shape() {
+    vector_t v[] = {{1, 1}, {2, 1}, {2, 2}, {1, 2}};
+    const size_t VERTICES = sizeof(v) / sizeof(*v);
+    list_t *shape = list_init(0, free);
+    for (size_t i = 0; i < VERTICES; i++) {
+        vector_t *list_v = malloc(sizeof(*list_v));
+        *list_v = v[i];
+        list_add(shape, list_v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    const vec_array_t *view = body_peek_shape(body);
+    assert(vec_array_size(view) == VERTICES);
+    for (size_t i = 0; i < VERTICES; i++) {
+        assert(vec_isclose(vec_array_get(view, i), v[i]));
+    }
+    // the view is the body's own storage, so it sees the body move
+    body_set_centroid(body, (vector_t) {0.5, 0.5});
+    view = body_peek_shape(body);
+    for (size_t i = 0; i < VERTICES; i++) {
+        assert(vec_isclose(vec_array_get(view, i), vec_subtract(v[i], (vector_t) {1, 1})));
+    }
+    assert(vec_array_data(view) == body_get_vertices(body));
+    body_free(body);
+}
+
+void test_body_transform() {
+    vector_t v[] = {{1, 1}, {3, 1}, {3, 2}, {1, 2}};
+    const size_t VERTICES = sizeof(v) / sizeof(*v);
+    list_t *shape = list_init(0, free);
+    for (size_t i = 0; i < VERTICES; i++) {
+        vector_t *list_v = malloc(sizeof(*list_v));
+        *list_v = v[i];
+        list_add(shape, list_v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    vector_t centroid = {2, 1.5};
+    // many small moves do not accumulate error in the vertices
+    for (size_t i = 0; i < 10000; i++) {
+        body_set_rotation(body, i * 0.01);
+        body_set_centroid(body, vec_add(centroid, (vector_t) {i, -(double) i}));
+    }
+    body_set_rotation(body, M_PI / 2);
+    body_set_centroid(body, (vector_t) {10, 10});
+    const vec_array_t *view = body_peek_shape(body);
+    for (size_t i = 0; i < VERTICES; i++) {
+        vector_t expected = vec_add((vector_t) {10, 10},
+            vec_rotate(vec_subtract(v[i], centroid), M_PI / 2));
+        assert(vec_isclose(vec_array_get(view, i), expected));
+    }
+    aabb_t bounds = body_get_bounds(body);
+    assert(vec_isclose(bounds.min, (vector_t) {9.5, 9}));
+    assert(vec_isclose(bounds.max, (vector_t) {10.5, 11}));
+    body_free(body);
+}
+
+void test_body_store() {
+    const size_t BODIES = 5;
+    const double DT = 0.5;
+    body_store_t *store = body_store_init(1);
+    body_t *bodies[BODIES];
+    body_t *loose[BODIES];
+    for (size_t i = 0; i < BODIES; i++) {
+        double mass = i == 0 ? INFINITY : i;
+        for (size_t j = 0; j < 2; j++) {
+            body_t *body = body_init_with_shape(shape_rectangle(1, 1),
+                (vector_t) {i, 0}, mass, (rgb_color_t) {0, 0, 0}, NULL, NULL);
+            body_set_velocity(body, (vector_t) {1, i});
+            body_add_force(body, (vector_t) {i, 1});
+            body_add_impulse(body, (vector_t) {-1, 2});
+            *(j == 0 ? &bodies[i] : &loose[i]) = body;
+        }
+        // moving a body into the store keeps its state
+        body_store_add(store, bodies[i]);
+        assert(vec_equal(body_get_centroid(bodies[i]), (vector_t) {i, 0}));
+    }
+    assert(body_store_size(store) == BODIES);
+    // freeing a body moves another one into its place
+    body_free(bodies[1]);
+    bodies[1] = NULL;
+    assert(body_store_size(store) == BODIES - 1);
+
+    body_add_correction(bodies[2], (vector_t) {0, 3});
+    body_store_apply_corrections(store);
+    body_store_tick(store, DT);
+    body_set_centroid(loose[2], (vector_t) {2, 3});
+    for (size_t i = 0; i < BODIES; i++) {
+        body_tick(loose[i], DT);
+        if (bodies[i] != NULL) {
+            assert(vec_isclose(body_get_centroid(bodies[i]),
+                body_get_centroid(loose[i])));
+            assert(vec_isclose(body_get_velocity(bodies[i]),
+                body_get_velocity(loose[i])));
+            // the shape follows the centroid
+            assert(vec_isclose(polygon_array_centroid(body_peek_shape(bodies[i])),
+                body_get_centroid(bodies[i])));
+            body_free(bodies[i]);
+        }
+        body_free(loose[i]);
+    }
+    body_store_free(store);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -252,12 +469,18 @@ int main(int argc, char *argv[]) {
 
     DO_TEST(test_body_init)
     DO_TEST(test_body_setters)
+    DO_TEST(test_body_bounds)
+    DO_TEST(test_body_edge_normals)
     DO_TEST(test_body_tick)
     DO_TEST(test_infinite_mass)
     DO_TEST(test_forces)
     DO_TEST(test_body_remove)
     DO_TEST(test_body_info)
     DO_TEST(test_body_info_freer)
+    DO_TEST(test_collision_filter)
+    DO_TEST(test_body_peek_shape)
+    DO_TEST(test_body_transform)
+    DO_TEST(test_body_store)
 
     puts("body_test PASS");
 }
@@ -0,0 +1,88 @@
+#include "capsule.h"
+#include "polygon.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+void test_closest_point() {
+    capsule_t capsule = {{0, 0}, {10, 0}, 1};
+    assert(vec_isclose(capsule_closest_point(capsule, (vector_t) {4, 3}),
+        (vector_t) {4, 0}));
+    assert(vec_isclose(capsule_closest_point(capsule, (vector_t) {-5, 3}),
+        (vector_t) {0, 0}));
+    assert(vec_isclose(capsule_closest_point(capsule, (vector_t) {15, -3}),
+        (vector_t) {10, 0}));
+
+    capsule_t point = {{2, 2}, {2, 2}, 1};
+    assert(vec_isclose(capsule_closest_point(point, (vector_t) {7, 7}),
+        (vector_t) {2, 2}));
+}
+
+void test_closest_points() {
+    capsule_t capsule = {{0, 0}, {10, 0}, 1};
+    vector_t point1, point2;
+
+    // parallel, overlapping along their length
+    capsule_closest_points(capsule, (capsule_t) {{5, 3}, {15, 3}, 1},
+        &point1, &point2);
+    assert(isclose(vec_distance(point1, point2), 3));
+
+    // an end of the second segment is closest
+    capsule_closest_points(capsule, (capsule_t) {{4, 2}, {4, 8}, 1},
+        &point1, &point2);
+    assert(vec_isclose(point1, (vector_t) {4, 0}));
+    assert(vec_isclose(point2, (vector_t) {4, 2}));
+
+    // crossing segments meet
+    capsule_closest_points(capsule, (capsule_t) {{4, -2}, {6, 2}, 1},
+        &point1, &point2);
+    assert(vec_isclose(point1, (vector_t) {5, 0}));
+    assert(vec_isclose(point2, (vector_t) {5, 0}));
+}
+
+void test_project_bounds() {
+    capsule_t capsule = {{0, 0}, {10, 10}, 2};
+    vector_t projection = capsule_project(capsule, (vector_t) {1, 0});
+    assert(vec_isclose(projection, (vector_t) {-2, 12}));
+    projection = capsule_project(capsule, (vector_t) {M_SQRT1_2, -M_SQRT1_2});
+    assert(vec_isclose(projection, (vector_t) {-2, 2}));
+
+    aabb_t bounds = capsule_bounds(capsule);
+    assert(vec_isclose(bounds.min, (vector_t) {-2, -2}));
+    assert(vec_isclose(bounds.max, (vector_t) {12, 12}));
+}
+
+void test_capsule_polygon() {
+    const size_t CAP_POINTS = 20;
+    capsule_t capsule = {{0, 0}, {10, 0}, 2};
+    list_t *polygon = capsule_polygon(capsule, CAP_POINTS);
+    assert(list_size(polygon) == 2 * CAP_POINTS);
+    assert(polygon_is_convex(polygon));
+    // a rectangle and two half circles
+    double area = 10 * 4 + M_PI * 2 * 2;
+    assert(fabs(polygon_area(polygon) - area) < 0.01 * area);
+    for (size_t i = 0; i < list_size(polygon); i++) {
+        vector_t vertex = *(vector_t *) list_get(polygon, i);
+        assert(isclose(vec_distance(vertex,
+            capsule_closest_point(capsule, vertex)), 2));
+    }
+    list_free(polygon);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_closest_point)
+    DO_TEST(test_closest_points)
+    DO_TEST(test_project_bounds)
+    DO_TEST(test_capsule_polygon)
+
+    puts("capsule_test PASS");
+}
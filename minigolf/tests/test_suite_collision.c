@@ -73,6 +73,463 @@ void test_non_overlapping_boundaries() {
   list_free(shape2);
 }
 
+void test_body_collision() {
+  rgb_color_t color = {0, 0, 0};
+  body_t *body1 = body_init(init_circle(), 1, color);
+  body_t *body2 = body_init(init_circle(), 1, color);
+  list_t *shape1 = init_circle();
+  list_t *shape2 = init_circle();
+  vector_t offsets[] = {
+    {RADIUS / 4, RADIUS / 4},
+    {2 * RADIUS * cos(M_PI / 4) + 1, 2 * RADIUS * sin(M_PI / 4) + 1},
+    {3 * RADIUS, 0},
+    {-RADIUS, RADIUS / 2}
+  };
+  for (size_t i = 0; i < sizeof(offsets) / sizeof(*offsets); i++) {
+    body_set_centroid(body2, vec_add(body_get_centroid(body2), offsets[i]));
+    polygon_translate(shape2, offsets[i]);
+
+    collision_info_t expected = find_collision(shape1, shape2);
+    collision_info_t actual = find_body_collision(body1, body2);
+    assert(actual.collided == expected.collided);
+    if (expected.collided) {
+      assert(vec_isclose(actual.axis, expected.axis));
+    }
+  }
+  list_free(shape1);
+  list_free(shape2);
+  body_free(body1);
+  body_free(body2);
+}
+
+list_t *init_square(double half_width, vector_t center) {
+  list_t *points = list_init(4, free);
+  vector_t corners[] = {{1, 1}, {-1, 1}, {-1, -1}, {1, -1}};
+  for (size_t i = 0; i < 4; i++) {
+    vector_t *v = malloc(sizeof(vector_t));
+    *v = vec_add(center, vec_multiply(half_width, corners[i]));
+    list_add(points, v);
+  }
+  return points;
+}
+
+void test_circle_circle() {
+  collision_info_t info = find_circle_collision(VEC_ZERO, RADIUS,
+    (vector_t) {RADIUS, 0}, RADIUS);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+  info = find_circle_collision((vector_t) {0, 3}, 1, VEC_ZERO, 2);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {0, -1}));
+  assert(!find_circle_collision(VEC_ZERO, 1, (vector_t) {3, 4}, 3.9).collided);
+  assert(find_circle_collision(VEC_ZERO, 1, VEC_ZERO, 1).collided);
+}
+
+void test_circle_polygon() {
+  // circle to the left of the square, overlapping its left edge
+  list_t *square = init_square(RADIUS, VEC_ZERO);
+  collision_info_t info = find_circle_polygon_collision(
+    (vector_t) {-1.5 * RADIUS, 0}, RADIUS, square);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+
+  // near the corner, the circle misses even though the bounding boxes overlap
+  double offset = RADIUS + RADIUS * 0.8;
+  assert(!find_circle_polygon_collision((vector_t) {offset, offset}, RADIUS,
+    square).collided);
+  assert(find_circle_polygon_collision((vector_t) {offset, offset}, 2 * RADIUS,
+    square).collided);
+
+  // a circle inside the square collides with it
+  assert(find_circle_polygon_collision(VEC_ZERO, 1, square).collided);
+  list_free(square);
+}
+
+void test_circle_polygon_matches_polygon() {
+  list_t *circle = init_circle();
+  list_t *square = init_square(RADIUS / 2, VEC_ZERO);
+  vector_t offsets[] = {
+    {RADIUS, 0}, {0, 1.4 * RADIUS}, {RADIUS, RADIUS},
+    {1.2 * RADIUS, 0.9 * RADIUS}, {-2 * RADIUS, 0}
+  };
+  vector_t position = VEC_ZERO;
+  for (size_t i = 0; i < sizeof(offsets) / sizeof(*offsets); i++) {
+    vector_t move = vec_subtract(offsets[i], position);
+    polygon_translate(square, move);
+    position = offsets[i];
+
+    collision_info_t expected = find_collision(circle, square);
+    collision_info_t actual = find_circle_polygon_collision(VEC_ZERO, RADIUS,
+      square);
+    assert(actual.collided == expected.collided);
+    if (expected.collided) {
+      assert(vec_dot(actual.axis, expected.axis) > 0.99);
+    }
+  }
+  list_free(circle);
+  list_free(square);
+}
+
+void test_circle_bodies() {
+  rgb_color_t color = {0, 0, 0};
+  body_t *circle1 = body_init(init_circle(), 1, color);
+  body_set_circle(circle1, RADIUS);
+  body_t *circle2 = body_init(init_circle(), 1, color);
+  body_set_circle(circle2, RADIUS);
+  body_t *square = body_init(init_square(RADIUS, VEC_ZERO), 1, color);
+
+  body_set_centroid(circle2, (vector_t) {0, 1.5 * RADIUS});
+  collision_info_t info = find_body_collision(circle1, circle2);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {0, 1}));
+
+  body_set_centroid(circle1, (vector_t) {1.9 * RADIUS, 0});
+  info = find_body_collision(circle1, square);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {-1, 0}));
+  info = find_body_collision(square, circle1);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+
+  body_set_centroid(circle1, (vector_t) {2 * RADIUS + 1, 0});
+  assert(!find_body_collision(circle1, square).collided);
+  assert(!find_body_collision(circle1, circle2).collided);
+
+  // reshaping a circle makes it a polygon again
+  body_set_shape(circle1, init_square(RADIUS, (vector_t) {2 * RADIUS + 1, 0}));
+  assert(!body_is_circle(circle1));
+  assert(body_get_radius(circle1) == 0);
+
+  body_free(circle1);
+  body_free(circle2);
+  body_free(square);
+}
+
+void test_cached_axis() {
+  rgb_color_t color = {0, 0, 0};
+  body_t *diamond1 = body_init(init_square(1, VEC_ZERO), 1, color);
+  body_t *diamond2 = body_init(init_square(1, VEC_ZERO), 1, color);
+  body_set_rotation(diamond1, M_PI / 4);
+  body_set_rotation(diamond2, M_PI / 4);
+  // the bounding boxes overlap, but an edge normal separates the diamonds
+  body_set_centroid(diamond2, (vector_t) {1.6, 1.6});
+  collision_reset_stats();
+
+  vector_t axis = VEC_ZERO;
+  assert(!find_body_collision_cached(diamond1, diamond2, &axis).collided);
+  assert(collision_get_stats().axis_cache_tests == 0);
+  assert(isclose(fabs(vec_dot(axis, (vector_t) {1, 1})), sqrt(2)));
+  for (size_t i = 0; i < 10; i++) {
+    body_set_centroid(diamond2, vec_add(body_get_centroid(diamond2),
+      (vector_t) {0.01, 0.01}));
+    assert(!find_body_collision_cached(diamond1, diamond2, &axis).collided);
+  }
+  assert(collision_get_stats().axis_cache_tests == 10);
+  assert(collision_get_stats().axis_cache_hits == 10);
+
+  // once the bodies collide, the cached axis misses and the full test runs
+  body_set_centroid(diamond2, (vector_t) {0.5, 0.5});
+  collision_info_t expected = find_body_collision(diamond1, diamond2);
+  collision_info_t info = find_body_collision_cached(diamond1, diamond2, &axis);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, expected.axis));
+  assert(collision_get_stats().axis_cache_tests == 11);
+  assert(collision_get_stats().axis_cache_hits == 10);
+
+  // a stale axis from before a rotation can't cause a wrong answer
+  body_set_rotation(diamond1, 0);
+  body_set_rotation(diamond2, 0);
+  expected = find_body_collision(diamond1, diamond2);
+  info = find_body_collision_cached(diamond1, diamond2, &axis);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, expected.axis));
+
+  collision_reset_stats();
+  assert(collision_get_stats().axis_cache_tests == 0);
+  body_free(diamond1);
+  body_free(diamond2);
+}
+
+void test_manifold() {
+  // squares overlapping edge to edge touch along a segment
+  list_t *square1 = init_square(1, VEC_ZERO);
+  list_t *square2 = init_square(1, (vector_t) {1.5, 0.5});
+  contact_manifold_t manifold;
+  collision_info_t info = find_collision_manifold(square1, square2, &manifold);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+  assert(isclose(manifold.depth, 0.5));
+  assert(manifold.contact_count == 2);
+  for (size_t i = 0; i < 2; i++) {
+    assert(isclose(manifold.contacts[i].x, 0.75));
+    assert(isclose(fabs(manifold.contacts[i].y - 0.25), 0.75));
+  }
+
+  // a corner poking into an edge touches at one point
+  list_t *diamond = init_square(1, VEC_ZERO);
+  polygon_rotate(diamond, M_PI / 4, VEC_ZERO);
+  polygon_translate(diamond, (vector_t) {sqrt(2) + 0.8, 0});
+  info = find_collision_manifold(square1, diamond, &manifold);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+  assert(isclose(manifold.depth, 0.2));
+  assert(manifold.contact_count == 1);
+  assert(vec_isclose(manifold.contacts[0], (vector_t) {0.9, 0}));
+
+  // a circle touches along the axis
+  rgb_color_t color = {0, 0, 0};
+  body_t *circle = body_init(init_square(1, (vector_t) {-1.5, 0}), 1, color);
+  body_set_circle(circle, 1);
+  body_t *body = body_init(square1, 1, color);
+  info = find_body_collision_manifold(circle, body, NULL, &manifold);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+  assert(isclose(manifold.depth, 0.5));
+  assert(manifold.contact_count == 1);
+  assert(vec_isclose(manifold.contacts[0], (vector_t) {-0.75, 0}));
+  info = find_body_collision_manifold(body, circle, NULL, &manifold);
+  assert(vec_isclose(info.axis, (vector_t) {-1, 0}));
+  assert(isclose(manifold.depth, 0.5));
+  assert(vec_isclose(manifold.contacts[0], (vector_t) {-0.75, 0}));
+
+  body_free(circle);
+  body_free(body);
+  list_free(square2);
+  list_free(diamond);
+}
+
+void test_time_of_impact() {
+  rgb_color_t color = {0, 0, 0};
+  body_t *wall = body_init(init_square(1, VEC_ZERO), INFINITY, color);
+  body_t *square = body_init(init_square(1, (vector_t) {-10, 0}), 1, color);
+  body_t *circle = body_init(init_square(1, (vector_t) {-10, 0}), 1, color);
+  body_set_circle(circle, 1);
+
+  // both bodies pass through the wall in one step, but are stopped on its edge
+  impact_info_t impact = find_time_of_impact(square, (vector_t) {20, 0}, wall);
+  assert(impact.hit);
+  assert(isclose(impact.time, 0.4));
+  assert(vec_isclose(impact.axis, (vector_t) {1, 0}));
+  impact = find_time_of_impact(circle, (vector_t) {20, 0}, wall);
+  assert(impact.hit);
+  assert(isclose(impact.time, 0.4));
+  assert(vec_isclose(impact.axis, (vector_t) {1, 0}));
+
+  // a circle passing over the wall's corner touches the corner
+  body_set_centroid(circle, (vector_t) {-10, 1.5});
+  impact = find_time_of_impact(circle, (vector_t) {20, 0}, wall);
+  assert(impact.hit);
+  assert(isclose(impact.time, (9 - sqrt(0.75)) / 20));
+  assert(vec_isclose(impact.axis, (vector_t) {sqrt(0.75), -0.5}));
+
+  // a polygon moving towards a circle, and a circle towards a circle
+  body_t *fixed_circle = body_init(init_square(1, VEC_ZERO), INFINITY, color);
+  body_set_circle(fixed_circle, 1);
+  body_set_centroid(square, (vector_t) {10, 0});
+  impact = find_time_of_impact(square, (vector_t) {-20, 0}, fixed_circle);
+  assert(impact.hit);
+  assert(isclose(impact.time, 0.4));
+  assert(vec_isclose(impact.axis, (vector_t) {-1, 0}));
+  body_set_centroid(circle, (vector_t) {-10, 0});
+  impact = find_time_of_impact(circle, (vector_t) {20, 0}, fixed_circle);
+  assert(impact.hit);
+  assert(isclose(impact.time, 0.4));
+  assert(vec_isclose(impact.axis, (vector_t) {1, 0}));
+
+  // moving away, stopping short, and already touching are not impacts
+  assert(!find_time_of_impact(circle, (vector_t) {-20, 0}, wall).hit);
+  assert(!find_time_of_impact(circle, (vector_t) {5, 0}, wall).hit);
+  assert(!find_time_of_impact(square, (vector_t) {0, 20}, wall).hit);
+  body_set_centroid(square, (vector_t) {1.5, 0});
+  assert(!find_time_of_impact(square, (vector_t) {-20, 0}, wall).hit);
+
+  body_free(wall);
+  body_free(square);
+  body_free(circle);
+  body_free(fixed_circle);
+}
+
+// Batched queries give the same results as testing each pair
+void test_collisions_batch() {
+  const size_t N_CANDIDATES = 200;
+  rgb_color_t color = {0, 0, 0};
+  body_t *queries[] = {
+    body_init(init_square(1, VEC_ZERO), 1, color),
+    body_init(init_circle(), 1, color)
+  };
+  body_set_circle(queries[1], RADIUS);
+  body_t **candidates = malloc(N_CANDIDATES * sizeof(body_t *));
+  for (size_t i = 0; i < N_CANDIDATES; i++) {
+    vector_t center = {rand() % 200 - 100, rand() % 200 - 100};
+    if (i % 3 == 0) {
+      candidates[i] = body_init(init_circle(), INFINITY, color);
+      body_set_circle(candidates[i], RADIUS);
+      body_set_centroid(candidates[i], center);
+    }
+    else {
+      candidates[i] = body_init(init_square(1 + i % 20, center), INFINITY, color);
+      body_set_rotation(candidates[i], i);
+    }
+  }
+
+  collision_info_t *results = malloc(N_CANDIDATES * sizeof(collision_info_t));
+  size_t collisions = 0;
+  for (size_t q = 0; q < 2; q++) {
+    find_collisions_batch(queries[q], candidates, N_CANDIDATES, results);
+    for (size_t i = 0; i < N_CANDIDATES; i++) {
+      collision_info_t expected = find_body_collision(queries[q], candidates[i]);
+      assert(results[i].collided == expected.collided);
+      if (expected.collided) {
+        assert(vec_isclose(results[i].axis, expected.axis));
+        collisions++;
+      }
+    }
+  }
+  assert(collisions > 0);
+
+  for (size_t i = 0; i < N_CANDIDATES; i++) {
+    body_free(candidates[i]);
+  }
+  body_free(queries[0]);
+  body_free(queries[1]);
+  free(candidates);
+  free(results);
+}
+
+// An L covering [0, 400] x [0, 100] and [0, 100] x [0, 400]
+list_t *init_l() {
+  list_t *points = list_init(6, free);
+  vector_t corners[] = {
+    {0, 0}, {400, 0}, {400, 100}, {100, 100}, {100, 400}, {0, 400}
+  };
+  for (size_t i = 0; i < 6; i++) {
+    vector_t *v = malloc(sizeof(vector_t));
+    *v = corners[i];
+    list_add(points, v);
+  }
+  return points;
+}
+
+void test_compound_body() {
+  rgb_color_t color = {0, 0, 0};
+  body_t *l = body_init(init_l(), INFINITY, color);
+  body_decompose(l);
+  assert(body_get_part_count(l) > 0);
+  body_t *square = body_init(init_square(20, (vector_t) {300, 300}), 1, color);
+  body_t *ball = body_init(init_circle(), 1, color);
+  body_set_circle(ball, RADIUS);
+  body_set_centroid(ball, (vector_t) {300, 100 + RADIUS + 1});
+
+  // in the notch of the L, which the L's convex hull would cover
+  assert(!find_body_collision(square, l).collided);
+  // the ball just above the L's horizontal leg
+  assert(!find_body_collision(ball, l).collided);
+  body_set_centroid(square, (vector_t) {300, 110});
+  assert(find_body_collision(square, l).collided);
+
+  // the ball reports the deepest part it touches, pushed out upwards
+  body_set_centroid(ball, (vector_t) {300, 100 + RADIUS - 5});
+  contact_manifold_t manifold;
+  collision_info_t info = find_body_collision_manifold(l, ball, NULL, &manifold);
+  assert(info.collided);
+  assert(vec_isclose(info.axis, (vector_t) {0, 1}));
+  assert(isclose(manifold.depth, 5));
+
+  // the parts move and rotate with the body
+  vector_t offset = {1000, 1000};
+  body_set_rotation(l, M_PI);
+  body_set_centroid(l, vec_add(body_get_centroid(l), offset));
+  assert(!find_body_collision(ball, l).collided);
+  aabb_t bounds = body_get_bounds(l);
+  assert(isclose(bounds.max.x - bounds.min.x, 400));
+  assert(isclose(bounds.max.y - bounds.min.y, 400));
+  body_set_rotation(l, 0);
+  body_set_centroid(l, vec_subtract(body_get_centroid(l), offset));
+  assert(find_body_collision(ball, l).collided);
+
+  // a ball moving down onto the vertical leg hits its top
+  body_set_centroid(ball, (vector_t) {50, 1000});
+  impact_info_t impact = find_time_of_impact(ball, (vector_t) {0, -1000}, l);
+  assert(impact.hit);
+  assert(isclose(impact.time, (1000 - RADIUS - 400) / 1000.0));
+  assert(vec_isclose(impact.axis, (vector_t) {0, -1}));
+
+  body_free(l);
+  body_free(square);
+  body_free(ball);
+}
+
+void test_capsule_collisions() {
+  capsule_t wall = {{0, 0}, {100, 0}, 5};
+
+  // a circle beside the segment, past its end, and clear of it
+  collision_info_t info = find_circle_capsule_collision((vector_t) {50, 9}, 5, wall);
+  assert(info.collided && vec_isclose(info.axis, (vector_t) {0, -1}));
+  info = find_circle_capsule_collision((vector_t) {108, 0}, 5, wall);
+  assert(info.collided && vec_isclose(info.axis, (vector_t) {-1, 0}));
+  assert(!find_circle_capsule_collision((vector_t) {108, 7}, 5, wall).collided);
+
+  info = find_capsule_collision(wall, (capsule_t) {{50, 8}, {50, 30}, 4});
+  assert(info.collided && vec_isclose(info.axis, (vector_t) {0, 1}));
+  assert(!find_capsule_collision(wall, (capsule_t) {{50, 10}, {50, 30}, 4}).collided);
+
+  // a square resting on the side, and one just clear of the rounded end
+  list_t *square = init_square(10, (vector_t) {50, 14});
+  info = find_polygon_capsule_collision(square, wall);
+  assert(info.collided && vec_isclose(info.axis, (vector_t) {0, -1}));
+  list_free(square);
+  square = init_square(10, (vector_t) {114, 14});
+  assert(!find_polygon_capsule_collision(square, wall).collided);
+  list_free(square);
+  square = init_square(10, (vector_t) {113, 13});
+  assert(find_polygon_capsule_collision(square, wall).collided);
+  list_free(square);
+}
+
+void test_capsule_bodies() {
+  rgb_color_t color = {0, 0, 0};
+  // a U of three walls
+  capsule_t capsules[] = {
+    {{0, 0}, {0, 200}, 5}, {{0, 0}, {200, 0}, 5}, {{200, 0}, {200, 200}, 5}
+  };
+  body_t *walls = body_init(init_square(100, (vector_t) {100, 100}), INFINITY,
+    color);
+  body_set_capsules(walls, capsules, 3);
+  assert(body_is_compound(walls));
+  aabb_t bounds = body_get_bounds(walls);
+  assert(vec_isclose(bounds.min, (vector_t) {-5, -5}));
+  assert(vec_isclose(bounds.max, (vector_t) {205, 205}));
+
+  // the middle of the U is open
+  body_t *ball = body_init(init_circle(), 1, color);
+  body_set_circle(ball, RADIUS);
+  body_set_centroid(ball, (vector_t) {100, 100});
+  assert(!find_body_collision(ball, walls).collided);
+  body_set_centroid(ball, (vector_t) {100, RADIUS + 4});
+  contact_manifold_t manifold;
+  collision_info_t info = find_body_collision_manifold(ball, walls, NULL, &manifold);
+  assert(info.collided && vec_isclose(info.axis, (vector_t) {0, -1}));
+  assert(isclose(manifold.depth, 1));
+
+  // a ball moving right hits the inside of the right wall
+  body_set_centroid(ball, (vector_t) {100, 100});
+  impact_info_t impact = find_time_of_impact(ball, (vector_t) {100, 0}, walls);
+  assert(impact.hit);
+  assert(isclose(impact.time, (100 - RADIUS - 5) / 100.0));
+  assert(vec_isclose(impact.axis, (vector_t) {1, 0}));
+
+  // and a square moving down hits the bottom wall
+  body_t *square = body_init(init_square(10, (vector_t) {100, 100}), 1, color);
+  impact = find_time_of_impact(square, (vector_t) {0, -100}, walls);
+  assert(impact.hit);
+  assert(isclose(impact.time, (100 - 10 - 5) / 100.0));
+  assert(vec_isclose(impact.axis, (vector_t) {0, -1}));
+
+  body_free(walls);
+  body_free(ball);
+  body_free(square);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -87,6 +544,18 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_tangent_shapes)
     DO_TEST(test_overlapping_boundaries)
     DO_TEST(test_non_overlapping_boundaries)
+    DO_TEST(test_body_collision)
+    DO_TEST(test_circle_circle)
+    DO_TEST(test_circle_polygon)
+    DO_TEST(test_circle_polygon_matches_polygon)
+    DO_TEST(test_circle_bodies)
+    DO_TEST(test_cached_axis)
+    DO_TEST(test_time_of_impact)
+    DO_TEST(test_manifold)
+    DO_TEST(test_collisions_batch)
+    DO_TEST(test_compound_body)
+    DO_TEST(test_capsule_collisions)
+    DO_TEST(test_capsule_bodies)
 
     puts("collision_test PASS");
 }
@@ -0,0 +1,119 @@
+#include "decomposition.h"
+#include "polygon.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+list_t *make_polygon(const vector_t *points, size_t count) {
+    list_t *polygon = list_init(count, free);
+    for (size_t i = 0; i < count; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = points[i];
+        list_add(polygon, v);
+    }
+    return polygon;
+}
+
+// An L, with a collinear vertex along its bottom edge
+list_t *make_l() {
+    const vector_t points[] = {
+        {0, 0}, {2, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 3}, {0, 3}
+    };
+    return make_polygon(points, sizeof(points) / sizeof(*points));
+}
+
+// A clockwise comb with three teeth
+list_t *make_comb() {
+    const vector_t points[] = {
+        {0, 0}, {0, 3}, {1, 3}, {1, 1}, {2, 1}, {2, 3}, {3, 3}, {3, 1},
+        {4, 1}, {4, 3}, {5, 3}, {5, 0}
+    };
+    return make_polygon(points, sizeof(points) / sizeof(*points));
+}
+
+// Checks that pieces are counterclockwise, convex,
+// and exactly cover the polygon's area
+void check_pieces(list_t *polygon, list_t *pieces) {
+    double area = 0;
+    for (size_t i = 0; i < list_size(pieces); i++) {
+        list_t *piece = list_get(pieces, i);
+        assert(list_size(piece) >= 3);
+        assert(polygon_is_convex(piece));
+        for (size_t j = 0; j < list_size(piece); j++) {
+            vector_t a = *get_vector_from_polygon(piece, j);
+            vector_t b = *get_vector_from_polygon(piece, (j + 1) % list_size(piece));
+            vector_t c = *get_vector_from_polygon(piece, (j + 2) % list_size(piece));
+            assert(vec_cross(vec_subtract(b, a), vec_subtract(c, b)) >= 0);
+        }
+        area += fabs(polygon_area(piece));
+    }
+    assert(isclose(area, fabs(polygon_area(polygon))));
+}
+
+void test_triangulate() {
+    list_t *polygons[] = {make_l(), make_comb(), star_init(10, 7)};
+    for (size_t i = 0; i < sizeof(polygons) / sizeof(*polygons); i++) {
+        list_t *triangles = polygon_triangulate(polygons[i]);
+        check_pieces(polygons[i], triangles);
+        for (size_t j = 0; j < list_size(triangles); j++) {
+            assert(list_size(list_get(triangles, j)) == 3);
+        }
+        list_free(triangles);
+        list_free(polygons[i]);
+    }
+}
+
+void test_decompose() {
+    // an L needs 2 convex pieces, a comb with 3 teeth needs 4
+    list_t *l = make_l();
+    list_t *pieces = polygon_decompose(l);
+    check_pieces(l, pieces);
+    assert(list_size(pieces) <= 3);
+    list_free(pieces);
+    list_free(l);
+
+    list_t *comb = make_comb();
+    pieces = polygon_decompose(comb);
+    list_t *triangles = polygon_triangulate(comb);
+    check_pieces(comb, pieces);
+    assert(list_size(pieces) >= 4);
+    assert(list_size(pieces) < list_size(triangles));
+    list_free(triangles);
+    list_free(pieces);
+    list_free(comb);
+
+    // Hertel-Mehlhorn leaves at most 2r + 1 pieces for r reflex vertices
+    list_t *star = star_init(10, 7);
+    pieces = polygon_decompose(star);
+    check_pieces(star, pieces);
+    assert(list_size(pieces) <= 2 * 7 + 1);
+    list_free(pieces);
+    list_free(star);
+}
+
+void test_decompose_convex() {
+    const vector_t points[] = {{0, 0}, {0, 2}, {2, 3}, {4, 2}, {4, 0}};
+    list_t *pentagon = make_polygon(points, sizeof(points) / sizeof(*points));
+    list_t *pieces = polygon_decompose(pentagon);
+    assert(list_size(pieces) == 1);
+    check_pieces(pentagon, pieces);
+    list_free(pieces);
+    list_free(pentagon);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_triangulate)
+    DO_TEST(test_decompose)
+    DO_TEST(test_decompose_convex)
+
+    puts("decomposition_test PASS");
+}
@@ -94,14 +94,15 @@ body_t *make_triangle_body() {
     return body_init(shape, 1, (rgb_color_t) {0, 0, 0});
 }
 
-// Tests that destructive collisions remove bodies from the scene
-void test_collisions() {
+// Checks that destructive collisions remove bodies from the scene
+void check_collisions(broad_phase_kind_t kind) {
     const double DT = 0.1;
     const double V = 1.23;
     const double SEPARATION_AT_COLLISION = 1.5;
     const int TICKS_TO_COLLISION = 10;
 
     scene_t *scene = scene_init();
+    scene_set_broad_phase(scene, kind);
     body_t *body1 = make_triangle_body();
     vector_t initial_separation =
         {SEPARATION_AT_COLLISION + V * DT * (TICKS_TO_COLLISION - 0.5), 0};
@@ -133,6 +134,147 @@ void test_collisions() {
     scene_free(scene);
 }
 
+void test_collisions() {
+    check_collisions(BROAD_PHASE_SPATIAL_HASH);
+    check_collisions(BROAD_PHASE_SWEEP_AND_PRUNE);
+    check_collisions(BROAD_PHASE_AABB_TREE);
+}
+
+void count_collision(body_t *body1, body_t *body2, vector_t axis, void *aux) {
+    (*(int *) aux)++;
+}
+
+// Checks that a collision handler runs once per contact,
+// and runs again once the bodies separate and touch again
+void check_collision_handled_once(broad_phase_kind_t kind) {
+    const double DT = 0.1;
+    const double V = 1;
+    const int TICKS = 40;
+
+    scene_t *scene = scene_init();
+    scene_set_broad_phase(scene, kind);
+    body_t *body1 = make_triangle_body();
+    body_set_centroid(body1, (vector_t) {-2, 0});
+    body_set_velocity(body1, (vector_t) {+V, 0});
+    scene_add_body(scene, body1);
+    body_t *body2 = make_triangle_body();
+    scene_add_body(scene, body2);
+
+    int count = 0;
+    create_collision(scene, body1, body2, count_collision, &count, NULL);
+    for (int i = 0; i < TICKS; i++) {
+        scene_tick(scene, DT);
+    }
+    // body1 has passed all the way through body2
+    assert(count == 1);
+
+    body_set_velocity(body1, VEC_ZERO);
+    body_set_centroid(body1, VEC_ZERO);
+    scene_tick(scene, DT);
+    scene_tick(scene, DT);
+    assert(count == 2);
+    scene_free(scene);
+}
+
+void test_collision_handled_once() {
+    check_collision_handled_once(BROAD_PHASE_SPATIAL_HASH);
+    check_collision_handled_once(BROAD_PHASE_SWEEP_AND_PRUNE);
+    check_collision_handled_once(BROAD_PHASE_AABB_TREE);
+}
+
+// Checks whether a fast ball passes through a thin wall in one large tick
+bool passes_through_wall(bool continuous) {
+    const double DT = 1;
+    const double V = 30;
+
+    scene_t *scene = scene_init();
+    scene_set_continuous_collisions(scene, continuous);
+    body_t *ball = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_circle(ball, 1);
+    body_set_centroid(ball, (vector_t) {-10, 0});
+    body_set_velocity(ball, (vector_t) {V, 0});
+    scene_add_body(scene, ball);
+    body_t *wall = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, wall);
+    create_physics_collision(scene, 1, ball, wall);
+
+    scene_tick(scene, DT);
+    bool passed = body_get_centroid(ball).x > 0;
+    if (continuous) {
+        // stopped on the wall and bounced back
+        assert(body_get_centroid(ball).x < -2 + 1e-3);
+        assert(vec_isclose(body_get_velocity(ball), (vector_t) {-V, 0}));
+    }
+    scene_free(scene);
+    return passed;
+}
+
+void test_continuous_collision() {
+    assert(passes_through_wall(false));
+    assert(!passes_through_wall(true));
+}
+
+// A box resting in a floor is pushed out of it in one tick
+void test_positional_correction() {
+    const double DEPTH = 0.5;
+
+    scene_t *scene = scene_init();
+    body_t *box = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(box, (vector_t) {0, 2 - DEPTH});
+    scene_add_body(scene, box);
+    body_t *floor = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, floor);
+    create_physics_collision(scene, 0, box, floor);
+
+    scene_tick(scene, 0.01);
+    // the floor stays put and the box keeps just touching it
+    assert(vec_isclose(body_get_centroid(floor), VEC_ZERO));
+    double overlap = 2 - body_get_centroid(box).y;
+    assert(overlap > 0 && overlap < 0.02);
+    scene_free(scene);
+}
+
+// Pulls a body down with a constant force of its weight
+void apply_weight(void *aux) {
+    const double G = 10;
+    body_t *body = aux;
+    body_add_force(body, (vector_t) {0, -G * body_get_mass(body)});
+}
+
+// A stack of boxes dropped onto a floor settles without sinking or jittering
+void test_stack_settles() {
+    const size_t BOXES = 5;
+    const double DT = 0.01;
+    const double GAP = 0.5;
+
+    scene_t *scene = scene_init();
+    body_t *floor = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, floor);
+    body_t *below = floor;
+    for (size_t i = 1; i <= BOXES; i++) {
+        body_t *box = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(box, (vector_t) {0, i * (2 + GAP)});
+        scene_add_body(scene, box);
+        list_t *bodies = list_init(1, null_free);
+        list_add(bodies, box);
+        scene_add_bodies_force_creator(scene, apply_weight, box, bodies, NULL);
+        create_physics_collision(scene, 0, below, box);
+        below = box;
+    }
+
+    for (size_t tick = 0; tick < 300; tick++) {
+        scene_tick(scene, DT);
+    }
+    // every box rests on the one below, overlapping it by at most the slop
+    for (size_t i = 1; i <= BOXES; i++) {
+        body_t *box = scene_get_body(scene, i);
+        double height = body_get_centroid(box).y;
+        assert(fabs(height - 2.0 * i) < 0.02 * i);
+        assert(fabs(body_get_velocity(box).y) < 1e-6);
+    }
+    scene_free(scene);
+}
+
 // Tests that force creators properly register their list of affected bodies.
 // If they don't, asan will report a heap-use-after-free failure.
 void test_forces_removed() {
@@ -166,6 +308,10 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_spring_sinusoid)
     DO_TEST(test_energy_conservation)
     DO_TEST(test_collisions)
+    DO_TEST(test_collision_handled_once)
+    DO_TEST(test_continuous_collision)
+    DO_TEST(test_positional_correction)
+    DO_TEST(test_stack_settles)
     DO_TEST(test_forces_removed)
 
     puts("forces_test PASS");
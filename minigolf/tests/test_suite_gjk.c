@@ -0,0 +1,157 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include "collision.h"
+#include "gjk.h"
+#include "polygon.h"
+#include "test_util.h"
+
+const size_t N_TRIALS = 2000;
+const double WORLD_SIZE = 10;
+
+// Makes a regular polygon centered at the origin
+list_t *make_regular_polygon(size_t sides, double radius, double angle) {
+    list_t *shape = list_init(sides, free);
+    for (size_t i = 0; i < sides; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = vec_rotate((vector_t) {radius, 0}, angle + 2 * M_PI * i / sides);
+        list_add(shape, v);
+    }
+    return shape;
+}
+
+double random_range(double max) {
+    return (double) rand() / RAND_MAX * max;
+}
+
+list_t *make_random_polygon() {
+    size_t sides = 3 + rand() % 60;
+    list_t *shape = make_regular_polygon(sides, 0.5 + random_range(2),
+        random_range(2 * M_PI));
+    polygon_translate(shape, (vector_t) {random_range(WORLD_SIZE),
+        random_range(WORLD_SIZE)});
+    return shape;
+}
+
+void test_separated() {
+    list_t *square1 = make_regular_polygon(4, 1, M_PI / 4);
+    list_t *square2 = make_regular_polygon(4, 1, M_PI / 4);
+    polygon_translate(square2, (vector_t) {3, 0});
+    vector_t axis;
+    assert(!gjk_intersect(square1, square2, &axis));
+    assert(isclose(vec_dot(axis, axis), 1));
+    // the axis separates the shapes' projections
+    double max1 = -INFINITY;
+    double min2 = INFINITY;
+    for (size_t i = 0; i < 4; i++) {
+        max1 = fmax(max1, vec_dot(axis, *(vector_t *) list_get(square1, i)));
+        min2 = fmin(min2, vec_dot(axis, *(vector_t *) list_get(square2, i)));
+    }
+    assert(max1 < min2);
+    list_free(square1);
+    list_free(square2);
+}
+
+void test_penetration_axis() {
+    list_t *square1 = make_regular_polygon(4, sqrt(2), M_PI / 4);
+    list_t *square2 = make_regular_polygon(4, sqrt(2), M_PI / 4);
+    // overlapping by 0.5 horizontally and 1.5 vertically
+    polygon_translate(square2, (vector_t) {1.5, 0.5});
+    vector_t axis;
+    assert(gjk_intersect(square1, square2, &axis));
+    assert(vec_isclose(axis, (vector_t) {1, 0}));
+    assert(gjk_intersect(square2, square1, &axis));
+    assert(vec_isclose(axis, (vector_t) {-1, 0}));
+    list_free(square1);
+    list_free(square2);
+}
+
+void test_many_vertices() {
+    list_t *circle1 = make_regular_polygon(360, 50, 0);
+    list_t *circle2 = make_regular_polygon(360, 50, 0);
+    polygon_translate(circle2, (vector_t) {54, 72});
+    vector_t axis;
+    assert(gjk_intersect(circle1, circle2, &axis));
+    assert(vec_dot(axis, (vector_t) {0.6, 0.8}) > 0.999);
+    polygon_translate(circle2, (vector_t) {6.6, 8.8});
+    assert(!gjk_intersect(circle1, circle2, &axis));
+    list_free(circle1);
+    list_free(circle2);
+}
+
+// How far the shapes would have to move apart along an axis to separate
+double penetration_depth(list_t *shape1, list_t *shape2, vector_t axis) {
+    double min1 = INFINITY, max1 = -INFINITY;
+    double min2 = INFINITY, max2 = -INFINITY;
+    for (size_t i = 0; i < list_size(shape1); i++) {
+        double projection = vec_dot(axis, *(vector_t *) list_get(shape1, i));
+        min1 = fmin(min1, projection);
+        max1 = fmax(max1, projection);
+    }
+    for (size_t i = 0; i < list_size(shape2); i++) {
+        double projection = vec_dot(axis, *(vector_t *) list_get(shape2, i));
+        min2 = fmin(min2, projection);
+        max2 = fmax(max2, projection);
+    }
+    return fmin(max1 - min2, max2 - min1);
+}
+
+// The smallest penetration depth over every edge normal of both shapes
+double min_penetration_depth(list_t *shape1, list_t *shape2) {
+    double depth = INFINITY;
+    list_t *shapes[] = {shape1, shape2};
+    for (size_t s = 0; s < 2; s++) {
+        size_t size = list_size(shapes[s]);
+        vector_t *normals = malloc(size * sizeof(vector_t));
+        polygon_edge_normals(shapes[s], normals);
+        for (size_t i = 0; i < size; i++) {
+            depth = fmin(depth, penetration_depth(shape1, shape2, normals[i]));
+        }
+        free(normals);
+    }
+    return depth;
+}
+
+// GJK should agree with the separating axis test on random convex polygons,
+// and EPA should find the axis of least penetration
+void test_matches_sat() {
+    for (size_t i = 0; i < N_TRIALS; i++) {
+        list_t *shape1 = make_random_polygon();
+        list_t *shape2 = make_random_polygon();
+
+        collision_set_narrow_phase(NARROW_PHASE_SAT);
+        collision_info_t expected = find_collision(shape1, shape2);
+        collision_set_narrow_phase(NARROW_PHASE_GJK);
+        collision_info_t actual = find_collision(shape1, shape2);
+        assert(actual.collided == expected.collided);
+        if (expected.collided) {
+            assert(isclose(vec_dot(actual.axis, actual.axis), 1));
+            vector_t direction = vec_subtract(polygon_centroid(shape2),
+                polygon_centroid(shape1));
+            assert(vec_dot(actual.axis, direction) > 0);
+            assert(fabs(penetration_depth(shape1, shape2, actual.axis)
+                - min_penetration_depth(shape1, shape2)) < 1e-6);
+        }
+
+        list_free(shape1);
+        list_free(shape2);
+    }
+    collision_set_narrow_phase(NARROW_PHASE_AUTO);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_separated)
+    DO_TEST(test_penetration_axis)
+    DO_TEST(test_many_vertices)
+    DO_TEST(test_matches_sat)
+
+    puts("gjk_test PASS");
+}
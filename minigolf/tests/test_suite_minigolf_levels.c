@@ -1,3 +1,43 @@
-int main() {
-    
+#include "minigolf_levels.h"
+#include "minigolf_utils.h"
+#include "collision.h"
+#include "test_util.h"
+#include <assert.h>
+
+const int N_LEVELS = 5;
+
+// Building a level asserts that the ball and hole lie inside its outline
+void build_all_levels() {
+    for (int i = 1; i <= N_LEVELS; i++) {
+        scene_t *scene = scene_init();
+        minigolf_course_t course = get_level(scene, i);
+        assert(get_golf_ball(course) != NULL);
+        scene_free(scene);
+    }
+}
+
+void test_build_levels() {
+    build_all_levels();
+}
+
+// Most course outlines are concave, so GJK must fall back to SAT for them
+void test_build_levels_gjk() {
+    collision_set_narrow_phase(NARROW_PHASE_GJK);
+    build_all_levels();
+    collision_set_narrow_phase(NARROW_PHASE_AUTO);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_build_levels)
+    DO_TEST(test_build_levels_gjk)
+
+    puts("minigolf_levels_test PASS");
 }
@@ -0,0 +1,81 @@
+#include <assert.h>
+#include <stdlib.h>
+#include "pair_table.h"
+#include "test_util.h"
+
+const size_t N_KEYS = 100;
+
+void test_pair_table_empty() {
+    pair_table_t *table = pair_table_init(0, free);
+    int a, b;
+    assert(pair_table_size(table) == 0);
+    assert(pair_table_get(table, &a, &b) == NULL);
+    assert(pair_table_remove(table, &a, &b) == NULL);
+    pair_table_free(table);
+}
+
+void test_pair_table_unordered() {
+    pair_table_t *table = pair_table_init(1, null_free);
+    int a, b, c;
+    pair_table_put(table, &a, &b, &c);
+    assert(pair_table_size(table) == 1);
+    assert(pair_table_get(table, &a, &b) == &c);
+    assert(pair_table_get(table, &b, &a) == &c);
+    assert(pair_table_get(table, &a, &c) == NULL);
+    assert(pair_table_remove(table, &b, &a) == &c);
+    assert(pair_table_size(table) == 0);
+    assert(pair_table_get(table, &a, &b) == NULL);
+    pair_table_free(table);
+}
+
+void test_pair_table_many() {
+    // every pair of keys maps to a distinct value
+    pair_table_t *table = pair_table_init(1, free);
+    char *keys = malloc(N_KEYS);
+    for (size_t i = 0; i < N_KEYS; i++) {
+        for (size_t j = i + 1; j < N_KEYS; j++) {
+            size_t *value = malloc(sizeof(*value));
+            *value = i * N_KEYS + j;
+            pair_table_put(table, keys + j, keys + i, value);
+        }
+    }
+    assert(pair_table_size(table) == N_KEYS * (N_KEYS - 1) / 2);
+
+    // remove every other pair, then check the rest are still reachable
+    for (size_t i = 0; i < N_KEYS; i++) {
+        for (size_t j = i + 1; j < N_KEYS; j += 2) {
+            size_t *value = pair_table_remove(table, keys + i, keys + j);
+            assert(*value == i * N_KEYS + j);
+            free(value);
+        }
+    }
+    for (size_t i = 0; i < N_KEYS; i++) {
+        for (size_t j = i + 1; j < N_KEYS; j++) {
+            size_t *value = pair_table_get(table, keys + i, keys + j);
+            if ((j - i) % 2 == 1) {
+                assert(value == NULL);
+            }
+            else {
+                assert(*value == i * N_KEYS + j);
+            }
+        }
+    }
+    pair_table_free(table);
+    free(keys);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_pair_table_empty)
+    DO_TEST(test_pair_table_unordered)
+    DO_TEST(test_pair_table_many)
+
+    puts("pair_table_test PASS");
+}
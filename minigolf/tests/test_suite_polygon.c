@@ -29,6 +29,22 @@ void test_square_area_centroid() {
     list_free(sq);
 }
 
+// Clockwise polygons have the same centroid as counterclockwise ones
+void test_clockwise_centroid() {
+    list_t *sq = make_square();
+    polygon_translate(sq, (vector_t){2, 3});
+    list_t *reversed = list_init(4, free);
+    for (size_t i = 4; i > 0; i--) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = *get_vector_from_polygon(sq, i - 1);
+        list_add(reversed, v);
+    }
+    assert(isclose(polygon_area(reversed), 4));
+    assert(vec_isclose(polygon_centroid(reversed), (vector_t){2, 3}));
+    list_free(reversed);
+    list_free(sq);
+}
+
 void test_square_translate() {
     list_t *sq = make_square();
     polygon_translate(sq, (vector_t){2, 3});
@@ -53,6 +69,21 @@ void test_square_rotate() {
     list_free(sq);
 }
 
+void test_square_edge_normals() {
+    list_t *sq = make_square();
+    vector_t normals[4];
+    polygon_edge_normals(sq, normals);
+    assert(vec_isclose(normals[0], (vector_t){0, -1}));
+    assert(vec_isclose(normals[1], (vector_t){+1, 0}));
+    assert(vec_isclose(normals[2], (vector_t){0, +1}));
+    assert(vec_isclose(normals[3], (vector_t){-1, 0}));
+    polygon_rotate(sq, 0.25 * M_PI, VEC_ZERO);
+    polygon_edge_normals(sq, normals);
+    assert(vec_isclose(normals[0], (vector_t){sqrt(0.5), -sqrt(0.5)}));
+    assert(vec_isclose(normals[2], (vector_t){-sqrt(0.5), sqrt(0.5)}));
+    list_free(sq);
+}
+
 // Make 3-4-5 triangle
 list_t *make_triangle() {
     list_t *tri = list_init(3, free);
@@ -214,6 +245,124 @@ void test_weird_rotate() {
     list_free(w);
 }
 
+void test_is_convex() {
+    list_t *sq = make_square();
+    assert(polygon_is_convex(sq));
+    // reversing the vertices makes the square clockwise but still convex
+    list_t *reversed = list_init(4, free);
+    for (size_t i = 4; i > 0; i--) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = *get_vector_from_polygon(sq, i - 1);
+        list_add(reversed, v);
+    }
+    assert(polygon_is_convex(reversed));
+    list_free(sq);
+    list_free(reversed);
+
+    list_t *w = make_weird();
+    assert(!polygon_is_convex(w));
+    list_free(w);
+}
+
+// Random convex polygon with vertices on an ellipse, in either orientation
+list_t *make_random_convex(size_t n, bool clockwise) {
+    double *angles = malloc(n * sizeof(double));
+    angles[0] = 0;
+    for (size_t i = 1; i < n; i++) {
+        // strictly increasing angles below 2 pi
+        angles[i] = angles[i - 1] + (1.0 + rand() % 100) / 100 * 2 * M_PI / n;
+    }
+    double a = 1 + rand() % 10, b = 1 + rand() % 10;
+    list_t *c = list_init(n, free);
+    for (size_t i = 0; i < n; i++) {
+        double angle = clockwise ? -angles[i] : angles[i];
+        vector_t *v = malloc(sizeof(*v));
+        *v = (vector_t){a * cos(angle) + 3, b * sin(angle) - 2};
+        list_add(c, v);
+    }
+    free(angles);
+    return c;
+}
+
+void test_convex_projection() {
+    for (size_t trial = 0; trial < 500; trial++) {
+        size_t n = 3 + rand() % 200;
+        list_t *c = make_random_convex(n, trial % 2 == 1);
+        assert(polygon_is_convex(c));
+        for (size_t i = 0; i < 20; i++) {
+            double angle = (double) rand() / RAND_MAX * 2 * M_PI;
+            vector_t axis = {cos(angle), sin(angle)};
+            vector_t expected = polygon_project(c, axis);
+            vector_t actual = polygon_project_convex(c, axis);
+            assert(vec_isclose(actual, expected));
+        }
+        list_free(c);
+    }
+
+    list_t *c = make_big_circ();
+    vector_t projection = polygon_project_convex(c, (vector_t){0.6, 0.8});
+    assert(vec_isclose(projection, polygon_project(c, (vector_t){0.6, 0.8})));
+    assert(vec_isclose(projection, (vector_t){-1, 1}));
+    list_free(c);
+}
+
+// Repeated vertices give zero-length edges, which have no direction to search by
+void test_convex_projection_repeated_vertices() {
+    for (size_t trial = 0; trial < 200; trial++) {
+        size_t n = BINARY_PROJECTION_MIN_VERTICES + rand() % 100;
+        list_t *c = make_random_convex(n, trial % 2 == 1);
+        vec_array_t *repeated = vec_array_init(2 * n);
+        for (size_t i = 0; i < n; i++) {
+            vector_t vertex = *(vector_t *) list_get(c, i);
+            vec_array_add(repeated, vertex);
+            // repeat the first vertex and runs of others
+            size_t copies = i == 0 || rand() % 4 == 0 ? 1 + rand() % 3 : 0;
+            for (size_t j = 0; j < copies; j++) {
+                vec_array_add(repeated, vertex);
+            }
+        }
+        for (size_t i = 0; i < 20; i++) {
+            double angle = (double) rand() / RAND_MAX * 2 * M_PI;
+            vector_t axis = {cos(angle), sin(angle)};
+            assert(vec_isclose(polygon_array_project_convex(repeated, axis),
+                polygon_project(c, axis)));
+        }
+        vec_array_free(repeated);
+        list_free(c);
+    }
+}
+
+// The contiguous versions agree with the list versions
+void test_array_matches_list() {
+    for (size_t trial = 0; trial < 100; trial++) {
+        size_t n = 3 + rand() % 200;
+        list_t *c = make_random_convex(n, trial % 2 == 1);
+        vec_array_t *array = vec_array_from_list(c);
+        assert(isclose(polygon_array_area(array), polygon_area(c)));
+        assert(vec_isclose(polygon_array_centroid(array), polygon_centroid(c)));
+        assert(polygon_array_is_convex(array));
+        for (size_t i = 0; i < 20; i++) {
+            double angle = (double) rand() / RAND_MAX * 2 * M_PI;
+            vector_t axis = {cos(angle), sin(angle)};
+            vector_t expected = polygon_project(c, axis);
+            assert(vec_isclose(polygon_array_project(array, axis), expected));
+            assert(vec_isclose(polygon_array_project_convex(array, axis),
+                               expected));
+        }
+
+        polygon_translate(c, (vector_t){4, -7});
+        polygon_rotate(c, 0.3, (vector_t){1, 2});
+        polygon_array_translate(array, (vector_t){4, -7});
+        polygon_array_rotate(array, 0.3, (vector_t){1, 2});
+        for (size_t i = 0; i < n; i++) {
+            assert(vec_isclose(vec_array_get(array, i),
+                               *get_vector_from_polygon(c, i)));
+        }
+        vec_array_free(array);
+        list_free(c);
+    }
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests? True if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -224,8 +373,10 @@ int main(int argc, char *argv[]) {
     }
 
     DO_TEST(test_square_area_centroid)
+    DO_TEST(test_clockwise_centroid)
     DO_TEST(test_square_translate)
     DO_TEST(test_square_rotate)
+    DO_TEST(test_square_edge_normals)
     DO_TEST(test_triangle_area_centroid)
     DO_TEST(test_triangle_translate)
     DO_TEST(test_triangle_rotate)
@@ -235,6 +386,10 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_weird_area_centroid)
     DO_TEST(test_weird_translate)
     DO_TEST(test_weird_rotate)
+    DO_TEST(test_is_convex)
+    DO_TEST(test_convex_projection)
+    DO_TEST(test_convex_projection_repeated_vertices)
+    DO_TEST(test_array_matches_list)
 
     puts("polygon_test PASS");
 }
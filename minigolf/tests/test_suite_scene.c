@@ -1,3 +1,4 @@
+#include "forces.h"
 #include "scene.h"
 #include "test_util.h"
 #include <assert.h>
@@ -232,6 +233,255 @@ void test_reaping() {
     scene_free(scene);
 }
 
+void test_sensor() {
+    scene_t *scene = scene_init();
+    body_t *sensor = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_set_sensor(sensor, true);
+    scene_add_body(scene, sensor);
+    body_t *ball = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_circle(ball, 1);
+    body_set_centroid(ball, (vector_t) {-4, 0});
+    body_set_velocity(ball, (vector_t) {1, 0});
+    scene_add_body(scene, ball);
+    // sensors never collide, even with a collision registered
+    create_physics_collision(scene, 1, ball, sensor);
+
+    sensor_event_t event;
+    for (int i = 1; i <= 7; i++) {
+        scene_tick(scene, 1);
+        // the ball's circle overlaps the square from x = -1 to x = 1
+        if (i == 3 || i == 6) {
+            assert(scene_poll_sensor_event(scene, &event));
+            assert(event.kind == (i == 3 ? SENSOR_ENTER : SENSOR_EXIT));
+            assert(event.sensor == sensor && event.body == ball);
+        }
+        assert(!scene_poll_sensor_event(scene, &event));
+        assert(vec_isclose(body_get_velocity(ball), (vector_t) {1, 0}));
+    }
+
+    // events about a removed body are dropped
+    body_set_centroid(ball, VEC_ZERO);
+    scene_tick(scene, 0);
+    body_remove(ball);
+    scene_tick(scene, 0);
+    assert(!scene_poll_sensor_event(scene, &event));
+    scene_free(scene);
+}
+
+// Checks the sensor events of moving squares against their bounding boxes
+void test_sensor_broad_phases() {
+    const size_t SENSORS = 3;
+    const size_t BODIES = 40;
+    broad_phase_kind_t kinds[] = {BROAD_PHASE_SPATIAL_HASH,
+        BROAD_PHASE_SWEEP_AND_PRUNE, BROAD_PHASE_AABB_TREE};
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        scene_t *scene = scene_init();
+        scene_set_broad_phase(scene, kinds[k]);
+        body_t *bodies[SENSORS + BODIES];
+        for (size_t i = 0; i < SENSORS + BODIES; i++) {
+            bool sensor = i < SENSORS;
+            bodies[i] = body_init(make_shape(), sensor ? INFINITY : 1,
+                (rgb_color_t) {0, 0, 0});
+            body_set_sensor(bodies[i], sensor);
+            body_set_centroid(bodies[i], (vector_t) {rand() % 20, rand() % 20});
+            if (!sensor) {
+                body_set_velocity(bodies[i],
+                    (vector_t) {rand() % 9 - 4.1, rand() % 9 - 4.1});
+            }
+            scene_add_body(scene, bodies[i]);
+        }
+
+        // whether each body overlaps each sensor, according to the events
+        bool overlapping[SENSORS][SENSORS + BODIES];
+        for (size_t s = 0; s < SENSORS; s++) {
+            for (size_t i = 0; i < SENSORS + BODIES; i++) {
+                overlapping[s][i] = false;
+            }
+        }
+        for (int tick = 0; tick < 50; tick++) {
+            scene_tick(scene, 0.1);
+            sensor_event_t event;
+            while (scene_poll_sensor_event(scene, &event)) {
+                for (size_t s = 0; s < SENSORS; s++) {
+                    for (size_t i = SENSORS; i < SENSORS + BODIES; i++) {
+                        if (bodies[s] == event.sensor && bodies[i] == event.body) {
+                            bool entered = event.kind == SENSOR_ENTER;
+                            assert(overlapping[s][i] != entered);
+                            overlapping[s][i] = entered;
+                        }
+                    }
+                }
+            }
+            for (size_t s = 0; s < SENSORS; s++) {
+                aabb_t sensor_bounds = body_get_bounds(bodies[s]);
+                for (size_t i = SENSORS; i < SENSORS + BODIES; i++) {
+                    assert(overlapping[s][i] == aabb_overlap(sensor_bounds,
+                        body_get_bounds(bodies[i])));
+                }
+            }
+        }
+        scene_free(scene);
+    }
+}
+
+void count_contact(body_t *body1, body_t *body2, vector_t axis,
+    const contact_manifold_t *manifold, void *aux) {
+    (*(int *) aux)++;
+}
+
+void check_axis_from_body1(body_t *body1, body_t *body2, vector_t axis,
+    const contact_manifold_t *manifold, void *aux) {
+    vector_t offset = vec_subtract(body_get_centroid(body2),
+        body_get_centroid(body1));
+    assert(vec_dot(offset, axis) > 0);
+    (*(int *) aux)++;
+}
+
+void test_contact_events() {
+    scene_t *scene = scene_init();
+    body_t *body1 = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(body1, (vector_t) {-3.5, 0});
+    body_set_velocity(body1, (vector_t) {1, 0});
+    scene_add_body(scene, body1);
+    body_t *body2 = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, body2);
+
+    int counts[3] = {0, 0, 0};
+    int flipped = 0;
+    scene_add_contact_handler(scene, body1, body2, CONTACT_BEGIN,
+        count_contact, &counts[CONTACT_BEGIN], NULL);
+    scene_add_contact_handler(scene, body1, body2, CONTACT_PERSIST,
+        count_contact, &counts[CONTACT_PERSIST], NULL);
+    scene_add_contact_handler(scene, body1, body2, CONTACT_END,
+        count_contact, &counts[CONTACT_END], NULL);
+    // handlers see the bodies in the order they were registered with
+    scene_add_contact_handler(scene, body2, body1, CONTACT_BEGIN,
+        check_axis_from_body1, &flipped, NULL);
+
+    // the squares overlap while body1 is between x = -2 and x = 2
+    for (int i = 1; i <= 7; i++) {
+        scene_tick(scene, 1);
+        assert(scene_bodies_touching(scene, body2, body1) == (i >= 3 && i <= 6));
+    }
+    assert(counts[CONTACT_BEGIN] == 1);
+    assert(counts[CONTACT_PERSIST] == 3);
+    assert(counts[CONTACT_END] == 1);
+    assert(flipped == 1);
+    scene_free(scene);
+}
+
+void count_typed_contact(body_t *body1, body_t *body2, vector_t axis,
+    const contact_manifold_t *manifold, void *aux) {
+    assert(body_get_collision_type(body1) == 1);
+    assert(body_get_collision_type(body2) == 2);
+    (*(int *) aux)++;
+}
+
+void test_collision_types() {
+    scene_t *scene = scene_init();
+    body_t *target = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_collision_type(target, 2);
+    scene_add_body(scene, target);
+    body_t *mover = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_collision_type(mover, 1);
+    body_set_centroid(mover, (vector_t) {-3.5, 0});
+    body_set_velocity(mover, (vector_t) {1, 0});
+    scene_add_body(scene, mover);
+
+    int count = 0;
+    scene_register_collision_handler(scene, 1, 2, CONTACT_BEGIN,
+        count_typed_contact, &count, NULL);
+    for (int i = 1; i <= 7; i++) {
+        scene_tick(scene, 1);
+        assert(scene_bodies_touching(scene, mover, target) == (i >= 3 && i <= 6));
+    }
+    assert(count == 1);
+
+    // bodies added later are handled too, in either order of types
+    body_t *added = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_collision_type(added, 1);
+    scene_add_body(scene, added);
+    scene_tick(scene, 1);
+    assert(count == 2);
+    // and bodies of other types are not
+    body_set_collision_type(added, 3);
+    body_set_centroid(added, (vector_t) {0, 10});
+    scene_tick(scene, 1);
+    body_set_centroid(added, VEC_ZERO);
+    scene_tick(scene, 1);
+    assert(count == 2);
+    scene_free(scene);
+}
+
+void test_collision_filter() {
+    scene_t *scene = scene_init();
+    body_t *body1 = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_collision_filter(body1, 1 << 1, 1 << 1);
+    scene_add_body(scene, body1);
+    body_t *body2 = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, body2);
+
+    int count = 0;
+    scene_add_contact_handler(scene, body1, body2, CONTACT_BEGIN,
+        count_contact, &count, NULL);
+    scene_tick(scene, 1);
+    assert(count == 0 && !scene_bodies_touching(scene, body1, body2));
+
+    body_set_collision_filter(body2, 1 << 1, UINT32_MAX);
+    scene_tick(scene, 1);
+    assert(count == 1 && scene_bodies_touching(scene, body1, body2));
+    scene_free(scene);
+}
+
+void add_body_on_contact(body_t *body1, body_t *body2, vector_t axis,
+    const contact_manifold_t *manifold, void *aux) {
+    body_t *added = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(added, (vector_t) {0, 100});
+    scene_add_body(aux, added);
+}
+
+void test_continuous_adds_body() {
+    scene_t *scene = scene_init();
+    scene_set_continuous_collisions(scene, true);
+    body_t *wall = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, wall);
+    body_t *bullet = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(bullet, (vector_t) {-20, 0});
+    body_set_velocity(bullet, (vector_t) {40, 0});
+    scene_add_body(scene, bullet);
+    scene_add_contact_handler(scene, bullet, wall, CONTACT_BEGIN,
+        add_body_on_contact, scene, NULL);
+
+    // the handler adds a body while the bullet is being swept;
+    // it did not exist at the start of the tick, so it is not swept itself
+    scene_tick(scene, 1);
+    assert(scene_bodies(scene) == 3);
+    assert(vec_equal(body_get_centroid(scene_get_body(scene, 2)), (vector_t) {0, 100}));
+    scene_free(scene);
+}
+
+void test_continuous_moving_wall() {
+    scene_t *scene = scene_init();
+    scene_set_continuous_collisions(scene, true);
+    // the wall only moves into the bullet's path during the tick
+    body_t *wall = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(wall, (vector_t) {0, 50});
+    body_set_velocity(wall, (vector_t) {0, -50});
+    scene_add_body(scene, wall);
+    body_t *bullet = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(bullet, (vector_t) {-20, 0});
+    body_set_velocity(bullet, (vector_t) {40, 0});
+    scene_add_body(scene, bullet);
+    int begins = 0;
+    scene_add_contact_handler(scene, bullet, wall, CONTACT_BEGIN,
+        count_contact, &begins, NULL);
+
+    // the bullet is swept against where the wall ended the tick
+    scene_tick(scene, 1);
+    assert(begins == 1);
+    scene_free(scene);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -246,6 +496,13 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_force_creator)
     DO_TEST(test_force_creator_aux)
     DO_TEST(test_reaping)
+    DO_TEST(test_sensor)
+    DO_TEST(test_sensor_broad_phases)
+    DO_TEST(test_contact_events)
+    DO_TEST(test_collision_types)
+    DO_TEST(test_collision_filter)
+    DO_TEST(test_continuous_adds_body)
+    DO_TEST(test_continuous_moving_wall)
 
     puts("scene_test PASS");
 }
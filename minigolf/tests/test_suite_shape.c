@@ -0,0 +1,92 @@
+#include "body.h"
+#include "polygon.h"
+#include "shape.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+void test_shape_memoized() {
+    shape_t *circle1 = shape_circle(2, 40);
+    shape_t *circle2 = shape_circle(2, 40);
+    shape_t *other = shape_circle(3, 40);
+    assert(circle1 == circle2);
+    assert(circle1 != other);
+    assert(shape_get_ref_count(circle1) == 2);
+    assert(shape_rectangle(2, 1) != shape_rectangle(1, 2));
+
+    const vec_array_t *points = shape_get_points(circle1);
+    assert(vec_array_size(points) == 40);
+    assert(vec_isclose(vec_array_get(points, 0), (vector_t) {2, 0}));
+    assert(vec_isclose(polygon_array_centroid(points), VEC_ZERO));
+    assert(shape_is_convex(circle1));
+    shape_release(circle1);
+    shape_release(circle2);
+    shape_release(other);
+
+    shape_t *star = shape_star(5, 6);
+    assert(vec_array_size(shape_get_points(star)) == 12);
+    assert(!shape_is_convex(star));
+    shape_release(star);
+}
+
+void test_shape_release() {
+    shape_t *rectangle = shape_rectangle(4, 2);
+    aabb_t bounds = shape_get_bounds(rectangle);
+    assert(vec_isclose(bounds.min, (vector_t) {-2, -1}));
+    assert(vec_isclose(bounds.max, (vector_t) {2, 1}));
+    shape_retain(rectangle);
+    shape_release(rectangle);
+    assert(shape_get_ref_count(rectangle) == 1);
+    shape_release(rectangle);
+
+    // once every reference is gone, a new rectangle is made
+    rectangle = shape_rectangle(4, 2);
+    assert(shape_get_ref_count(rectangle) == 1);
+    shape_release(rectangle);
+}
+
+void test_shared_bodies() {
+    const size_t BODIES = 100;
+    shape_t *square = shape_rectangle(2, 2);
+    body_t *bodies[BODIES];
+    for (size_t i = 0; i < BODIES; i++) {
+        vector_t centroid = {3.0 * i, 0};
+        bodies[i] = body_init_with_shape(shape_retain(square), centroid, 1,
+            (rgb_color_t) {0, 0, 0}, NULL, NULL);
+        aabb_t bounds = body_get_bounds(bodies[i]);
+        assert(vec_isclose(bounds.min, vec_add(centroid, (vector_t) {-1, -1})));
+        assert(vec_isclose(bounds.max, vec_add(centroid, (vector_t) {1, 1})));
+        assert(body_peek_local_shape(bodies[i]) == shape_get_points(square));
+    }
+    assert(shape_get_ref_count(square) == BODIES + 1);
+
+    // bodies differ only by their transforms
+    body_set_rotation(bodies[1], M_PI / 4);
+    const vec_array_t *shape = body_peek_shape(bodies[1]);
+    assert(vec_isclose(vec_array_get(shape, 0), (vector_t) {3, M_SQRT2}));
+    shape = body_peek_shape(bodies[2]);
+    assert(vec_isclose(vec_array_get(shape, 0), (vector_t) {7, 1}));
+
+    for (size_t i = 0; i < BODIES; i++) {
+        body_free(bodies[i]);
+    }
+    assert(shape_get_ref_count(square) == 1);
+    shape_release(square);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_shape_memoized)
+    DO_TEST(test_shape_release)
+    DO_TEST(test_shared_bodies)
+
+    puts("shape_test PASS");
+}
@@ -0,0 +1,87 @@
+#include "simd.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+const size_t MAX_POINTS = 40;
+const size_t N_AXES = 50;
+
+double random_coordinate() {
+    return (double) rand() / RAND_MAX * 2000 - 1000;
+}
+
+vector_t *make_random_points(size_t count) {
+    vector_t *points = malloc(count * sizeof(vector_t));
+    for (size_t i = 0; i < count; i++) {
+        points[i] = (vector_t) {random_coordinate(), random_coordinate()};
+    }
+    return points;
+}
+
+// Every instruction set gives exactly the scalar results,
+// including for counts that leave a remainder after the vector loop
+void test_project_matches_scalar() {
+    simd_level_t best = simd_get_level();
+    for (size_t count = 1; count <= MAX_POINTS; count++) {
+        vector_t *points = make_random_points(count);
+        for (size_t i = 0; i < N_AXES; i++) {
+            double angle = (double) rand() / RAND_MAX * 2 * M_PI;
+            vector_t axis = {cos(angle), sin(angle)};
+
+            simd_set_level(SIMD_SCALAR);
+            vector_t expected = simd_project(points, count, axis);
+            assert(expected.x <= expected.y);
+            for (simd_level_t level = SIMD_SSE2; level <= SIMD_AVX2; level++) {
+                if (!simd_supported(level)) {
+                    continue;
+                }
+                simd_set_level(level);
+                vector_t actual = simd_project(points, count, axis);
+                assert(actual.x == expected.x && actual.y == expected.y);
+            }
+        }
+        free(points);
+    }
+    simd_set_level(best);
+}
+
+void test_bounds_matches_scalar() {
+    simd_level_t best = simd_get_level();
+    for (size_t count = 1; count <= MAX_POINTS; count++) {
+        vector_t *points = make_random_points(count);
+        vector_t expected_min, expected_max;
+        simd_set_level(SIMD_SCALAR);
+        simd_bounds(points, count, &expected_min, &expected_max);
+        for (size_t i = 0; i < count; i++) {
+            assert(expected_min.x <= points[i].x && points[i].x <= expected_max.x);
+            assert(expected_min.y <= points[i].y && points[i].y <= expected_max.y);
+        }
+        for (simd_level_t level = SIMD_SSE2; level <= SIMD_AVX2; level++) {
+            if (!simd_supported(level)) {
+                continue;
+            }
+            simd_set_level(level);
+            vector_t min, max;
+            simd_bounds(points, count, &min, &max);
+            assert(vec_equal(min, expected_min) && vec_equal(max, expected_max));
+        }
+        free(points);
+    }
+    simd_set_level(best);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_project_matches_scalar)
+    DO_TEST(test_bounds_matches_scalar)
+
+    puts("simd_test PASS");
+}
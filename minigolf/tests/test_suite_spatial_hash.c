@@ -0,0 +1,188 @@
+#include <assert.h>
+#include <stdlib.h>
+#include "spatial_hash.h"
+#include "test_util.h"
+
+const size_t N_BODIES = 200;
+const double WORLD_SIZE = 100;
+
+list_t *make_square(double size) {
+    list_t *shape = list_init(4, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t) {0, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {size, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {size, size};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {0, size};
+    list_add(shape, v);
+    return shape;
+}
+
+double random_coordinate() {
+    return (double) rand() / RAND_MAX * WORLD_SIZE;
+}
+
+size_t get_index(body_t *body) {
+    return *(size_t *) body_get_info(body);
+}
+
+// Counts how many times each pair is reported in an N_BODIES x N_BODIES array
+void count_pair(body_t *body1, body_t *body2, void *aux) {
+    size_t *counts = aux;
+    size_t i = get_index(body1);
+    size_t j = get_index(body2);
+    assert(i != j);
+    counts[i * N_BODIES + j]++;
+    counts[j * N_BODIES + i]++;
+}
+
+// Checks the grid reports exactly the pairs a brute-force search finds
+void check_pairs(list_t *bodies, spatial_hash_t *hash) {
+    size_t *counts = calloc(N_BODIES * N_BODIES, sizeof(size_t));
+    spatial_hash_find_pairs(hash, bodies, count_pair, counts);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        aabb_t box1 = body_get_bounds(list_get(bodies, i));
+        for (size_t j = 0; j < N_BODIES; j++) {
+            if (i == j) {
+                continue;
+            }
+            aabb_t box2 = body_get_bounds(list_get(bodies, j));
+            assert(counts[i * N_BODIES + j] == (aabb_overlap(box1, box2) ? 1 : 0));
+        }
+    }
+    free(counts);
+}
+
+// Counts how many times each body is reported in an N_BODIES array
+void count_body(body_t *body, void *aux) {
+    size_t *counts = aux;
+    counts[get_index(body)]++;
+}
+
+// Checks that a query reports exactly the tracked bodies overlapping a box
+void check_query(list_t *bodies, bool *tracked, spatial_hash_t *hash, aabb_t box) {
+    size_t *counts = calloc(N_BODIES, sizeof(size_t));
+    spatial_hash_query(hash, box, count_body, counts);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        bool expected = tracked[i]
+            && aabb_overlap(body_get_bounds(list_get(bodies, i)), box);
+        assert(counts[i] == (expected ? 1 : 0));
+    }
+    free(counts);
+}
+
+list_t *make_random_bodies() {
+    list_t *bodies = list_init(N_BODIES, (free_func_t) body_free);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        size_t *index = malloc(sizeof(*index));
+        *index = i;
+        // mostly small bodies, with the occasional one spanning the world
+        double size = i % 50 == 0 ? WORLD_SIZE : 1 + random_coordinate() / 20;
+        body_t *body = body_init_with_info(make_square(size), 1,
+            (rgb_color_t) {0, 0, 0}, index, free);
+        body_set_centroid(body, (vector_t) {random_coordinate(), random_coordinate()});
+        list_add(bodies, body);
+    }
+    return bodies;
+}
+
+void test_spatial_hash_automatic() {
+    list_t *bodies = make_random_bodies();
+    spatial_hash_t *hash = spatial_hash_init(0);
+    check_pairs(bodies, hash);
+    spatial_hash_free(hash);
+    list_free(bodies);
+}
+
+void test_spatial_hash_cell_sizes() {
+    list_t *bodies = make_random_bodies();
+    spatial_hash_t *hash = spatial_hash_init(1);
+    check_pairs(bodies, hash);
+    spatial_hash_set_cell_size(hash, 7.5);
+    check_pairs(bodies, hash);
+    spatial_hash_set_cell_size(hash, 2 * WORLD_SIZE);
+    check_pairs(bodies, hash);
+    spatial_hash_free(hash);
+    list_free(bodies);
+}
+
+void test_spatial_hash_touching() {
+    // boxes sharing only an edge count as overlapping
+    list_t *bodies = list_init(N_BODIES, (free_func_t) body_free);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        size_t *index = malloc(sizeof(*index));
+        *index = i;
+        body_t *body = body_init_with_info(make_square(1), 1,
+            (rgb_color_t) {0, 0, 0}, index, free);
+        body_set_centroid(body, (vector_t) {i % 20, i / 20});
+        list_add(bodies, body);
+    }
+    spatial_hash_t *hash = spatial_hash_init(0);
+    check_pairs(bodies, hash);
+    spatial_hash_free(hash);
+    list_free(bodies);
+}
+
+void test_spatial_hash_query() {
+    list_t *bodies = make_random_bodies();
+    double cell_sizes[] = {0, 1, 7.5, 2 * WORLD_SIZE};
+    for (size_t c = 0; c < sizeof(cell_sizes) / sizeof(cell_sizes[0]); c++) {
+        spatial_hash_t *hash = spatial_hash_init(cell_sizes[c]);
+        // search the first half of the bodies
+        list_t *searched = list_init(N_BODIES, null_free);
+        bool tracked[N_BODIES];
+        for (size_t i = 0; i < N_BODIES; i++) {
+            tracked[i] = i < N_BODIES / 2;
+            if (tracked[i]) {
+                list_add(searched, list_get(bodies, i));
+            }
+        }
+        size_t *pair_counts = calloc(N_BODIES * N_BODIES, sizeof(size_t));
+        spatial_hash_find_pairs(hash, searched, count_pair, pair_counts);
+        free(pair_counts);
+
+        // then remove every third searched body and add the rest
+        for (size_t i = 0; i < N_BODIES; i++) {
+            if (tracked[i] && i % 3 == 0) {
+                spatial_hash_remove(hash, list_get(bodies, i));
+                tracked[i] = false;
+            }
+            else if (!tracked[i]) {
+                spatial_hash_add(hash, list_get(bodies, i));
+                tracked[i] = true;
+            }
+        }
+        for (size_t q = 0; q < 20; q++) {
+            vector_t min = {random_coordinate(), random_coordinate()};
+            double size = random_coordinate() / 4;
+            check_query(bodies, tracked, hash,
+                (aabb_t) {min, vec_add(min, (vector_t) {size, size})});
+        }
+        check_query(bodies, tracked, hash, (aabb_t) {{0, 0}, {WORLD_SIZE, WORLD_SIZE}});
+        list_free(searched);
+        spatial_hash_free(hash);
+    }
+    list_free(bodies);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_spatial_hash_automatic)
+    DO_TEST(test_spatial_hash_cell_sizes)
+    DO_TEST(test_spatial_hash_touching)
+    DO_TEST(test_spatial_hash_query)
+
+    puts("spatial_hash_test PASS");
+}
@@ -0,0 +1,63 @@
+#include "vec_array.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdlib.h>
+
+void test_vec_array_add_get() {
+    vec_array_t *array = vec_array_init(1);
+    assert(vec_array_size(array) == 0);
+    // grows past its initial size
+    for (size_t i = 0; i < 100; i++) {
+        vec_array_add(array, (vector_t) {i, -(double) i});
+        assert(vec_array_size(array) == i + 1);
+    }
+    const vector_t *data = vec_array_data(array);
+    for (size_t i = 0; i < 100; i++) {
+        assert(vec_equal(vec_array_get(array, i), (vector_t) {i, -(double) i}));
+        assert(vec_equal(data[i], vec_array_get(array, i)));
+    }
+    vec_array_set(array, 50, VEC_ZERO);
+    assert(vec_equal(vec_array_get(array, 50), VEC_ZERO));
+    vec_array_free(array);
+}
+
+void test_vec_array_list_round_trip() {
+    list_t *list = list_init(3, free);
+    for (size_t i = 0; i < 3; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = (vector_t) {i, 2 * i};
+        list_add(list, v);
+    }
+    vec_array_t *array = vec_array_from_list(list);
+    list_free(list);
+    assert(vec_array_size(array) == 3);
+
+    vec_array_t *copy = vec_array_copy(array);
+    vec_array_set(copy, 0, (vector_t) {5, 5});
+    // the copy does not share storage
+    assert(vec_equal(vec_array_get(array, 0), VEC_ZERO));
+
+    list = vec_array_to_list(array);
+    assert(list_size(list) == 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert(vec_equal(*(vector_t *) list_get(list, i), (vector_t) {i, 2 * i}));
+    }
+    list_free(list);
+    vec_array_free(copy);
+    vec_array_free(array);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_vec_array_add_get)
+    DO_TEST(test_vec_array_list_round_trip)
+
+    puts("vec_array_test PASS");
+}